@@ -0,0 +1,317 @@
+// ============================================================================
+// Internal ADC — analogRead() loop vs continuous DMA
+// ============================================================================
+// Runs the oversampling estimator on codes from a mock of the ESP32
+// continuous ADC driver on a simulated clock, and compares one analogRead()
+// per sample with two ways of using the driver:
+//   - window: hal::acquireDmaWindow(), start and stop around every point,
+//     64-sample frames (InternalADC outside a curve)
+//   - stream: hal::acquireDmaStream(), the driver running for the whole
+//     curve with frames of N + 2 samples (InternalADC between beginCurve()
+//     and endCurve()); the frame in flight is kept when the settling time
+//     covers it (5 ms) and dropped when it does not (0 ms)
+// The last column is what InternalADC does for such a curve: it streams
+// only when the settling covers a frame and the window fits in one, and
+// uses the analogRead() loop otherwise.
+// The mock reproduces:
+//   - fixed-rate conversion into frames, one interrupt per frame, also
+//     while a point settles
+//   - a ring buffer of 8 frames that drops new frames when full
+//   - a frame finished after stop() that stays queued for the next window
+//   - a first frame after start() holding codes of the previous run
+//   - occasional words tagged with another channel
+// and checks that every window holds consecutive codes of the current run,
+// none converted before the DAC step that starts the point.
+//
+// CPU costs are assumptions, not measurements: 10 µs per analogRead(),
+// 8 µs per frame for the ISR and ring-buffer hand-over, 4 µs per frame read.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/adc_dma_bench.cpp -o adc_dma_bench
+// ============================================================================
+
+#include "dma_frame_source.h"
+#include "oversampling.h"
+
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+using namespace hal;
+
+namespace {
+
+const double   ANALOG_READ_US = 10.0;
+const double   FRAME_ISR_US   = 8.0;
+const double   FRAME_READ_US  = 4.0;
+const double   START_US       = 20.0;
+const uint8_t  CHANNEL        = 6;    // GPIO34 = ADC1_CH6
+const uint32_t FOREIGN_EVERY  = 97;   // One word in 97 carries another channel
+const uint16_t STALE_CODE     = 4095;
+const uint16_t ADC_FRAME_SAMPLES = 64;  // ADC_DMA_FRAME_SAMPLES
+
+class MockAdcDma : public IDmaFrameSource {
+public:
+    MockAdcDma(uint32_t rateHz, uint16_t frameSamples, size_t ringFrames)
+        : rateHz_(rateHz), frameSamples_(frameSamples), ringFrames_(ringFrames),
+          periodUs_(frameSamples * 1e6 / rateHz) {}
+
+    bool start() override {
+        now_ += START_US;
+        busy_ += START_US;
+        run_++;
+        t0_       = now_;
+        produced_ = 0;
+        running_  = !stalled_;
+        return true;
+    }
+
+    void stop() override {
+        materialize();
+        if (running_) produce();  // The frame in flight still lands in the ring
+        running_ = false;
+    }
+
+    size_t readFrame(uint8_t* buf, size_t maxBytes, uint32_t timeoutMs, bool& overrun) override {
+        materialize();
+        if (ring_.empty()) {
+            const double next = t0_ + (produced_ + 1) * periodUs_;
+            if (timeoutMs == 0) return 0;
+            if (!running_ || next - now_ > timeoutMs * 1000.0) {
+                now_ += timeoutMs * 1000.0;
+                return 0;
+            }
+            now_ = next;
+            materialize();
+        }
+        reads_.push_back({ firsts_.front(), timeoutMs == 0 });
+        firsts_.pop_front();
+        const std::vector<uint16_t>& frame = ring_.front();
+        size_t len = 0;
+        for (size_t i = 0; i < frame.size() && len + 1 < maxBytes; i++) {
+            buf[len++] = static_cast<uint8_t>(frame[i] & 0xFF);
+            buf[len++] = static_cast<uint8_t>(frame[i] >> 8);
+        }
+        ring_.pop_front();
+        busy_ += FRAME_READ_US;
+        overrun = overflowed_;
+        return len;
+    }
+
+    size_t   frameBytes() const override   { return frameSamples_ * DMA_WORD_BYTES; }
+    uint32_t sampleRateHz() const override { return rateHz_; }
+
+    /** Code of sample j (from start()) in run r; sample 0 is the first of frame 1. */
+    static uint16_t code(uint32_t run, uint32_t j) { return static_cast<uint16_t>(1000 + (j * 37 + run * 11) % 2000); }
+    static bool     foreign(uint32_t j)            { return j % FOREIGN_EVERY == 13; }
+
+    /** A frame handed out by readFrame(): its first sample (-1: warm-up frame) and whether it was a drain read. */
+    struct Read {
+        int64_t first;
+        bool    drain;
+    };
+    std::vector<Read>& reads() { return reads_; }
+
+    /** When the conversion of sample j began. */
+    double sampleStart(int64_t j) const { return t0_ + periodUs_ + j * 1e6 / rateHz_; }
+
+    void   idle(double us)  { now_ += us; materialize(); }
+    void   stall()          { stalled_ = true; }
+    double now() const      { return now_; }
+    double busy() const     { return busy_; }
+    uint32_t run() const    { return run_; }
+
+private:
+    void materialize() {
+        while (running_ && t0_ + (produced_ + 1) * periodUs_ <= now_) produce();
+    }
+
+    void produce() {
+        std::vector<uint16_t> frame(frameSamples_);
+        for (uint16_t i = 0; i < frameSamples_; i++) {
+            if (produced_ == 0) {
+                frame[i] = static_cast<uint16_t>((CHANNEL << 12) | STALE_CODE);  // Previous run
+                continue;
+            }
+            const uint32_t j = (produced_ - 1) * frameSamples_ + i;
+            const uint8_t  ch = foreign(j) ? 3 : CHANNEL;
+            frame[i] = static_cast<uint16_t>((ch << 12) | code(run_, j));
+        }
+        const int64_t first = produced_ == 0 ? -1 : static_cast<int64_t>(produced_ - 1) * frameSamples_;
+        produced_++;
+        busy_ += FRAME_ISR_US;
+        if (ring_.size() >= ringFrames_) {
+            overflowed_ = true;  // Sticky, as in the ESP-IDF 4.4 driver
+            return;
+        }
+        ring_.push_back(frame);
+        firsts_.push_back(first);
+    }
+
+    uint32_t rateHz_;
+    uint16_t frameSamples_;
+    size_t   ringFrames_;
+    double   periodUs_;
+    double   now_        = 0.0;
+    double   busy_       = 0.0;
+    double   t0_         = 0.0;
+    uint32_t produced_   = 0;
+    uint32_t run_        = 0;
+    bool     running_    = false;
+    bool     stalled_    = false;
+    bool     overflowed_ = false;
+    std::deque<std::vector<uint16_t>> ring_;
+    std::deque<int64_t>               firsts_;
+    std::vector<Read>                 reads_;
+};
+
+/** Fresh codes a window of n must hold: frame 1 onwards, foreign words skipped. */
+bool windowMatches(const uint16_t* window, uint16_t n, uint32_t run) {
+    uint16_t k = 0;
+    for (uint32_t j = 0; k < n; j++) {
+        if (MockAdcDma::foreign(j)) continue;
+        if (window[k++] != MockAdcDma::code(run, j)) return false;
+    }
+    return true;
+}
+
+/**
+ * A stream window must hold the codes of the frames read after the drain
+ * (less the one in flight, when dropped), consecutive from the first.
+ * `preStep` counts its samples converted before `stepUs`.
+ */
+bool streamMatches(MockAdcDma& dma, const uint16_t* window, uint16_t n, bool keepInFlight,
+                   double stepUs, uint32_t& preStep) {
+    int64_t first = -2;
+    bool    skip  = !keepInFlight;
+    for (const MockAdcDma::Read& r : dma.reads()) {
+        if (r.drain) continue;
+        if (skip) { skip = false; continue; }
+        first = r.first;
+        break;
+    }
+    if (first < 0) return false;  // Nothing read, or the warm-up frame used
+
+    uint16_t k = 0;
+    for (int64_t j = first; k < n; j++) {
+        if (MockAdcDma::foreign(static_cast<uint32_t>(j))) continue;
+        if (window[k++] != MockAdcDma::code(dma.run(), static_cast<uint32_t>(j))) return false;
+        if (dma.sampleStart(j) < stepUs) preStep++;
+    }
+    return true;
+}
+
+/** vTaskDelay(settling) ends anywhere in the last 1 ms tick. */
+double settle(double settlingUs, uint32_t& lcg) {
+    if (settlingUs <= 0.0) return 0.0;
+    lcg = lcg * 1664525u + 1013904223u;
+    return settlingUs - 1000.0 * (lcg >> 8) / 16777216.0;
+}
+
+/** InternalADC::beginCurve()'s rule: the shortest settling covers a frame and the window fits in one. */
+bool streams(uint16_t n, double settlingUs) {
+    const double frameUs = (n + 2) * 1e6 / 100000;
+    return settlingUs > 0.0 && settlingUs - 1000.0 >= frameUs && (n + 2) * DMA_WORD_BYTES <= DMA_FRAME_MAX_BYTES;
+}
+
+struct Row {
+    double   pointUs = 0.0;  // Wall time of the reads
+    double   cpuUs   = 0.0;  // Busy time, ISR included
+    double   stale   = 0.0;  // Frames discarded per point
+    uint32_t preStep = 0;    // Samples converted before the DAC step
+    int      ok      = 0;    // Windows with the expected codes
+};
+
+Row runWindows(uint16_t n, int points, double settlingUs) {
+    MockAdcDma dma(100000, ADC_FRAME_SAMPLES, 8);
+    DmaStats stats;
+    uint16_t window[OVERSAMPLING_MAX_SAMPLES];
+    uint32_t lcg = 1;
+    Row r;
+    for (int p = 0; p < points; p++) {
+        dma.idle(settle(settlingUs, lcg));
+        const double t = dma.now();
+        const uint16_t got = acquireDmaWindow(dma, CHANNEL, window, n, &stats);
+        r.pointUs += dma.now() - t;
+        if (got == n && windowMatches(window, n, dma.run())) r.ok++;
+        reduceSamples(OversamplingMethod::TrimmedMean, window, got);
+    }
+    r.pointUs /= points;
+    r.cpuUs    = dma.busy() / points;
+    r.stale    = static_cast<double>(stats.stale) / points;
+    return r;
+}
+
+Row runStream(uint16_t n, int points, double settlingUs) {
+    // AdcDmaSource::begin(n + 2) from InternalADC::beginCurve()
+    const uint16_t maxFrame = DMA_FRAME_MAX_BYTES / DMA_WORD_BYTES;
+    const uint16_t frame    = n + 2 > maxFrame ? maxFrame : n + 2;
+    MockAdcDma dma(100000, frame, 8);
+    const bool keepInFlight = streams(n, settlingUs);
+    DmaStats stats;
+    uint16_t window[OVERSAMPLING_MAX_SAMPLES];
+    uint32_t lcg = 1;
+    Row r;
+    dma.start();
+    for (int p = 0; p < points; p++) {
+        const double step = dma.now();  // DAC written, then the point settles
+        dma.idle(settle(settlingUs, lcg));
+        const double t = dma.now();
+        dma.reads().clear();
+        const uint16_t got = acquireDmaStream(dma, CHANNEL, window, n, keepInFlight, &stats);
+        r.pointUs += dma.now() - t;
+        if (got == n && streamMatches(dma, window, n, keepInFlight, step, r.preStep)) r.ok++;
+        reduceSamples(OversamplingMethod::TrimmedMean, window, got);
+    }
+    dma.stop();
+    r.pointUs /= points;
+    r.cpuUs    = dma.busy() / points;
+    r.stale    = static_cast<double>(stats.stale) / points;
+    return r;
+}
+
+} // namespace
+
+int main() {
+    const uint16_t counts[]   = { 16, 64, 256 };
+    const double   settlings[] = { 5000.0, 0.0 };
+    const int      POINTS     = 200;
+
+    printf("Internal ADC at 100 kHz, %d points per curve; ms per point for the read alone\n\n", POINTS);
+    printf("%5s %6s | %-19s | %-30s | %-41s | %s\n", "", "", "analogRead() loop", "DMA window (start/stop)",
+           "DMA stream (whole curve)", "InternalADC");
+    printf("%5s %6s | %8s | %8s | %8s | %8s | %8s | %8s | %8s | %8s | %8s | %s\n",
+           "N", "settle", "ms/point", "CPU ms", "ms/point", "CPU ms", "windows", "ms/point", "CPU ms", "pre-step",
+           "windows", "uses");
+    printf("-------------+----------+----------+----------+----------+----------+----------+----------+----------+"
+           "----------+-----------\n");
+
+    int bad = 0;
+    for (double settling : settlings) {
+        for (uint16_t n : counts) {
+            const Row w = runWindows(n, POINTS, settling);
+            const Row s = runStream(n, POINTS, settling);
+            printf("%5u %4.0fms | %8.2f | %8.2f | %8.2f | %8.3f | %4d/%-3d | %8.2f | %8.3f | %8u | %4d/%-3d | %s\n",
+                   n, settling / 1000.0, n * ANALOG_READ_US / 1000.0, n * ANALOG_READ_US / 1000.0,
+                   w.pointUs / 1000.0, w.cpuUs / 1000.0, w.ok, POINTS,
+                   s.pointUs / 1000.0, s.cpuUs / 1000.0, (unsigned)s.preStep, s.ok, POINTS,
+                   streams(n, settling) ? "stream" : "analogRead");
+            bad += (w.ok != POINTS) + (s.ok != POINTS) + (s.preStep != 0);
+        }
+    }
+    printf("\nSettling ends anywhere in its last 1 ms tick, as vTaskDelay() does. CPU ms\n"
+           "includes the frame interrupts while a point settles (stream only).\n");
+
+    // A driver that never delivers: the window gives up after 4 frame periods
+    printf("\nDriver stalled, N=64:\n");
+    {
+        MockAdcDma dma(100000, 64, 8);
+        dma.stall();
+        DmaStats stats;
+        uint16_t window[64];
+        const uint16_t got = acquireDmaWindow(dma, CHANNEL, window, 64, &stats);
+        printf("  %u codes, %u timeouts after %.2f ms (InternalADC then falls back to analogRead)\n",
+               got, (unsigned)stats.timeouts, dma.now() / 1000.0);
+    }
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,204 @@
+// ============================================================================
+// ADS1115 acquisition — single-shot polling vs continuous with ALERT/RDY
+// ============================================================================
+// Runs hal::acquireContinuous() against a mock ADS1115 on a simulated clock
+// and compares it with the single-shot path readADC_SingleEnded() takes.
+// The mock reproduces what decides the cost of a point:
+//   - 860 SPS conversions (1163 µs), ±10% internal oscillator tolerance
+//   - 400 kHz I2C: a register write or a register read is a bus transaction
+//   - single-shot: three register writes (config + RDY thresholds), then
+//     config-register polls until the conversion ends, then a result read
+//   - continuous: the same three writes once per point, then one result read
+//     per ready pulse; results not read before the next conversion are lost
+//
+// Reported per oversampling count: time per point, time the CPU is busy on
+// the bus (the rest it can sleep), and conversions missed. Two failure cases
+// follow: a reader slower than the data rate, and ALERT/RDY not wired.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/ads_continuous_bench.cpp -o ads_continuous_bench
+// ============================================================================
+
+#include "conversion_source.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace hal;
+
+namespace {
+
+const double WRITE_US   = 110.0;  // Pointer + 2 data bytes at 400 kHz, with driver overhead
+const double READ_US    = 160.0;  // Pointer write, restart, 2 data bytes
+const double WAKEUP_US  = 25.0;   // Power-down to first conversion
+
+class MockAds1115 : public IConversionSource {
+public:
+    explicit MockAds1115(double clockError = 0.0)
+        : periodUs_(1e6 / 860.0 * (1.0 + clockError)) {}
+
+    // ── Continuous mode (IConversionSource) ───────────────────────────────
+    bool start() override {
+        bus(3 * WRITE_US);
+        t0_   = now_ + WAKEUP_US;
+        seen_ = 0;
+        return true;
+    }
+
+    void stop() override { bus(WRITE_US); }
+
+    uint32_t waitReady(uint32_t timeoutUs) override {
+        if (!wired_) {
+            idle(timeoutUs);
+            return 0;
+        }
+        uint64_t done = completed();
+        if (done == seen_) {
+            const double next = t0_ + (seen_ + 1) * periodUs_;
+            if (next - now_ > timeoutUs) {
+                idle(timeoutUs);
+                return 0;
+            }
+            idle(next - now_);
+            done = seen_ + 1;  // Woken by this edge; immune to rounding in completed()
+        }
+        const uint32_t pulses = static_cast<uint32_t>(done - seen_);
+        seen_ = done;
+        return pulses;
+    }
+
+    int16_t readConversion() override {
+        bus(READ_US);
+        return signal(seen_);
+    }
+
+    uint32_t conversionUs() const override { return static_cast<uint32_t>(1e6 / 860.0); }
+
+    // ── Single-shot, as Adafruit_ADS1X15::readADC_SingleEnded() ───────────
+    int16_t readSingleShot() {
+        bus(3 * WRITE_US);
+        const double ready = now_ + WAKEUP_US + periodUs_;
+        while (now_ < ready) bus(READ_US);  // conversionComplete() polls
+        bus(READ_US);
+        return signal(++singles_);
+    }
+
+    /** Work the reader does between samples (e.g. logging), busy. */
+    void work(double us) { bus(us); }
+
+    void unplugAlert() { wired_ = false; }
+
+    double now() const  { return now_; }
+    double busy() const { return busy_; }
+
+    /** Result of conversion k: a mid-scale level with a deterministic ripple. */
+    static int16_t signal(uint64_t k) {
+        return static_cast<int16_t>(16000 + 40.0 * sin(0.37 * static_cast<double>(k)));
+    }
+
+private:
+    uint64_t completed() const {
+        return now_ < t0_ ? 0 : static_cast<uint64_t>((now_ - t0_) / periodUs_);
+    }
+    void bus(double us)  { now_ += us; busy_ += us; }
+    void idle(double us) { now_ += us; }
+
+    double   periodUs_;
+    double   now_     = 0.0;
+    double   busy_    = 0.0;
+    double   t0_      = 0.0;
+    uint64_t seen_    = 0;
+    uint64_t singles_ = 0;
+    bool     wired_   = true;
+};
+
+/** Reader that does `workUs` of other work after every sample. */
+class SlowReader : public IConversionSource {
+public:
+    SlowReader(MockAds1115& ads, double workUs) : ads_(ads), workUs_(workUs) {}
+    bool     start() override                      { return ads_.start(); }
+    void     stop() override                       { ads_.stop(); }
+    uint32_t waitReady(uint32_t timeoutUs) override { return ads_.waitReady(timeoutUs); }
+    int16_t  readConversion() override {
+        const int16_t v = ads_.readConversion();
+        ads_.work(workUs_);
+        return v;
+    }
+    uint32_t conversionUs() const override         { return ads_.conversionUs(); }
+
+private:
+    MockAds1115& ads_;
+    double       workUs_;
+};
+
+} // namespace
+
+int main() {
+    const uint16_t counts[] = { 1, 4, 16, 64, 256 };
+    const int POINTS = 100;
+    uint16_t ring[256];
+
+    printf("ADS1115 at 860 SPS, %.0f us/write, %.0f us/read on I2C — %d points each\n\n",
+           WRITE_US, READ_US, POINTS);
+    printf("%5s | %-21s | %-30s | %7s\n", "", "single-shot, polled", "continuous, ALERT/RDY", "");
+    printf("%5s | %10s | %8s | %10s | %8s | %6s | %7s\n",
+           "N", "ms/point", "busy %", "ms/point", "busy %", "missed", "speedup");
+    printf("------+------------+----------+------------+----------+--------+--------\n");
+
+    for (uint16_t n : counts) {
+        MockAds1115 single;
+        for (int p = 0; p < POINTS; p++) {
+            for (uint16_t i = 0; i < n; i++) single.readSingleShot();
+        }
+
+        MockAds1115 cont;
+        ContinuousStats stats;
+        bool consecutive = true;
+        for (int p = 0; p < POINTS; p++) {
+            const uint16_t got = acquireContinuous(cont, ring, n, &stats);
+            for (uint16_t i = 1; i < got; i++) {
+                // Each point restarts the converter, so sample i is conversion i+1
+                if (ring[i] != static_cast<uint16_t>(MockAds1115::signal(i + 1))) consecutive = false;
+            }
+        }
+
+        const double sMs = single.now() / POINTS / 1000.0;
+        const double cMs = cont.now() / POINTS / 1000.0;
+        printf("%5u | %10.2f | %7.1f%% | %10.2f | %7.1f%% | %6u | %6.2fx%s\n",
+               n, sMs, 100.0 * single.busy() / single.now(),
+               cMs, 100.0 * cont.busy() / cont.now(), (unsigned)stats.missed,
+               sMs / cMs, consecutive ? "" : "  (samples out of order!)");
+    }
+
+    // Oscillator at the edges of its tolerance
+    printf("\nClock tolerance, N=16:\n");
+    const double errors[] = { -0.10, 0.10 };
+    for (double err : errors) {
+        MockAds1115 cont(err);
+        ContinuousStats stats;
+        for (int p = 0; p < POINTS; p++) acquireContinuous(cont, ring, 16, &stats);
+        printf("  %+4.0f%%: %.2f ms/point, %u missed, %u timeouts\n",
+               100 * err, cont.now() / POINTS / 1000.0, (unsigned)stats.missed, (unsigned)stats.timeouts);
+    }
+
+    // A reader slower than the data rate loses conversions; they are counted
+    printf("\nReader with 1.5 ms of work per sample, N=16:\n");
+    {
+        MockAds1115 ads;
+        SlowReader slow(ads, 1500.0);
+        ContinuousStats stats;
+        for (int p = 0; p < POINTS; p++) acquireContinuous(slow, ring, 16, &stats);
+        printf("  %u samples, %u conversions missed\n", (unsigned)stats.samples, (unsigned)stats.missed);
+    }
+
+    // No ready pulses: the capture gives up after 4 periods
+    printf("\nALERT/RDY not wired, N=16:\n");
+    {
+        MockAds1115 ads;
+        ads.unplugAlert();
+        ContinuousStats stats;
+        const uint16_t got = acquireContinuous(ads, ring, 16, &stats);
+        printf("  %u samples, %u timeouts after %.2f ms\n", got, (unsigned)stats.timeouts, ads.now() / 1000.0);
+    }
+    return 0;
+}
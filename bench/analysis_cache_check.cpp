@@ -0,0 +1,195 @@
+// ============================================================================
+// AnalysisCache — request() / worker / forget() check on a host FFat
+// ============================================================================
+// Runs src/analysis_cache.cpp against the FFat, String and FreeRTOS shims in
+// bench/native/ffat (a temporary directory stands in for the partition, the
+// worker is a thread) and checks what /api/analysis relies on:
+//   - a miss answers Pending without reading the CSV on the calling task,
+//     the worker's block then comes back Ready, bit-identical to get()
+//   - a repeated request is Ready at once, reading no byte of the CSV
+//   - a request for another file while the worker is busy answers Busy
+//   - missing files and VDS sweeps end as Failed
+//   - without modification times (noMtime) the memo is never trusted: a
+//     rewrite of the same size is analysed again, not served stale
+//   - forget() removes the memo and every block of the file's content
+// Any failed check makes the run exit non-zero.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -pthread -Ibench/native/ffat -Iinclude -Ibench bench/analysis_cache_check.cpp src/analysis_cache.cpp src/math_engine.cpp src/dsp_kernels.cpp -o analysis_cache_check
+// ============================================================================
+
+#include "analysis_cache.h"
+#include "file_manager.h"
+#include "ekv_curve.h"
+#include <FFat.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+FFatFS FFat;
+const char* FileManager::MEASUREMENTS_DIR = "/measurements";
+
+// Same rule as src/file_manager.cpp, without pulling in the rest of it
+bool FileManager::isValidFilename(const String& filename) {
+    if (filename.length() == 0 || filename.length() > 100) return false;
+    if (filename.indexOf("..") != -1 || filename.indexOf('/') != -1) return false;
+    return filename.endsWith(".csv");
+}
+
+// Same row parsing as src/file_manager.cpp
+bool FileManager::parseDataRow(const String& line, float& vds, float& vgs, float& ids) {
+    if (line.length() == 0 || line.charAt(0) == '#') return false;
+
+    float vd, vg, id;
+    if (sscanf(line.c_str(), "%*u,%f,%f,%*f,%e", &vd, &vg, &id) != 3) return false;
+    vds = vd;
+    vgs = vg;
+    ids = id;
+    return true;
+}
+
+bool FileManager::isOutputSweepHeader(const String& line) {
+    return line.startsWith("# Sweep Mode:") && line.indexOf("VDS") != -1;
+}
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    failures += !ok;
+}
+
+/** A SWEEP_VGS run of three curves, as MOSController saves it. */
+void writeRun(const char* name, unsigned seed, const char* sweepMode = "VGS") {
+    FILE* fp = fopen(FFat.host(std::string(FileManager::MEASUREMENTS_DIR) + "/" + name).c_str(), "w");
+    fprintf(fp, "# Sweep Mode: %s\n#\ntimestamp,vd,vg,vsh,ids,samples,fsr\n", sweepMode);
+    const float vds[] = { 0.1f, 0.5f, 1.0f };
+    for (int c = 0; c < 3; c++) {
+        EkvParams p;
+        p.points = 301;
+        p.noise  = 0.01f;
+        p.seed   = seed * 10 + c;
+        std::vector<float> vgs, ids;
+        makeTransferCurve(p, vgs, ids);
+        fprintf(fp, "# VDS=%.3fV: Vt=0.8000V\n", vds[c]);
+        for (size_t i = 0; i < vgs.size(); i++) {
+            fprintf(fp, "%u,%.3f,%.3f,%.6f,%.6e,%u,%.3f\n", (unsigned)i, vds[c], vgs[i], ids[i] * 100.0f, ids[i], 16u, 4.096f);
+        }
+    }
+    fclose(fp);
+}
+
+/** Poll request() as the dashboard does, until it answers Ready or Failed. */
+AnalysisCache::Lookup poll(const String& name, const AnalysisParams& params,
+                           AnalysisBlock& block, bool& fromCache) {
+    AnalysisCache::Lookup r = AnalysisCache::request(name, params, block, fromCache);
+    for (int i = 0; i < 5000 && (r == AnalysisCache::Lookup::Pending || r == AnalysisCache::Lookup::Busy); i++) {
+        delay(1);
+        r = AnalysisCache::request(name, params, block, fromCache);
+    }
+    return r;
+}
+
+bool sameBlock(const AnalysisBlock& a, const AnalysisBlock& b) {
+    return a.fileCrc == b.fileCrc && a.paramsHash == b.paramsHash && a.curves.size() == b.curves.size() &&
+           memcmp(a.curves.data(), b.curves.data(), a.curves.size() * sizeof(CachedCurve)) == 0;
+}
+
+int blocksOf(uint32_t fileCrc) {
+    char prefix[16];
+    snprintf(prefix, sizeof(prefix), "%08lx_", (unsigned long)fileCrc);
+    int n = 0;
+    File dir = FFat.open(AnalysisCache::CACHE_DIR);
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        n += strstr(f.name(), prefix) != nullptr;
+    }
+    return n;
+}
+
+} // namespace
+
+int main() {
+    char root[] = "/tmp/analysis_cache_check_XXXXXX";
+    if (!mkdtemp(root)) return 1;
+    FFat.root        = root;
+    FFat.holdPrefix  = FileManager::MEASUREMENTS_DIR;
+    FFat.countPrefix = FileManager::MEASUREMENTS_DIR;
+    FFat.mkdir(FileManager::MEASUREMENTS_DIR);
+    AnalysisCache::init();
+
+    writeRun("run_1.csv", 1);
+    writeRun("run_2.csv", 2);
+    writeRun("run_vds.csv", 3, "VDS");
+
+    AnalysisParams params;
+    AnalysisParams wide;
+    wide.gm.smoothingWindow = 9;
+    AnalysisBlock block, again, direct;
+    bool fromCache = false;
+
+    printf("miss, then hit:\n");
+    FFat.hold = true;
+    FFat.bytesRead = 0;
+    check(AnalysisCache::request("run_1.csv", params, block, fromCache) == AnalysisCache::Lookup::Pending,
+          "first request is Pending");
+    check(FFat.bytesRead == 0, "the caller read no CSV byte");
+    check(AnalysisCache::request("run_2.csv", params, block, fromCache) == AnalysisCache::Lookup::Busy,
+          "another file while the worker runs is Busy");
+    check(AnalysisCache::request("run_1.csv", params, block, fromCache) == AnalysisCache::Lookup::Pending,
+          "the same request again is still Pending");
+    FFat.hold = false;
+    check(poll("run_1.csv", params, block, fromCache) == AnalysisCache::Lookup::Ready && !fromCache,
+          "worker result is Ready, not from the cache");
+    check(block.curves.size() == 3, "three curves");
+    AnalysisCache::get("run_1.csv", params, direct, fromCache);
+    check(sameBlock(block, direct), "bit-identical to the blocking get()");
+
+    FFat.bytesRead = 0;
+    check(AnalysisCache::request("run_1.csv", params, again, fromCache) == AnalysisCache::Lookup::Ready && fromCache,
+          "repeat is Ready at once, from the cache");
+    check(FFat.bytesRead == 0 && sameBlock(again, block), "and read no CSV byte");
+    check(poll("run_1.csv", wide, again, fromCache) == AnalysisCache::Lookup::Ready && !fromCache &&
+          again.fileCrc == block.fileCrc && again.paramsHash != block.paramsHash,
+          "other parameters: a second block of the same content");
+
+    printf("failures:\n");
+    check(poll("missing.csv", params, block, fromCache) == AnalysisCache::Lookup::Failed, "missing file is Failed");
+    check(poll("run_vds.csv", params, block, fromCache) == AnalysisCache::Lookup::Failed, "VDS sweep is Failed");
+    check(AnalysisCache::request("../x.csv", params, block, fromCache) == AnalysisCache::Lookup::Failed,
+          "invalid name is Failed at once");
+
+    printf("no modification time:\n");
+    FFat.noMtime = true;
+    check(poll("run_2.csv", params, block, fromCache) == AnalysisCache::Lookup::Ready, "analysed");
+    const uint32_t before = block.fileCrc;
+    check(AnalysisCache::request("run_2.csv", params, again, fromCache) == AnalysisCache::Lookup::Pending,
+          "repeat goes back to the worker to hash the file");
+    check(poll("run_2.csv", params, again, fromCache) == AnalysisCache::Lookup::Ready && fromCache &&
+          sameBlock(again, block), "and is then served from the block");
+
+    // Same size, other content: only the CRC can tell
+    writeRun("run_2.csv", 4);
+    check(poll("run_2.csv", params, again, fromCache) == AnalysisCache::Lookup::Ready && !fromCache &&
+          again.fileCrc != before, "rewrite of the same size is analysed again");
+    FFat.noMtime = false;
+
+    printf("forget:\n");
+    check(blocksOf(direct.fileCrc) == 2, "run_1 has two blocks");
+    FFat.remove((std::string(FileManager::MEASUREMENTS_DIR) + "/run_1.csv").c_str());
+    AnalysisCache::forget("run_1.csv");
+    check(blocksOf(direct.fileCrc) == 0, "forget() removed both");
+    check(!FFat.exists(String(AnalysisCache::CACHE_DIR) + "/run_1.crc"), "and the memo");
+    check(blocksOf(again.fileCrc) == 1, "run_2's block is kept");
+
+    AnalysisCache::clear();
+    std::string cleanup = std::string("rm -rf ") + root;
+    if (system(cleanup.c_str()) != 0) fprintf(stderr, "could not remove %s\n", root);
+
+    printf("\n%d failed check(s)\n", failures);
+    return failures ? 1 : 0;
+}
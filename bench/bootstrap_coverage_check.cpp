@@ -0,0 +1,147 @@
+// ============================================================================
+// bootstrapCurve — width and coverage of the 95% intervals
+// ============================================================================
+// Every scenario draws REPLICAS noisy curves from the EKV generator
+// (bench/ekv_curve.h, with mobility degradation so Gm has a peak), each with
+// its own seed, and bootstraps every one. Two things are measured per
+// parameter (Vt, SS, max Gm):
+//
+//   width    median interval width over the central 95% range of the
+//            estimates across replicas — the spread the interval is meant
+//            to reproduce. Residuals shrunk by the smoother leave it ~30%
+//            short.
+//   truth    share of intervals containing the generator's true value: the
+//            same analysis (CurveAnalyzer, default configuration) run on
+//            the noise-free curve. The EKV parameters themselves are not
+//            the target, since max-Gm Vt is not the model's Vt.
+//
+// A width outside [MIN_WIDTH, MAX_WIDTH] fails the run, as does SS coverage
+// below MIN_COVERAGE (binomial standard error ~1.8% with REPLICAS curves).
+// Unscaled residuals gave max Gm ~0.4 at 2% noise; with the leverage
+// correction it is ~0.65 there (the peak of a Gm that is mostly noise has a
+// long upper tail) and ~1 elsewhere.
+// Vt and max-Gm coverage is reported only: the peak of a noisy Gm is biased
+// upward by the noise, so their intervals sit above the noise-free value by
+// about that bias, which resampling reproduces instead of removing.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude -Ibench bench/bootstrap_coverage_check.cpp src/math_engine.cpp src/dsp_kernels.cpp -o bootstrap_coverage_check
+// ============================================================================
+
+#include "math_engine.h"
+#include "ekv_curve.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+using namespace math_engine;
+
+namespace {
+
+const int      REPLICAS     = 150;
+const uint16_t ITERATIONS   = 128;
+const double   MIN_WIDTH    = 0.55;
+const double   MAX_WIDTH    = 1.60;
+const double   MIN_COVERAGE = 0.90;
+
+struct Scenario {
+    const char* name;
+    float       step;
+    float       noise;
+};
+
+CurveAnalyzer::Result analyse(const std::vector<float>& vgs, const std::vector<float>& ids, ScratchArena& arena) {
+    ScratchArena::Scope scope(arena);
+    CurveAnalyzer analyzer;
+    if (!analyzer.begin(ids.size(), arena)) return CurveAnalyzer::Result();
+    for (size_t i = 0; i < ids.size(); i++) analyzer.push(vgs[i], ids[i]);
+    return analyzer.finish();
+}
+
+float quantile(std::vector<float> v, float q) {
+    std::sort(v.begin(), v.end());
+    return v[static_cast<size_t>(q * (v.size() - 1) + 0.5f)];
+}
+
+/** One parameter across the replicas of a scenario. */
+struct Param {
+    std::vector<float> estimates, widths;
+    int hit = 0;
+
+    void add(bool found, float estimate, const ConfidenceInterval& ci, float truth) {
+        if (found) estimates.push_back(estimate);
+        if (!ci.valid) return;
+        widths.push_back(ci.hi - ci.lo);
+        hit += ci.lo <= truth && truth <= ci.hi;
+    }
+    double width() const {
+        const float spread = quantile(estimates, 0.975f) - quantile(estimates, 0.025f);
+        return spread > 0 ? quantile(widths, 0.5f) / spread : 0.0;
+    }
+    double coverage() const { return widths.empty() ? 0.0 : static_cast<double>(hit) / widths.size(); }
+};
+
+int failures = 0;
+
+void report(const char* name, const Param& p, bool gateCoverage) {
+    const bool widthOk    = p.width() >= MIN_WIDTH && p.width() <= MAX_WIDTH;
+    const bool coverageOk = !gateCoverage || p.coverage() >= MIN_COVERAGE;
+    printf(" | %-5s %5.2f %5.1f%%%s", name, p.width(), 100.0 * p.coverage(),
+           widthOk && coverageOk ? "     " : " FAIL");
+    failures += !widthOk + !coverageOk;
+}
+
+} // namespace
+
+int main() {
+    const Scenario scenarios[] = {
+        { "10 mV, 0.1%", 0.010f, 0.001f },
+        { "5 mV, 0.1%",  0.005f, 0.001f },
+        { "10 mV, 2%",   0.010f, 0.020f },
+        { "5 mV, 2%",    0.005f, 0.020f },
+    };
+
+    printf("%d curves per scenario, %u resamples each; width pass %.2f-%.2f, SS coverage >= %.0f%%\n\n",
+           REPLICAS, (unsigned)ITERATIONS, MIN_WIDTH, MAX_WIDTH, 100.0 * MIN_COVERAGE);
+    printf("%-12s | %-5s %5s %6s      | %-5s %5s %6s      | %-5s %5s %6s\n",
+           "scenario", "", "width", "truth", "", "width", "truth", "", "width", "truth");
+    printf("-------------+-------------------------+-------------------------+-------------------------\n");
+
+    BootstrapConfig config;
+    config.iterations = ITERATIONS;
+
+    for (const Scenario& s : scenarios) {
+        EkvParams p;
+        p.theta  = 1.0f;
+        p.step   = s.step;
+        p.points = static_cast<size_t>(3.0f / s.step) + 1;
+
+        ScratchArena arena(bootstrapScratchBytes(p.points, ITERATIONS));
+        std::vector<float> vgs, ids;
+        makeTransferCurve(p, vgs, ids);
+        const CurveAnalyzer::Result truth = analyse(vgs, ids, arena);
+
+        Param vt, ss, gm;
+        p.noise = s.noise;
+        for (int r = 0; r < REPLICAS; r++) {
+            p.seed = 1000 + r;
+            makeTransferCurve(p, vgs, ids);
+            const CurveAnalyzer::Result est = analyse(vgs, ids, arena);
+            config.seed = p.seed;
+            const BootstrapResult b = bootstrapCurve(vgs, ids, arena, config);
+            vt.add(est.vt > 0, est.vt, b.vt, truth.vt);
+            ss.add(est.ss.valid, est.ss.ss_mVdec, b.ss, truth.ss.ss_mVdec);
+            gm.add(est.maxGm > 0, est.maxGm, b.maxGm, truth.maxGm);
+        }
+
+        printf("%-12s", s.name);
+        report("Vt", vt, false);
+        report("SS", ss, true);
+        report("MaxGm", gm, false);
+        printf("\n");
+    }
+
+    printf("\n%d failed check(s)\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// ============================================================================
+// CurveAnalyzer — bit comparison against the batch analysis
+// ============================================================================
+// CurveAnalyzer promises the same result as the batch path it replaced in
+// the sweep loop:
+//
+//   calculateGm()  ->  segmentCurve()  ->  calculateVt() / extractVt() on
+//   the regions (arena overloads), SS from the whole-curve calculateSS()
+//   (or its region overload for the robust SSConfig methods)
+//
+// Random EKV curves are pushed point by point and every output — Gm per
+// point, the CurveRegions, maxGm, Vt, each extractVt() estimate and its
+// flags, and the SSResult — is compared with memcmp against the batch
+// calls. Curves vary in length (including shorter than the SG window),
+// VGS step, noise, ADC spikes, SG window/order, moving-average Gm, SS
+// method and grid: uniform, or every other step 20% longer (streamed Gm
+// is then redone with a GridKernel). Some are pushed into an analyzer sized
+// for a longer sweep, as when a sweep is cut short. Any mismatch fails the
+// run.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude -Ibench bench/curve_analyzer_check.cpp src/math_engine.cpp src/dsp_kernels.cpp -o curve_analyzer_check
+// ============================================================================
+
+#include "math_engine.h"
+#include "ekv_curve.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace math_engine;
+
+namespace {
+
+const int CURVES = 3000;
+
+bool sameBits(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+bool sameEstimate(const VtEstimate& a, const VtEstimate& b) { return sameBits(a.vt, b.vt) && a.flags == b.flags; }
+
+bool sameSS(const SSResult& a, const SSResult& b) {
+    return a.valid == b.valid && sameBits(a.ss_mVdec, b.ss_mVdec) &&
+           sameBits(a.x1, b.x1) && sameBits(a.y1, b.y1) && sameBits(a.x2, b.x2) && sameBits(a.y2, b.y2) &&
+           a.regionStart == b.regionStart && a.regionEnd == b.regionEnd;
+}
+
+bool sameRegions(const CurveRegions& a, const CurveRegions& b) {
+    return a.valid == b.valid && a.subthreshold == b.subthreshold && a.saturation == b.saturation &&
+           a.linear == b.linear && a.size == b.size && a.gmPeak == b.gmPeak &&
+           a.steepStart == b.steepStart && a.steepEnd == b.steepEnd;
+}
+
+/** Mismatches per output, summed over all curves. */
+struct Tally {
+    int gm = 0, regions = 0, maxGm = 0, vt = 0, vtMethods = 0, ss = 0;
+    int total() const { return gm + regions + maxGm + vt + vtMethods + ss; }
+};
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+    const SSMethod methods[] = { SSMethod::SlidingWindow, SSMethod::TheilSen, SSMethod::Ransac };
+
+    Tally bad;
+    int irregular = 0, cut = 0, shortCurves = 0, robust = 0, movingAverage = 0;
+    for (int c = 0; c < CURVES; c++) {
+        EkvParams p;
+        p.points     = (c % 10 == 0) ? 5 + rng() % 10 : 20 + rng() % 1200;
+        p.step       = 0.002f + 0.028f * ud(rng);
+        p.vt         = 0.3f + p.points * p.step * (0.2f + 0.5f * ud(rng));
+        p.ssTarget   = 65.0f + 60.0f * ud(rng);
+        p.noise      = 0.02f * ud(rng);
+        p.spikeRate  = (c % 4 == 0) ? 0.01f : 0.0f;
+        p.seed       = static_cast<unsigned>(c + 1);
+
+        std::vector<float> vgs, ids;
+        makeTransferCurve(p, vgs, ids);
+        const size_t n = vgs.size();
+        if (c % 3 == 1) {
+            for (size_t i = 1; i < n; i++) vgs[i] = vgs[i - 1] + (i % 2 ? 1.2f : 0.8f) * p.step;
+            irregular++;
+        }
+
+        GmConfig gmConfig;
+        gmConfig.smoothingWindow  = 5 + 2 * (rng() % 4);
+        gmConfig.polyOrder        = 2 + rng() % 3;
+        gmConfig.useSavitzkyGolay = rng() % 8 != 0;
+        SSConfig ssConfig;
+        ssConfig.method = methods[rng() % 3];
+        const VtConfig vtConfig;
+        const size_t capacity = (c % 5 == 0) ? n + rng() % 200 : n;
+
+        shortCurves   += n < gmConfig.smoothingWindow;
+        cut           += capacity > n;
+        robust        += ssConfig.method != SSMethod::SlidingWindow;
+        movingAverage += !gmConfig.useSavitzkyGolay;
+
+        // Streamed
+        ScratchArena arena(scratchBytes(capacity));
+        CurveAnalyzer analyzer;
+        analyzer.begin(capacity, arena, gmConfig, vtConfig, ssConfig);
+        for (size_t i = 0; i < n; i++) analyzer.push(vgs[i], ids[i]);
+        const CurveAnalyzer::Result got = analyzer.finish();
+        const ConstFloatSpan gotGm = analyzer.gm();
+
+        // Batch
+        ScratchArena batch(scratchBytes(n));
+        std::vector<float> gm(n);
+        calculateGm(ids, vgs, gm, batch, gmConfig);
+        const CurveRegions regions = segmentCurve(vgs, ids, gm, batch);
+        const SSResult ss = ssConfig.method == SSMethod::SlidingWindow
+            ? calculateSS(ids, vgs, batch)
+            : calculateSS(ids, vgs, regions, batch, ssConfig);
+        const float    vt        = calculateVt(gm, vgs, ids, regions, batch);
+        const VtResult vtMethods = extractVt(vgs, ids, gm, regions, batch, vtConfig);
+
+        bool gmSame = gotGm.size() == n;
+        for (size_t i = 0; gmSame && i < n; i++) gmSame = sameBits(gotGm[i], gm[i]);
+        bad.gm        += !gmSame;
+        bad.regions   += !sameRegions(got.regions, regions);
+        bad.maxGm     += !sameBits(got.maxGm, gm[regions.gmPeak < n ? regions.gmPeak : 0]);
+        bad.vt        += !sameBits(got.vt, vt);
+        bad.vtMethods += !(sameEstimate(got.vtMethods.maxGm, vtMethods.maxGm) &&
+                           sameEstimate(got.vtMethods.secondDerivative, vtMethods.secondDerivative) &&
+                           sameEstimate(got.vtMethods.constantCurrent, vtMethods.constantCurrent) &&
+                           sameEstimate(got.vtMethods.yFunction, vtMethods.yFunction));
+        bad.ss        += !sameSS(got.ss, ss);
+    }
+
+    printf("%d curves: %d irregular grid, %d cut short, %d shorter than the SG window,\n"
+           "%d robust SS, %d moving-average Gm\n\n", CURVES, irregular, cut, shortCurves, robust, movingAverage);
+    printf("curves with a bit mismatch:\n");
+    printf("  Gm %d, regions %d, maxGm %d, Vt %d, extractVt %d, SS %d\n",
+           bad.gm, bad.regions, bad.maxGm, bad.vt, bad.vtMethods, bad.ss);
+    return bad.total() ? 1 : 0;
+}
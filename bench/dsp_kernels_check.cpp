@@ -0,0 +1,150 @@
+// ============================================================================
+// DSP kernels — bit comparison and moving-average timing
+// ============================================================================
+// 1. dot(), correlate() and scale() must match esp-dsp's ANSI reference
+//    (dsps_dotprod_f32_ansi, dsps_corr_f32_ansi, dsps_mulc_f32_ansi,
+//    reproduced below) bit for bit, and a one-output correlate() must equal
+//    the same output of a full call. Any mismatch fails the run.
+// 2. runningMean() is compared against the per-window mean it replaced
+//    (worst relative error, including a large-offset curve where an
+//    uncompensated sliding sum would drift) and timed against it.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/dsp_kernels_check.cpp src/dsp_kernels.cpp -o dsp_kernels_check
+//
+// On a host this exercises the portable backend. Building the same program
+// for the ESP32 with esp-dsp available checks the AE32 routines instead.
+// ============================================================================
+
+#include "dsp_kernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace math_engine;
+
+namespace {
+
+// ---- esp-dsp ANSI reference ------------------------------------------------
+
+float refDot(const float* src1, const float* src2, int len) {
+    float acc = 0;
+    for (int i = 0; i < len; i++) acc += src1[i] * src2[i];
+    return acc;
+}
+
+void refCorr(const float* signal, int siglen, const float* pattern, int patlen, float* dest) {
+    for (int n = 0; n <= siglen - patlen; n++) {
+        float k_corr = 0;
+        for (int m = 0; m < patlen; m++) k_corr += signal[n + m] * pattern[m];
+        dest[n] = k_corr;
+    }
+}
+
+void refMulc(const float* input, float* output, int len, float c) {
+    for (int i = 0; i < len; i++) output[i] = input[i] * c;
+}
+
+/** The centred windowed mean movingAverageSmooth() used before runningMean(). */
+void windowedMean(const float* in, float* out, size_t n, size_t window) {
+    const int half = static_cast<int>(window / 2);
+    for (size_t i = 0; i < n; i++) {
+        float sum = 0;
+        int count = 0;
+        for (int k = -half; k <= half; k++) {
+            int idx = static_cast<int>(i) + k;
+            if (idx >= 0 && idx < static_cast<int>(n)) {
+                sum += in[idx];
+                count++;
+            }
+        }
+        out[i] = sum / count;
+    }
+}
+
+bool sameBits(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+template <typename F>
+double nanosPerPoint(F&& f, size_t n, int repeats) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / repeats / n;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> ud(-1.0f, 1.0f);
+    printf("backend: %s\n\n", kernels::backend());
+
+    // ---- 1. Bit comparison -------------------------------------------------
+    size_t checked = 0, mismatches = 0;
+    for (int t = 0; t < 2000; t++) {
+        const size_t taps = 1 + rng() % 21;
+        const size_t n    = taps + rng() % 300;
+        std::vector<float> x(n), h(taps), got(n), want(n);
+        for (float& v : x) v = ud(rng) * powf(10.0f, static_cast<float>(rng() % 12) - 9.0f);
+        for (float& v : h) v = ud(rng);
+
+        const float d = kernels::dot(x.data(), h.data(), taps);
+        checked++;
+        if (!sameBits(d, refDot(x.data(), h.data(), static_cast<int>(taps)))) mismatches++;
+
+        const size_t outputs = n - taps + 1;
+        kernels::correlate(x.data(), n, h.data(), taps, got.data());
+        refCorr(x.data(), static_cast<int>(n), h.data(), static_cast<int>(taps), want.data());
+        for (size_t i = 0; i < outputs; i++) {
+            float one;
+            kernels::correlate(x.data() + i, taps, h.data(), taps, &one);
+            checked += 2;
+            if (!sameBits(got[i], want[i])) mismatches++;
+            if (!sameBits(one, got[i]))     mismatches++;
+        }
+
+        const float c = ud(rng) * 1e3f;
+        kernels::scale(x.data(), got.data(), n, c);
+        refMulc(x.data(), want.data(), static_cast<int>(n), c);
+        kernels::scale(x.data(), x.data(), n, c);  // in place
+        for (size_t i = 0; i < n; i++) {
+            checked += 2;
+            if (!sameBits(got[i], want[i])) mismatches++;
+            if (!sameBits(x[i], want[i]))   mismatches++;
+        }
+    }
+    printf("dot / correlate / scale: %zu values, %zu bit mismatches\n\n", checked, mismatches);
+
+    // ---- 2. runningMean accuracy and speed ---------------------------------
+    const size_t n = 5000;
+    std::vector<float> noisy(n), offset(n), a(n), b(n);
+    for (size_t i = 0; i < n; i++) {
+        noisy[i]  = 1e-6f * expf(i * 0.002f) * (1.0f + 0.05f * ud(rng));
+        offset[i] = 1000.0f + 1e-3f * ud(rng);
+    }
+
+    printf("%6s | %12s | %12s | %10s | %10s\n",
+           "window", "rel err exp", "rel err ofs", "ns/pt old", "ns/pt new");
+    printf("-------+--------------+--------------+------------+-----------\n");
+    for (size_t w : { 3, 5, 9, 21, 51 }) {
+        double worst[2] = { 0, 0 };
+        const std::vector<float>* inputs[2] = { &noisy, &offset };
+        for (int k = 0; k < 2; k++) {
+            windowedMean(inputs[k]->data(), a.data(), n, w);
+            kernels::runningMean(inputs[k]->data(), b.data(), n, w);
+            for (size_t i = 0; i < n; i++) {
+                const double rel = fabs(static_cast<double>(b[i]) - a[i]) / fabs(a[i]);
+                if (rel > worst[k]) worst[k] = rel;
+            }
+        }
+        const double tOld = nanosPerPoint([&] { windowedMean(noisy.data(), a.data(), n, w); }, n, 50);
+        const double tNew = nanosPerPoint([&] { kernels::runningMean(noisy.data(), b.data(), n, w); }, n, 50);
+        printf("%6zu | %12.3e | %12.3e | %10.2f | %10.2f\n", w, worst[0], worst[1], tOld, tNew);
+    }
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+#ifndef EKV_CURVE_H
+#define EKV_CURVE_H
+
+// ============================================================================
+// Synthetic MOSFET transfer curves for the host benchmarks
+// ============================================================================
+// EKV-style interpolation between weak and strong inversion:
+//
+//   Ids = Is · ln²(1 + exp((Vgs − Vt) / (2·n·UT))) + Ileak
+//
+// with the slope factor n derived from the requested subthreshold swing
+// (SS = n·UT·ln10). Optional mobility degradation divides the first term
+// by 1 + (θ·Vov)², Vov = 2·n·UT·ln(1 + eˣ), so Gm peaks at Vov ≈ 1/(√3·θ)
+// instead of rising to the end of the sweep. Noise is proportional (ADC gain error) plus an
+// absolute floor (shunt / ADC offset), both Gaussian and seeded. Optional
+// spikes multiply a random fraction of the points (ADC glitches).
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+struct EkvParams {
+    float    vt       = 0.8f;    ///< Threshold voltage (V)
+    float    ssTarget = 80.0f;   ///< Subthreshold swing (mV/dec)
+    float    is       = 2e-4f;   ///< Specific current (A)
+    float    leakage  = 1e-12f;  ///< Off-state current (A)
+    float    theta    = 0.0f;    ///< Mobility degradation (1/V); 0 = none
+    float    vStart   = 0.0f;    ///< First VGS (V)
+    float    step     = 0.01f;   ///< VGS step (V)
+    size_t   points   = 301;     ///< Number of samples
+    float    noise    = 0.0f;    ///< Proportional noise (σ, fraction of Ids)
+    float    floor    = 2e-12f;  ///< Absolute noise (σ, A)
+    float    spikeRate  = 0.0f;  ///< Fraction of points hit by a spike
+    float    spikeScale = 10.0f; ///< Spiked points are multiplied or divided by this
+    unsigned seed     = 1;
+};
+
+inline void makeTransferCurve(const EkvParams& p, std::vector<float>& vgs, std::vector<float>& ids) {
+    const float UT = 0.02585f;
+    const float nFactor = p.ssTarget / (1000.0f * UT * logf(10.0f));
+    std::mt19937 rng(p.seed);
+    std::normal_distribution<float> nd(0.0f, 1.0f);
+
+    vgs.resize(p.points);
+    ids.resize(p.points);
+    for (size_t i = 0; i < p.points; i++) {
+        const float v = p.vStart + i * p.step;
+        const float x = (v - p.vt) / (2.0f * nFactor * UT);
+        const float l = x > 20.0f ? x : log1pf(expf(x));  // ln(1 + eˣ) = x to float precision; expf overflows past 88
+        const float vov = 2.0f * nFactor * UT * l;
+        const float clean = p.is * l * l / (1.0f + p.theta * p.theta * vov * vov) + p.leakage;
+        vgs[i] = v;
+        ids[i] = clean * (1.0f + p.noise * nd(rng)) + p.floor * nd(rng);
+    }
+    if (p.spikeRate > 0) {
+        std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+        for (size_t i = 0; i < p.points; i++) {
+            if (ud(rng) >= p.spikeRate) continue;
+            ids[i] = (ud(rng) < 0.5f) ? ids[i] * p.spikeScale : ids[i] / p.spikeScale;
+        }
+    }
+}
+
+#endif // EKV_CURVE_H
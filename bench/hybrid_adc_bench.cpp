@@ -0,0 +1,172 @@
+// ============================================================================
+// HybridADC — GPIO34 coarse read ahead of the ADS1115 vs auto-ranging alone
+// ============================================================================
+// Reads a simulated Vgs sweep whose top end runs into compliance (the shunt
+// voltage pinned near the 3.3 V supply) two ways:
+//   auto     ExternalADC auto-ranging: range from the previous reading,
+//            clipped readings repeated one range wider
+//   3.0 V    the former HybridADC rule: a coarse internal-ADC window picks
+//            the range with hal::pgaRangeFor(), coarse readings at or above
+//            3.0 V are recorded instead of the ADS1115
+//   hybrid   HybridADC: only a clipped coarse window (code 4095) skips the
+//            ADS1115; from HYBRID_WIDE_RANGE_V up the widest range is used
+// The coarse model is an uncalibrated ESP32 ADC at 11 dB: reads 0 below
+// 0.1 V, ±2% gain and ±30 mV offset error, σ = 8 mV, reading up to ~0.1 V
+// low as the curve bends above 2.5 V, and clipped (4095, 3.3 V) from 3.15 V.
+// 16 analogRead() calls per coarse window.
+// The ADS1115 model clips at +32767 with σ = 1.5 LSB; 16 conversions per
+// reading at 1.163 ms. Reported: ADS1115 conversions, ADC time per sweep,
+// re-reads after clipping, points recorded from the coarse read, and the
+// RMS relative error of every recorded point below compliance. A second curve jumps between
+// 1 mV and 1 V, where the previous reading is no guide to the range.
+//
+// Constants mirror hardware_hal.h (HYBRID_*), which needs Arduino.h.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/hybrid_adc_bench.cpp -o hybrid_adc_bench
+// ============================================================================
+
+#include "oversampling.h"
+#include "pga_autorange.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace hal;
+
+namespace {
+
+const int      POINTS        = 301;    // Vgs 0..3 V in 10 mV steps
+const uint16_t N             = 16;
+const double   CONVERSION_MS = 1.163;
+const double   COARSE_MS     = 0.16;   // 16 analogRead() at ~10 us
+const float    MARGIN_V      = 0.10f;  // HYBRID_COARSE_MARGIN
+const float    WIDE_RANGE_V  = 3.0f;   // HYBRID_WIDE_RANGE_V
+const double   CLIP_V        = 3.15;   // Input at which GPIO34 reads 4095
+const double   SUPPLY_V      = 3.25;
+
+double shuntVolts(double vg) {
+    const double vt = 1.2, n = 1.5, ut = 0.0259, k = 2.0, leak = 300e-6;
+    const double v = leak + ((vg < vt) ? 1e-3 * std::exp((vg - vt) / (n * ut)) : 1e-3 + k * (vg - vt) * (vg - vt));
+    return std::min(v, SUPPLY_V);  // Compliance: the drain supply runs out
+}
+
+class Models {
+public:
+    explicit Models(uint32_t seed) : rng_(seed), ads_(0.0, 1.5), esp_(0.0, 0.008) {}
+
+    float fine(double volts, uint8_t index, bool& clipped) {
+        const double lsb = PGA_RANGES[index].fsr / 32767.0;
+        uint16_t s[N];
+        clipped = false;
+        for (uint16_t i = 0; i < N; i++) {
+            const double code = std::round(volts / lsb + ads_(rng_));
+            s[i] = static_cast<uint16_t>(std::min(32767.0, std::max(0.0, code)));
+            if (s[i] >= 32767) clipped = true;
+        }
+        conversions += N;
+        ms += N * CONVERSION_MS;
+        return static_cast<float>(trimmedMeanSelect(s, N) * lsb);
+    }
+
+    float coarse(double volts, bool& clipped) {
+        ms += COARSE_MS;
+        clipped = volts >= CLIP_V;
+        if (clipped) return 3.3f;
+        const double bend = volts > 2.5 ? 0.2 * (volts - 2.5) * (volts - 2.5) : 0.0;
+        double v = volts < 0.1 ? 0.0 : volts * 1.02 - 0.030 - bend + esp_(rng_);
+        return static_cast<float>(std::min(3.3, std::max(0.0, v)));
+    }
+
+    uint32_t conversions = 0;
+    double   ms          = 0.0;
+
+private:
+    std::mt19937 rng_;
+    std::normal_distribution<double> ads_;
+    std::normal_distribution<double> esp_;
+};
+
+struct Result {
+    uint32_t conversions = 0;
+    double   ms          = 0.0;
+    int      rereads     = 0;
+    int      coarseRows  = 0;
+    double   err         = 0.0;
+    int      nErr        = 0;
+};
+
+double transferCurve(int p) { return shuntVolts(p * 0.01); }
+
+/** Large jumps: the previous reading says nothing about the next point. */
+double stepCurve(int p) { return (p / 10) % 2 ? 1.0 : 1e-3; }
+
+enum class Mode { Auto, Threshold, Hybrid };
+
+Result sweep(Mode mode, double (*curve)(int)) {
+    Models m(5);
+    Result r;
+    uint8_t index = pgaRangeIndex(16);
+    for (int p = 0; p < POINTS; p++) {
+        const double truth = curve(p);
+        float v = 0.0f;
+        bool  coarseRow = false;
+        if (mode != Mode::Auto) {
+            bool cClipped = false;
+            const float c = m.coarse(truth, cClipped);
+            coarseRow = mode == Mode::Threshold ? c >= WIDE_RANGE_V : cClipped;
+            if (coarseRow) {
+                r.coarseRows++;
+                v = c;
+            } else {
+                index = (mode == Mode::Hybrid && c >= WIDE_RANGE_V) ? 0 : pgaRangeFor(c + MARGIN_V);
+            }
+        }
+        if (!coarseRow) {
+            bool clipped = false;
+            v = m.fine(truth, index, clipped);
+            while (clipped && index > 0) {
+                index--;
+                r.rereads++;
+                v = m.fine(truth, index, clipped);
+            }
+            if (mode == Mode::Auto) index = pgaNextRange(index, v, clipped);
+        }
+        if (truth < SUPPLY_V) {
+            const double rel = (v - truth) / truth;
+            r.err += rel * rel;
+            r.nErr++;
+        }
+    }
+    r.conversions = m.conversions;
+    r.ms          = m.ms;
+    r.err         = r.nErr ? std::sqrt(r.err / r.nErr) : 0.0;
+    return r;
+}
+
+void report(const char* name, const Result& r) {
+    printf("%-8s | %11u | %9.2f | %7d | %11d | %8.3f\n", name, (unsigned)r.conversions, r.ms / 1000.0,
+           r.rereads, r.coarseRows, r.err * 100.0);
+}
+
+} // namespace
+
+int main() {
+    int compliance = 0;
+    for (int p = 0; p < POINTS; p++) compliance += shuntVolts(p * 0.01) >= SUPPLY_V;
+    printf("Transfer curve, %d points (%d at compliance), %u ADS1115 conversions per reading\n\n",
+           POINTS, compliance, N);
+    printf("%-8s | %11s | %9s | %7s | %11s | %8s\n", "mode", "conversions", "ADC s", "rereads", "coarse rows", "err %");
+    printf("---------+-------------+-----------+---------+-------------+---------\n");
+    report("auto", sweep(Mode::Auto, transferCurve));
+    report("3.0 V", sweep(Mode::Threshold, transferCurve));
+    report("hybrid", sweep(Mode::Hybrid, transferCurve));
+
+    printf("\nSteps between 1 mV and 1 V every 10 points\n");
+    report("auto", sweep(Mode::Auto, stepCurve));
+    report("3.0 V", sweep(Mode::Threshold, stepCurve));
+    report("hybrid", sweep(Mode::Hybrid, stepCurve));
+    return 0;
+}
@@ -0,0 +1,411 @@
+// ============================================================================
+// math_engine benchmark suite
+// ============================================================================
+// Times every analysis entry point on synthetic EKV transfer curves of 20 to
+// 5000 points and reports, per function and size:
+//   - ns/point   wall time of one call divided by the curve length
+//   - allocs     heap allocations made by one call (operator new is counted)
+//
+// Span/arena overloads must make 0 allocations: every row not marked as a
+// std::vector API is checked, and any allocation there is reported and fails
+// the run (exit status 1).
+//
+// calculateSS is also timed against the pre-prefix-sum implementation
+// (baseline::calculateSS below, O(n·w) with a two-pass regression per
+// window) on the same curves; the per-curve speedup and whether both return
+// the same SSResult are printed under each size. From 2000 points on, the
+// 0..3 V step is too fine for a 5-20 point window to cover half a decade, so
+// neither finds one and the comparison is printed as n/a rather than "yes".
+//
+// A last table runs long and fine-step sweeps (10 V at 10 mV, 1-3 mV steps)
+// through segmentCurve() and compares region-restricted SS with the
+// whole-curve scan and Theil-Sen.
+//
+// Native build through PlatformIO:
+//   pio run -e native && .pio/build/native/program
+// or directly, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude -Ibench/native bench/math_engine_bench.cpp src/math_engine.cpp src/dsp_kernels.cpp -o math_engine_bench
+// ============================================================================
+
+#include <Arduino.h>
+#include "math_engine.h"
+#include "ekv_curve.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace math_engine;
+
+// ---- Allocation counting -----------------------------------------------------
+
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    g_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    g_allocations++;
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    g_allocations++;
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ---- Baseline calculateSS (before the prefix-sum scan) ------------------------
+
+namespace baseline {
+
+std::vector<float> movingAverageSmooth(const std::vector<float>& data, size_t windowSize) {
+    if (data.empty()) return {};
+    if (windowSize < 1) windowSize = 1;
+    if (windowSize % 2 == 0) windowSize++;
+    const size_t n = data.size();
+    std::vector<float> result(n);
+    const int halfWindow = windowSize / 2;
+    for (size_t i = 0; i < n; i++) {
+        float sum = 0;
+        int count = 0;
+        for (int k = -halfWindow; k <= halfWindow; k++) {
+            const int idx = static_cast<int>(i) + k;
+            if (idx >= 0 && idx < static_cast<int>(n)) {
+                sum += data[idx];
+                count++;
+            }
+        }
+        result[i] = sum / count;
+    }
+    return result;
+}
+
+float linearRegression(const std::vector<float>& x, const std::vector<float>& y, float& slope, float& intercept) {
+    if (x.size() != y.size() || x.size() < 2) { slope = 0; intercept = 0; return 0; }
+    const size_t n = x.size();
+    double sx = 0, sy = 0, sxy = 0, sxx = 0, syy = 0;
+    for (size_t i = 0; i < n; i++) {
+        sx += x[i]; sy += y[i]; sxy += x[i] * y[i]; sxx += x[i] * x[i]; syy += y[i] * y[i];
+    }
+    const double denominator = n * sxx - sx * sx;
+    if (fabs(denominator) < 1e-12) { slope = 0; intercept = static_cast<float>(sy / n); return 0; }
+    slope     = static_cast<float>((n * sxy - sx * sy) / denominator);
+    intercept = static_cast<float>((sy - slope * sx) / n);
+    double ssRes = 0, ssTot = 0;
+    const double yMean = sy / n;
+    for (size_t i = 0; i < n; i++) {
+        const double yPred = slope * x[i] + intercept;
+        ssRes += (y[i] - yPred) * (y[i] - yPred);
+        ssTot += (y[i] - yMean) * (y[i] - yMean);
+    }
+    if (ssTot < 1e-12) return 1.0f;
+    return static_cast<float>(1.0 - ssRes / ssTot);
+}
+
+/** calculateSS as of the baseline commit: every window refilled and regressed. */
+SSResult calculateSS(const std::vector<float>& ids, const std::vector<float>& vgs) {
+    SSResult result;
+    if (ids.size() != vgs.size() || ids.size() < 10) return result;
+    const size_t n = ids.size();
+    const float IDS_FLOOR = 1e-13f;
+    std::vector<float> logIds(n, 0.0f);
+    std::vector<bool>  usable(n, false);
+    std::vector<float> idsSmooth = movingAverageSmooth(ids, 3);
+    for (size_t i = 0; i < n; i++) {
+        const float val = fabsf(idsSmooth[i]);
+        if (val > IDS_FLOOR) { logIds[i] = log10f(val); usable[i] = true; }
+    }
+
+    const size_t MIN_WIN = 5, MAX_WIN = 20;
+    float  bestR2 = -1.0f, bestSlope = 0.0f, bestIntercept = 0.0f;
+    size_t bestWinStart = 0, bestWinEnd = 0;
+    std::vector<float> wx, wy;
+    wx.reserve(MAX_WIN);
+    wy.reserve(MAX_WIN);
+    for (size_t win = MIN_WIN; win <= MAX_WIN && win <= n; win++) {
+        for (size_t start = 0; start + win <= n; start++) {
+            const size_t end = start + win;
+            wx.clear();
+            wy.clear();
+            for (size_t i = start; i < end; i++) {
+                if (usable[i]) { wx.push_back(vgs[i]); wy.push_back(logIds[i]); }
+            }
+            if (wx.size() < MIN_WIN) continue;
+            if (wy.back() <= wy.front()) continue;
+            if ((wy.back() - wy.front()) < 0.5f) continue;
+            float slope, intercept;
+            const float r2 = linearRegression(wx, wy, slope, intercept);
+            if (slope < 1.0f) continue;
+            if (r2 > bestR2) {
+                bestR2 = r2; bestSlope = slope; bestIntercept = intercept;
+                bestWinStart = start; bestWinEnd = end - 1;
+            }
+        }
+    }
+    if (bestR2 >= 0.85f && bestSlope > 1e-9f) {
+        const float ss_val = (1.0f / bestSlope) * 1000.0f;
+        if (ss_val >= 60.0f && ss_val <= 1000.0f) {
+            result.ss_mVdec    = ss_val;
+            result.valid       = true;
+            result.regionStart = bestWinStart;
+            result.regionEnd   = bestWinEnd;
+            result.x1 = vgs[bestWinStart];
+            result.y1 = bestSlope * result.x1 + bestIntercept;
+            result.x2 = vgs[bestWinEnd];
+            result.y2 = bestSlope * result.x2 + bestIntercept;
+        }
+    }
+    return result;
+}
+
+} // namespace baseline
+
+namespace {
+
+const unsigned long MIN_BENCH_US = 20000;  // Repeat each call for at least this long
+
+volatile float g_sink;  // Keeps results observable so calls are not elided
+
+struct Measurement {
+    double nsPerPoint;
+    size_t allocs;
+};
+
+/** Allocations of one call, then repeated timing until MIN_BENCH_US elapses. */
+template <typename F>
+Measurement measure(F&& call, size_t points) {
+    const size_t before = g_allocations;
+    g_sink = call();
+    const size_t allocs = g_allocations - before;
+
+    unsigned long reps = 0;
+    const unsigned long t0 = micros();
+    unsigned long elapsed = 0;
+    do {
+        g_sink = call();
+        reps++;
+        elapsed = micros() - t0;
+    } while (elapsed < MIN_BENCH_US);
+
+    return { 1000.0 * elapsed / reps / points, allocs };
+}
+
+bool sameBits(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+struct Row {
+    const char* name;
+    Measurement m;
+    bool        allocates = false;  ///< std::vector API; allocations expected
+};
+
+/**
+ * Long and fine-step sweeps: region-restricted SS against the whole-curve
+ * scan, and Theil-Sen over the located region. SS target 80 mV/dec.
+ */
+void fineStepSweeps() {
+    struct Grid { const char* name; float vt, step; size_t points; };
+    const Grid grids[] = {
+        { "0-10 V, 10 mV, Vt 0.8",  0.8f, 0.010f,  1001 },
+        { "0-10 V, 10 mV, Vt 5.0",  5.0f, 0.010f,  1001 },
+        { "0-3 V, 3 mV",            0.8f, 0.003f,  1000 },
+        { "0-3 V, 1.5 mV",          0.8f, 0.0015f, 2000 },
+        { "0-1 V, 1 mV",            0.8f, 0.001f,  1001 },
+    };
+    SSConfig theilSen;
+    theilSen.method = SSMethod::TheilSen;
+
+    printf("Long / fine-step sweeps (SS target 80 mV/dec, 0.5%% noise)\n");
+    printf("  %-24s %11s %9s %9s %9s %5s\n", "grid", "region", "full", "regions", "Theil-Sen", "same");
+    for (const Grid& g : grids) {
+        EkvParams p;
+        p.vt     = g.vt;
+        p.step   = g.step;
+        p.points = g.points;
+        p.noise  = 0.005f;
+        std::vector<float> vgs, ids;
+        makeTransferCurve(p, vgs, ids);
+
+        ScratchArena arena(scratchBytes(g.points));
+        const std::vector<float> gm = calculateGm(ids, vgs);
+        const CurveRegions regions = segmentCurve(vgs, ids, gm, arena);
+        const SSResult full   = calculateSS(ids, vgs, arena);
+        const SSResult region = calculateSS(ids, vgs, regions, arena);
+        const SSResult robust = calculateSS(ids, vgs, regions, arena, theilSen);
+        const bool same = full.valid == region.valid && sameBits(full.ss_mVdec, region.ss_mVdec);
+
+        char span[24];
+        snprintf(span, sizeof(span), "%zu-%zu", regions.subthreshold, regions.saturation);
+        printf("  %-24s %11s %9.2f %9.2f %9.2f %5s\n", g.name, span,
+               full.ss_mVdec, region.ss_mVdec, robust.ss_mVdec, same ? "yes" : "NO");
+    }
+    printf("  (0.00: no 5-20 point window covers half a decade on this grid)\n\n");
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    const size_t sizes[] = { 20, 50, 100, 200, 500, 1000, 2000, 5000 };
+
+    printf("math_engine benchmark — ns/point (allocations per call)\n");
+    printf("EKV curves over 0..3 V, Vt 0.8 V, SS 80 mV/dec, 0.5%% noise\n\n");
+
+    for (size_t n : sizes) {
+        EkvParams p;
+        p.points = n;
+        p.step   = 3.0f / (n - 1);
+        p.noise  = 0.005f;
+
+        std::vector<float> vgs, ids;
+        makeTransferCurve(p, vgs, ids);
+
+        const std::vector<float> gm = calculateGm(ids, vgs);
+
+        // Same curve on an irregular grid: every other step 20% longer
+        std::vector<float> vgsIrregular(vgs);
+        for (size_t i = 1; i < n; i++) vgsIrregular[i] = vgsIrregular[i - 1] + (i % 2 ? 1.2f : 0.8f) * p.step;
+        std::vector<float> out(n);
+        ScratchArena arena(scratchBytes(n));
+        const CurveRegions regions = segmentCurve(vgs, ids, gm, arena);
+
+        BootstrapConfig bootConfig;
+        bootConfig.iterations = 16;
+        ScratchArena bootArena(bootstrapScratchBytes(n, bootConfig.iterations));
+
+        GmConfig maConfig;
+        maConfig.useSavitzkyGolay = false;
+        SSConfig theilSen, ransac;
+        theilSen.method = SSMethod::TheilSen;
+        ransac.method   = SSMethod::Ransac;
+
+        const Row rows[] = {
+            { "movingAverageSmooth", measure([&] {
+                movingAverageSmooth(ids, out, 5);
+                return out[n / 2];
+            }, n) },
+            { "savitzkyGolaySmooth", measure([&] {
+                savitzkyGolaySmooth(ids, out, 5, 2);
+                return out[n / 2];
+            }, n) },
+            { "calculateGm (vector)", measure([&] {
+                return calculateGm(ids, vgs)[n / 2];
+            }, n), true },
+            { "calculateGm (span, SG)", measure([&] {
+                calculateGm(ids, vgs, out, arena);
+                return out[n / 2];
+            }, n) },
+            { "calculateGm (span, grid)", measure([&] {
+                calculateGm(ids, vgsIrregular, out, arena);
+                return out[n / 2];
+            }, n) },
+            { "calculateGm (span, MA)", measure([&] {
+                calculateGm(ids, vgs, out, arena, maConfig);
+                return out[n / 2];
+            }, n) },
+            { "calculateVt (vector)", measure([&] {
+                return calculateVt(gm, vgs, ids);
+            }, n), true },
+            { "calculateVt (span)", measure([&] {
+                return calculateVt(gm, vgs, ids, arena);
+            }, n) },
+            { "extractVt", measure([&] {
+                return extractVt(vgs, ids, gm).maxGm.vt;
+            }, n) },
+            { "extractVt (regions)", measure([&] {
+                return extractVt(vgs, ids, gm, regions).secondDerivative.vt;
+            }, n) },
+            { "segmentCurve", measure([&] {
+                return segmentCurve(vgs, ids, gm, arena).saturation;
+            }, n) },
+            { "calculateSS (vector)", measure([&] {
+                return calculateSS(ids, vgs).ss_mVdec;
+            }, n), true },
+            { "calculateSS (span)", measure([&] {
+                return calculateSS(ids, vgs, arena).ss_mVdec;
+            }, n) },
+            { "calculateSS (regions)", measure([&] {
+                return calculateSS(ids, vgs, regions, arena).ss_mVdec;
+            }, n) },
+            { "calculateSS (Theil-Sen)", measure([&] {
+                return calculateSS(ids, vgs, arena, theilSen).ss_mVdec;
+            }, n) },
+            { "calculateSS (RANSAC)", measure([&] {
+                return calculateSS(ids, vgs, arena, ransac).ss_mVdec;
+            }, n) },
+            { "CurveAnalyzer", measure([&] {
+                ScratchArena::Scope scope(arena);
+                CurveAnalyzer analyzer;
+                analyzer.begin(n, arena);
+                for (size_t i = 0; i < n; i++) analyzer.push(vgs[i], ids[i]);
+                return analyzer.finish().vt;
+            }, n) },
+            { "GoldenComparator", measure([&] {
+                GoldenComparator cmp;
+                cmp.begin(vgs, ids, GoldenTolerance(), vgs.front(), vgs.back());
+                for (size_t i = 0; i < n; i++) cmp.push(vgs[i], ids[i] * 1.01f);
+                return cmp.stats().rmse;
+            }, n) },
+            { "bootstrapCurve (16)", measure([&] {
+                return bootstrapCurve(vgs, ids, bootArena, bootConfig).ss.hi;
+            }, n) },
+            { "fitCompactModel", measure([&] {
+                return fitCompactModel(vgs, ids, 3.0f, 0.75f, 90.0f).vt;
+            }, n) },
+        };
+
+        const Measurement ssBaseline = measure([&] {
+            return baseline::calculateSS(ids, vgs).ss_mVdec;
+        }, n);
+        const SSResult ssOld = baseline::calculateSS(ids, vgs);
+        const SSResult ssNew = calculateSS(ids, vgs, arena);
+        const bool ssSame = ssOld.valid == ssNew.valid && ssOld.regionStart == ssNew.regionStart &&
+                            ssOld.regionEnd == ssNew.regionEnd &&
+                            fabsf(ssOld.ss_mVdec - ssNew.ss_mVdec) <= 1e-3f * fabsf(ssOld.ss_mVdec);
+        const char* ssVerdict = !ssOld.valid && !ssNew.valid ? "n/a, no SS window on either" : ssSame ? "yes" : "NO";
+
+        double ssSpan = 0.0;
+        for (const Row& r : rows) {
+            if (strcmp(r.name, "calculateSS (span)") == 0) ssSpan = r.m.nsPerPoint;
+        }
+
+        printf("%zu points\n", n);
+        for (const Row& r : rows) {
+            const bool bad = !r.allocates && r.m.allocs > 0;
+            printf("  %-24s %10.2f ns/pt  (%zu)%s\n", r.name, r.m.nsPerPoint, r.m.allocs,
+                   bad ? "  FAIL: allocates" : "");
+            failures += bad;
+        }
+        printf("  %-24s %10.2f ns/pt  (%zu)\n", "calculateSS (baseline)", ssBaseline.nsPerPoint, ssBaseline.allocs);
+        printf("  calculateSS speedup vs baseline: %.1fx per curve (%.1f -> %.1f us), same window: %s "
+               "(%.2f vs %.2f mV/dec)\n",
+               ssBaseline.nsPerPoint / ssSpan,
+               ssBaseline.nsPerPoint * n / 1000.0, ssSpan * n / 1000.0,
+               ssVerdict, ssOld.ss_mVdec, ssNew.ss_mVdec);
+        printf("\n");
+    }
+    fineStepSweeps();
+
+    if (failures) {
+        printf("%d span/arena call(s) allocated\n", failures);
+        return 1;
+    }
+    printf("span/arena overloads: no allocations\n");
+    return 0;
+}
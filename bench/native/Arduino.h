@@ -0,0 +1,34 @@
+#ifndef ARDUINO_SHIM_H
+#define ARDUINO_SHIM_H
+
+// ============================================================================
+// Arduino shim for the native (host) build
+// ============================================================================
+// Just the timing calls the benchmarks use, so they are written against
+// the same API as the firmware and can be run on the board unchanged.
+// math_engine itself has no Arduino dependency.
+// ============================================================================
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace arduino_shim {
+inline std::chrono::steady_clock::time_point start() {
+    static const auto t0 = std::chrono::steady_clock::now();
+    return t0;
+}
+} // namespace arduino_shim
+
+inline unsigned long micros() {
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - arduino_shim::start()).count());
+}
+
+inline unsigned long millis() { return micros() / 1000; }
+
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+inline void yield() { std::this_thread::yield(); }
+
+#endif // ARDUINO_SHIM_H
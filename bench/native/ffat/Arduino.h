@@ -0,0 +1,130 @@
+#ifndef ARDUINO_FFAT_SHIM_H
+#define ARDUINO_FFAT_SHIM_H
+
+// ============================================================================
+// Arduino shim for host checks of FFat-backed modules
+// ============================================================================
+// The slice of String, timing and FreeRTOS (tasks, task notifications,
+// mutexes) that AnalysisCache uses. Tasks are std::threads; the core and
+// priority arguments are ignored. Pair with FFat.h and log_buffer.h from
+// this directory, ahead of include/ on the include path.
+// ============================================================================
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    String(const std::string& s) : s_(s) {}
+    String(int v) : s_(std::to_string(v)) {}
+    String(unsigned v) : s_(std::to_string(v)) {}
+    String(long v) : s_(std::to_string(v)) {}
+    String(unsigned long v) : s_(std::to_string(v)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    size_t length() const { return s_.size(); }
+    char charAt(size_t i) const { return i < s_.size() ? s_[i] : 0; }
+    bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+    bool endsWith(const String& p) const {
+        return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+    }
+    int indexOf(char c) const { return found(s_.find(c)); }
+    int indexOf(const String& p) const { return found(s_.find(p.s_)); }
+    int lastIndexOf(char c) const { return found(s_.rfind(c)); }
+    String substring(size_t from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+    String substring(size_t from, size_t to) const {
+        return from < to && from < s_.size() ? String(s_.substr(from, to - from)) : String();
+    }
+
+    String& operator+=(const String& o) { s_ += o.s_; return *this; }
+    String& operator+=(char c) { s_ += c; return *this; }
+    friend String operator+(String a, const String& b) { return a += b; }
+    friend String operator+(String a, const char* b) { return a += String(b); }
+    bool operator==(const String& o) const { return s_ == o.s_; }
+    bool operator!=(const String& o) const { return s_ != o.s_; }
+    bool operator<(const String& o) const { return s_ < o.s_; }
+
+private:
+    static int found(size_t p) { return p == std::string::npos ? -1 : static_cast<int>(p); }
+    std::string s_;
+};
+
+inline unsigned long millis() {
+    static const auto t0 = std::chrono::steady_clock::now();
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+}
+
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// ---- FreeRTOS ---------------------------------------------------------------
+
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE        1
+#define pdFALSE       0
+#define pdPASS        1
+#define portMAX_DELAY 0xffffffffu
+
+namespace arduino_shim {
+/** A task: its thread and its notification count. */
+struct Task {
+    std::mutex              m;
+    std::condition_variable cv;
+    uint32_t                notified = 0;
+};
+
+inline Task*& currentTask() {
+    static thread_local Task* task = nullptr;
+    return task;
+}
+} // namespace arduino_shim
+
+typedef arduino_shim::Task* TaskHandle_t;
+typedef std::mutex*         SemaphoreHandle_t;
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*fn)(void*), const char*, uint32_t, void* param,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    arduino_shim::Task* task = new arduino_shim::Task;
+    if (handle) *handle = task;
+    std::thread([fn, param, task]() {
+        arduino_shim::currentTask() = task;
+        fn(param);
+    }).detach();
+    return pdPASS;
+}
+
+/** Only the portMAX_DELAY wait is modelled. */
+inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t) {
+    arduino_shim::Task* task = arduino_shim::currentTask();
+    std::unique_lock<std::mutex> lock(task->m);
+    task->cv.wait(lock, [task]() { return task->notified > 0; });
+    const uint32_t count = task->notified;
+    task->notified = clear ? 0 : count - 1;
+    return count;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> lock(task->m);
+        task->notified++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::mutex; }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t m, TickType_t) { m->lock(); return pdTRUE; }
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t m) { m->unlock(); return pdTRUE; }
+
+#endif // ARDUINO_FFAT_SHIM_H
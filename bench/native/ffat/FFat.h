@@ -0,0 +1,131 @@
+#pragma once
+
+// ============================================================================
+// FFat stand-in for host checks
+// ============================================================================
+// File and FFat calls mapped onto a host directory (FFat.root). Besides the
+// file system it can
+//   - report no modification time, as FAT without a set clock does (noMtime)
+//   - stall a task's (not the main thread's) opens of paths under
+//     `holdPrefix` while `hold` is set, to keep it in the middle of a job
+//   - count the bytes read from paths under `countPrefix` (bytesRead)
+// ============================================================================
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <cstdio>
+#include <dirent.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+class File {
+public:
+    explicit operator bool() const { return fp_ || isDir_; }
+
+    size_t size() const;
+    time_t getLastWrite() const;
+    const char* name() const { return path_.c_str(); }
+    bool isDirectory() const { return isDir_; }
+
+    int available() const { return fp_ ? static_cast<int>(size() - ftell(fp_.get())) : 0; }
+    size_t read(uint8_t* buf, size_t len);
+    size_t write(const uint8_t* buf, size_t len) { return fp_ ? fwrite(buf, 1, len, fp_.get()) : 0; }
+    String readStringUntil(char end);
+
+    File openNextFile();
+    void close() { fp_.reset(); isDir_ = false; }
+
+private:
+    friend class FFatFS;
+    std::string                path_;
+    std::shared_ptr<FILE>      fp_;
+    bool                       isDir_ = false;
+    bool                       counted_ = false;
+    std::vector<std::string>   entries_;
+    size_t                     next_ = 0;
+};
+
+class FFatFS {
+public:
+    std::string              root;
+    bool                     noMtime = false;
+    std::atomic<bool>        hold{false};
+    std::string              holdPrefix;
+    std::string              countPrefix;
+    std::atomic<size_t>      bytesRead{0};
+
+    std::string host(const std::string& path) const { return root + path; }
+
+    File open(const char* path, const char* mode = "r") {
+        if (arduino_shim::currentTask() && !holdPrefix.empty() &&
+            std::string(path).compare(0, holdPrefix.size(), holdPrefix) == 0) {
+            while (hold) delay(1);
+        }
+
+        File f;
+        f.path_ = path;
+        struct stat st;
+        if (stat(host(path).c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+            f.isDir_ = true;
+            if (DIR* d = opendir(host(path).c_str())) {
+                while (dirent* e = readdir(d)) {
+                    const std::string n = e->d_name;
+                    if (n != "." && n != "..") f.entries_.push_back(std::string(path) + "/" + n);
+                }
+                closedir(d);
+            }
+            return f;
+        }
+        if (FILE* fp = fopen(host(path).c_str(), mode[0] == 'w' ? "wb" : "rb")) f.fp_.reset(fp, fclose);
+        f.counted_ = !countPrefix.empty() && std::string(path).compare(0, countPrefix.size(), countPrefix) == 0;
+        return f;
+    }
+    File open(const String& path, const char* mode = "r") { return open(path.c_str(), mode); }
+
+    bool exists(const String& path) const {
+        struct stat st;
+        return stat(host(path.c_str()).c_str(), &st) == 0;
+    }
+    bool remove(const char* path) { return ::remove(host(path).c_str()) == 0; }
+    bool mkdir(const char* path) { return ::mkdir(host(path).c_str(), 0755) == 0; }
+    bool rename(const char* from, const char* to) {
+        return ::rename(host(from).c_str(), host(to).c_str()) == 0;
+    }
+};
+
+extern FFatFS FFat;
+
+inline size_t File::size() const {
+    struct stat st;
+    return stat(FFat.host(path_).c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+inline time_t File::getLastWrite() const {
+    struct stat st;
+    if (FFat.noMtime || stat(FFat.host(path_).c_str(), &st) != 0) return 0;
+    return st.st_mtime;
+}
+
+inline size_t File::read(uint8_t* buf, size_t len) {
+    const size_t n = fp_ ? fread(buf, 1, len, fp_.get()) : 0;
+    if (counted_) FFat.bytesRead += n;
+    return n;
+}
+
+inline String File::readStringUntil(char end) {
+    std::string line;
+    int c;
+    while (fp_ && (c = fgetc(fp_.get())) != EOF) {
+        if (counted_) FFat.bytesRead++;
+        if (c == end) break;
+        line += static_cast<char>(c);
+    }
+    return String(line);
+}
+
+inline File File::openNextFile() {
+    return next_ < entries_.size() ? FFat.open(entries_[next_++].c_str(), "r") : File();
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Host stand-in for include/log_buffer.h: warnings and errors go to stderr,
+// the rest is dropped.
+
+#include <cstdio>
+
+#define LOG_DEBUG(...) ((void)0)
+#define LOG_INFO(...)  ((void)0)
+#define LOG_WARN(...)  (fprintf(stderr, "W: " __VA_ARGS__), fputc('\n', stderr))
+#define LOG_ERROR(...) (fprintf(stderr, "E: " __VA_ARGS__), fputc('\n', stderr))
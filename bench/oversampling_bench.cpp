@@ -0,0 +1,218 @@
+// ============================================================================
+// Oversampling estimators — speed and accuracy on ADC noise traces
+// ============================================================================
+// Runs every hal::OversamplingMethod against the insertion sort + trimmed
+// mean the drivers used before, on consecutive windows of N raw codes taken
+// from a noise trace. Reported per trace and N:
+//   - time per reading (the estimator only, samples already in RAM)
+//   - RMS error of the reading against the trace's true level
+//   - whether the trimmed means match the insertion sort bit for bit
+//
+// Built-in traces model the converters of this board:
+//   internal   ESP32 12-bit ADC at mid-scale: σ = 6 LSB, 2% spikes of ±60–250 LSB
+//   ads1115    ADS1115 at ±0.256 V: σ = 2 LSB, rare I2C glitches (0.2%)
+//   settling   internal ADC sampled while the shunt still settles: a decaying
+//              step, i.e. descending codes (insertion sort's worst case);
+//              a timing case, the transient biases every estimator alike
+// A recorded trace replaces them: one raw code per line (e.g. readRaw()
+// printed over serial), with its true level taken as the trace median.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/oversampling_bench.cpp -o oversampling_bench
+//   ./oversampling_bench [trace.txt]
+// ============================================================================
+
+#include "oversampling.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace hal;
+
+namespace {
+
+struct Trace {
+    std::string           name;
+    std::vector<uint16_t> codes;
+    double                truth;  ///< Level the readings should report (LSB)
+};
+
+Trace internalTrace(size_t len) {
+    std::mt19937 rng(1);
+    std::normal_distribution<double> noise(0.0, 6.0);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    Trace t{"internal", {}, 2048.0};
+    for (size_t i = 0; i < len; i++) {
+        double v = t.truth + noise(rng);
+        if (u(rng) < 0.02) v += (u(rng) < 0.5 ? -1 : 1) * (60.0 + 190.0 * u(rng));
+        t.codes.push_back(static_cast<uint16_t>(std::min(4095.0, std::max(0.0, std::round(v)))));
+    }
+    return t;
+}
+
+Trace adsTrace(size_t len) {
+    std::mt19937 rng(2);
+    std::normal_distribution<double> noise(0.0, 2.0);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    Trace t{"ads1115", {}, 18000.0};
+    for (size_t i = 0; i < len; i++) {
+        double v = t.truth + noise(rng);
+        if (u(rng) < 0.002) v = (u(rng) < 0.5) ? 0.0 : 32767.0;  // Glitched read
+        t.codes.push_back(static_cast<uint16_t>(std::round(v)));
+    }
+    return t;
+}
+
+Trace settlingTrace(size_t len, uint16_t window) {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    Trace t{"settling", {}, 1500.0};
+    for (size_t i = 0; i < len; i++) {
+        const double k = static_cast<double>(i % window);
+        const double v = t.truth + 400.0 * std::exp(-k / (0.3 * window)) + noise(rng);
+        t.codes.push_back(static_cast<uint16_t>(std::round(v)));
+    }
+    return t;
+}
+
+bool loadTrace(const char* path, Trace& t) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    t.name = path;
+    long v;
+    while (fscanf(f, "%ld", &v) == 1) t.codes.push_back(static_cast<uint16_t>(std::min(65535L, std::max(0L, v))));
+    fclose(f);
+    if (t.codes.empty()) return false;
+    std::vector<uint16_t> sorted = t.codes;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    t.truth = sorted[sorted.size() / 2];
+    return true;
+}
+
+/** The former InternalADC/ExternalADC::readVoltage() reduction. */
+float legacyTrimmedMean(uint16_t* samples, uint16_t n) {
+    for (uint16_t i = 1; i < n; i++) {
+        uint16_t key = samples[i];
+        int16_t  j   = static_cast<int16_t>(i) - 1;
+        while (j >= 0 && samples[j] > key) { samples[j + 1] = samples[j]; j--; }
+        samples[j + 1] = key;
+    }
+    const uint16_t trim  = n / 10;
+    uint32_t sum = 0; uint16_t count = 0;
+    for (uint16_t i = trim; i < n - trim; i++) { sum += samples[i]; count++; }
+    if (count == 0) count = 1;
+    return static_cast<float>(sum) / count;
+}
+
+struct Row {
+    const char* name;
+    double      nsPerReading;
+    double      rmsError;
+    bool        exact;
+};
+
+template <typename Reduce>
+Row run(const char* name, const Trace& t, uint16_t n, const std::vector<float>& reference, Reduce reduce) {
+    const size_t readings = t.codes.size() / n;
+    uint16_t buf[OVERSAMPLING_MAX_SAMPLES];
+    std::vector<float> out(readings);
+
+    // Accuracy and agreement, one pass
+    for (size_t r = 0; r < readings; r++) {
+        std::memcpy(buf, &t.codes[r * n], n * sizeof(uint16_t));
+        out[r] = reduce(buf, n);
+    }
+    double sq = 0.0;
+    bool exact = true;
+    for (size_t r = 0; r < readings; r++) {
+        sq += (out[r] - t.truth) * (out[r] - t.truth);
+        if (!reference.empty() && out[r] != reference[r]) exact = false;
+    }
+
+    // Timing: the copy is the same for every method and is subtracted
+    const int reps = std::max<int>(1, static_cast<int>(4000000 / t.codes.size()));
+    volatile float sink = 0.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < reps; k++) {
+        for (size_t r = 0; r < readings; r++) {
+            std::memcpy(buf, &t.codes[r * n], n * sizeof(uint16_t));
+            sink = sink + reduce(buf, n);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int k = 0; k < reps; k++) {
+        for (size_t r = 0; r < readings; r++) {
+            std::memcpy(buf, &t.codes[r * n], n * sizeof(uint16_t));
+            sink = sink + buf[r % n];
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    const double work = std::chrono::duration<double, std::nano>((t1 - t0) - (t2 - t1)).count();
+
+    return { name, std::max(0.0, work) / (static_cast<double>(reps) * readings),
+             std::sqrt(sq / readings), exact };
+}
+
+void report(const Trace& t, uint16_t n) {
+    const size_t readings = t.codes.size() / n;
+    if (readings == 0) return;
+
+    std::vector<float> reference(readings);
+    uint16_t buf[OVERSAMPLING_MAX_SAMPLES];
+    for (size_t r = 0; r < readings; r++) {
+        std::memcpy(buf, &t.codes[r * n], n * sizeof(uint16_t));
+        reference[r] = legacyTrimmedMean(buf, n);
+    }
+    const std::vector<float> none;
+
+    const Row rows[] = {
+        run("insertion sort", t, n, none, legacyTrimmedMean),
+        run("trimmed (select)", t, n, reference, trimmedMeanSelect),
+        run("histogram (radix)", t, n, reference, trimmedMeanHistogram),
+        run("minmax (stream)", t, n, none, [](uint16_t* s, uint16_t m) {
+            return reduceSamples(OversamplingMethod::MinMaxReject, s, m);
+        }),
+    };
+    for (const Row& row : rows) {
+        printf("%-10s | %4u | %-18s | %10.1f | %9.3f | %s\n", t.name.c_str(), n, row.name,
+               row.nsPerReading, row.rmsError,
+               &row == &rows[0] ? "reference" : (&row == &rows[3] ? "-" : (row.exact ? "yes" : "NO")));
+    }
+    printf("-----------+------+--------------------+------------+-----------+----------\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint16_t counts[] = { 16, 64, 256 };
+    const size_t LEN = 256 * 256;
+
+    std::vector<Trace> traces;
+    if (argc > 1) {
+        Trace t;
+        if (!loadTrace(argv[1], t)) {
+            fprintf(stderr, "cannot read trace %s\n", argv[1]);
+            return 1;
+        }
+        traces.push_back(t);
+    } else {
+        traces.push_back(internalTrace(LEN));
+        traces.push_back(adsTrace(LEN));
+    }
+
+    printf("%-10s | %4s | %-18s | %10s | %9s | %s\n", "trace", "N", "estimator", "ns/reading", "RMS (LSB)", "= legacy");
+    printf("-----------+------+--------------------+------------+-----------+----------\n");
+    for (const Trace& t : traces) {
+        for (uint16_t n : counts) report(t, n);
+    }
+    if (argc <= 1) {
+        for (uint16_t n : counts) report(settlingTrace(LEN, n), n);
+    }
+    return 0;
+}
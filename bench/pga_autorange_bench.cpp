@@ -0,0 +1,146 @@
+// ============================================================================
+// ADS1115 PGA — fixed gains vs per-point auto-ranging on a transfer curve
+// ============================================================================
+// Reads a simulated Vgs sweep (leakage floor, subthreshold exponential, then
+// square law up to ~1.3 V of shunt voltage) through a model of the ADS1115:
+// codes clip at +32767 and carry σ = 1.5 LSB of noise at whatever range is
+// active. Each point takes 16 conversions reduced by the trimmed mean.
+// Auto-ranging runs the firmware's ExternalADC::readVoltage() logic on top of
+// hal::pgaNextRange(). Reported per mode:
+//   - points clipped (reading wrong) and conversions spent
+//   - RMS relative error below and above 10 mV of shunt voltage
+//   - range changes between points and re-reads after clipping
+// Two more passes: a reading held at a range boundary with noise, where the
+// hysteresis must keep the range from flapping, and a jump of three decades,
+// where the clipped reading is repeated wider instead of being recorded.
+//
+// Host build, from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/pga_autorange_bench.cpp -o pga_autorange_bench
+// ============================================================================
+
+#include "oversampling.h"
+#include "pga_autorange.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace hal;
+
+namespace {
+
+const int      POINTS    = 301;   // Vgs 0..3 V in 10 mV steps
+const uint16_t N         = 16;
+const double   NOISE_LSB = 1.5;
+const uint16_t MAX_RAW   = 32767;
+
+double shuntVolts(double vg) {
+    const double vt = 1.2, n = 1.5, ut = 0.0259, k = 0.4, leak = 300e-6;
+    return leak + ((vg < vt) ? 1e-3 * std::exp((vg - vt) / (n * ut)) : 1e-3 + k * (vg - vt) * (vg - vt));
+}
+
+class MockAds {
+public:
+    explicit MockAds(uint32_t seed) : rng_(seed), noise_(0.0, NOISE_LSB) {}
+
+    /** One reading of `volts` at range `index`: N conversions, trimmed mean. */
+    float read(double volts, uint8_t index, bool& clipped) {
+        const double lsb = PGA_RANGES[index].fsr / MAX_RAW;
+        uint16_t s[N];
+        clipped = false;
+        for (uint16_t i = 0; i < N; i++) {
+            const double code = std::round(volts / lsb + noise_(rng_));
+            s[i] = static_cast<uint16_t>(std::min<double>(MAX_RAW, std::max(0.0, code)));
+            if (s[i] >= MAX_RAW) clipped = true;
+        }
+        conversions += N;
+        return static_cast<float>(trimmedMeanSelect(s, N) * lsb);
+    }
+
+    uint32_t conversions = 0;
+
+private:
+    std::mt19937 rng_;
+    std::normal_distribution<double> noise_;
+};
+
+struct Result {
+    int      clipped  = 0;
+    uint32_t conversions = 0;
+    double   errSub   = 0.0, errAbove = 0.0;
+    int      nSub     = 0,   nAbove   = 0;
+    int      switches = 0,   rereads  = 0;
+};
+
+/** Sweep at a fixed range (`autoRange` false) or auto-ranging from `index`. */
+Result sweep(uint8_t index, bool autoRange, double (*curve)(int)) {
+    MockAds ads(11);
+    Result r;
+    uint8_t lastRow = index;
+    for (int p = 0; p < POINTS; p++) {
+        const double truth = curve(p);
+        bool  clipped = false;
+        float v = ads.read(truth, index, clipped);
+        if (autoRange) {
+            while (clipped && index > 0) {
+                index--;
+                r.rereads++;
+                v = ads.read(truth, index, clipped);
+            }
+        }
+        if (p > 0 && index != lastRow) r.switches++;
+        lastRow = index;
+        if (autoRange) index = pgaNextRange(index, v, clipped);
+
+        if (clipped) { r.clipped++; continue; }
+        const double rel = (v - truth) / truth;
+        if (truth < 0.010) { r.errSub += rel * rel; r.nSub++; }
+        else               { r.errAbove += rel * rel; r.nAbove++; }
+    }
+    r.conversions = ads.conversions;
+    r.errSub   = r.nSub   ? std::sqrt(r.errSub / r.nSub) : 0.0;
+    r.errAbove = r.nAbove ? std::sqrt(r.errAbove / r.nAbove) : 0.0;
+    return r;
+}
+
+double transferCurve(int p) { return shuntVolts(p * 0.01); }
+
+/** Jump of three decades mid-sweep: the first reading after it clips. */
+double stepCurve(int p) { return p < POINTS / 2 ? 1e-3 : 1.0; }
+
+/** Shunt voltage hovering around the ±0.512/±0.256 V boundary (0.8 × 0.256 V). */
+double boundaryCurve(int p) { return 0.2048 * (1.0 + 0.03 * std::sin(p * 0.7)); }
+
+void report(const char* name, const Result& r) {
+    printf("%-16s | %7d | %11u | %9.3f | %9.3f | %8d | %7d\n", name, r.clipped, (unsigned)r.conversions,
+           r.errSub * 100.0, r.errAbove * 100.0, r.switches, r.rereads);
+}
+
+void header(const char* title) {
+    printf("%s\n", title);
+    printf("%-16s | %7s | %11s | %9s | %9s | %8s | %7s\n",
+           "mode", "clipped", "conversions", "sub err %", "above %", "switches", "rereads");
+    printf("-----------------+---------+-------------+-----------+-----------+----------+--------\n");
+}
+
+} // namespace
+
+int main() {
+    header("Transfer curve, 301 points, 16 conversions each");
+    report("fixed 0.256 V", sweep(pgaRangeIndex(16), false, transferCurve));
+    report("fixed 2.048 V", sweep(pgaRangeIndex(2), false, transferCurve));
+    report("auto (from 16)", sweep(pgaRangeIndex(16), true, transferCurve));
+    report("auto (from 2)", sweep(pgaRangeIndex(2), true, transferCurve));
+
+    printf("\n");
+    header("Reading held at a range boundary ±3%");
+    report("auto (from 16)", sweep(pgaRangeIndex(16), true, boundaryCurve));
+    report("auto (from 8)", sweep(pgaRangeIndex(8), true, boundaryCurve));
+
+    printf("\n");
+    header("Step from 1 mV to 1 V at point 150");
+    report("fixed 2.048 V", sweep(pgaRangeIndex(2), false, stepCurve));
+    report("auto (from 16)", sweep(pgaRangeIndex(16), true, stepCurve));
+    return 0;
+}
@@ -0,0 +1,181 @@
+// ============================================================================
+// Regression numerics — accuracy vs speed
+// ============================================================================
+// Runs the SS window search (BasicSSScanner) with every numerics policy on
+// synthetic subthreshold curves and reports, per policy:
+//   - same window: worst |ΔSS| when refitting the window the double
+//     reference picked — the accuracy of the arithmetic itself
+//   - search: worst and mean |ΔSS| of the full search, which also counts
+//     curves where a near-tie in R² made the policy pick another window
+//   - curves whose SS validity differs from the reference
+//   - share of curves within the 0.1 mV/dec budget
+//   - time per curve
+//
+// Host build (math_engine has no Arduino dependency), from the repo root:
+//   g++ -std=gnu++17 -O2 -Iinclude bench/regression_numerics_bench.cpp src/math_engine.cpp src/dsp_kernels.cpp -o regression_numerics_bench
+//
+// Host timings only rank the policies loosely: a desktop FPU runs double at
+// full speed, while the ESP32 emulates every double operation in software.
+// Accuracy figures carry over to the target unchanged.
+// ============================================================================
+
+#include "math_engine.h"
+#include "ekv_curve.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace math_engine;
+
+namespace {
+
+const float SS_BUDGET_MV = 0.1f;  // Largest acceptable SS deviation (mV/dec)
+
+struct Curve {
+    std::vector<float> vgs;
+    std::vector<float> ids;
+};
+
+Curve makeCurve(float vmax, float step, float vt, float ssTarget, float noise, unsigned seed) {
+    EkvParams p;
+    p.vt       = vt;
+    p.ssTarget = ssTarget;
+    p.step     = step;
+    p.points   = static_cast<size_t>(vmax / step) + 1;
+    p.noise    = noise;
+    p.seed     = seed;
+
+    Curve c;
+    makeTransferCurve(p, c.vgs, c.ids);
+    return c;
+}
+
+template <class Numerics>
+SSResult runScanner(const Curve& c, ScratchArena& arena) {
+    ScratchArena::Scope scope(arena);
+    BasicSSScanner<Numerics> scanner;
+    if (!scanner.begin(c.ids.size(), arena)) return SSResult();
+    for (size_t i = 0; i < c.ids.size(); i++) scanner.push(c.vgs[i], c.ids[i]);
+    return scanner.finish();
+}
+
+/** SS from refitting window [start, end] of the scanner's log10(Ids) data. */
+template <class Numerics>
+float refitWindow(const Curve& c, size_t start, size_t end, ScratchArena& arena) {
+    ScratchArena::Scope scope(arena);
+    const size_t n = c.ids.size();
+    FloatSpan     logIds = arena.alloc<float>(n);
+    Span<uint8_t> usable = arena.alloc<uint8_t>(n);
+    for (size_t i = 0; i < n; i++) {
+        // 3-point mean, summed in the scanner's order
+        float sum = 0;
+        int   cnt = 0;
+        if (i >= 1) { sum += c.ids[i - 1]; cnt++; }
+        sum += c.ids[i];
+        cnt++;
+        if (i + 1 < n) { sum += c.ids[i + 1]; cnt++; }
+        const float v = fabsf(sum / cnt);
+        usable[i] = v > 1e-13f;
+        logIds[i] = usable[i] ? log10f(v) : 0.0f;
+    }
+
+    BasicWindowedRegression<Numerics> reg;
+    if (!reg.build(c.vgs, logIds, usable, arena)) return 0.0f;
+    float slope, intercept;
+    reg.fit(start, end + 1, slope, intercept);
+    return slope > 0 ? 1000.0f / slope : 0.0f;
+}
+
+struct Stats {
+    double worst = 0, sum = 0, worstSame = 0, nanos = 0;
+    size_t compared = 0, within = 0, validityMismatch = 0;
+};
+
+template <class Numerics>
+void evaluate(const std::vector<Curve>& curves, const std::vector<SSResult>& reference,
+              ScratchArena& arena, int repeats) {
+    Stats st;
+    for (size_t k = 0; k < curves.size(); k++) {
+        const SSResult r = runScanner<Numerics>(curves[k], arena);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < repeats; rep++) {
+            volatile float sink = runScanner<Numerics>(curves[k], arena).ss_mVdec;
+            (void)sink;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        st.nanos += std::chrono::duration<double, std::nano>(t1 - t0).count() / repeats;
+
+        if (reference[k].valid) {
+            const float ss = refitWindow<Numerics>(curves[k], reference[k].regionStart,
+                                                   reference[k].regionEnd, arena);
+            const double d = fabs(ss - reference[k].ss_mVdec);
+            if (d > st.worstSame) st.worstSame = d;
+        }
+
+        if (r.valid != reference[k].valid) {
+            st.validityMismatch++;
+            continue;
+        }
+        if (!r.valid) continue;
+        const double d = fabs(r.ss_mVdec - reference[k].ss_mVdec);
+        st.compared++;
+        st.sum += d;
+        if (d > st.worst) st.worst = d;
+        if (d <= SS_BUDGET_MV) st.within++;
+    }
+
+    printf("%-18s | %9.4f | %9.4f | %9.5f | %8zu | %7.2f%% | %9.1f\n",
+           Numerics::name(), st.worstSame, st.worst, st.compared ? st.sum / st.compared : 0.0,
+           st.validityMismatch, st.compared ? 100.0 * st.within / st.compared : 0.0,
+           st.nanos / curves.size() / 1000.0);
+}
+
+} // namespace
+
+int main() {
+    // Sweep grid: VGS step, SS, noise and threshold placement
+    const float steps[]  = { 0.001f, 0.005f, 0.010f, 0.025f };
+    const float ssList[] = { 65.0f, 80.0f, 100.0f, 150.0f, 250.0f };
+    const float noises[] = { 0.0f, 0.005f, 0.02f };
+
+    std::vector<Curve> curves;
+    unsigned seed = 1;
+    for (float step : steps) {
+        for (float ss : ssList) {
+            for (float noise : noises) {
+                for (int v = 0; v < 4; v++) {
+                    const float vmax = (step <= 0.001f) ? 1.5f : 3.0f;
+                    curves.push_back(makeCurve(vmax, step, 0.4f + 0.15f * v, ss, noise, seed++));
+                }
+            }
+        }
+    }
+
+    size_t longest = 0;
+    for (const Curve& c : curves) longest = std::max(longest, c.ids.size());
+    ScratchArena arena(scratchBytes(longest));
+
+    std::vector<SSResult> reference;
+    size_t valid = 0;
+    for (const Curve& c : curves) {
+        reference.push_back(runScanner<numerics::Double>(c, arena));
+        if (reference.back().valid) valid++;
+    }
+
+    printf("%zu synthetic curves (%zu with a valid SS), up to %zu points, budget %.2f mV/dec\n\n",
+           curves.size(), valid, longest, SS_BUDGET_MV);
+    printf("%-18s | %9s | %9s | %9s | %8s | %8s | %9s\n",
+           "", "same win.", "search", "search", "", "", "");
+    printf("%-18s | %9s | %9s | %9s | %8s | %8s | %9s\n",
+           "policy", "max dSS", "max dSS", "mean dSS", "validity", "in budg.", "us/curve");
+    printf("-------------------+-----------+-----------+-----------+----------+----------+----------\n");
+
+    const int repeats = 5;
+    evaluate<numerics::Double>(curves, reference, arena, repeats);
+    evaluate<numerics::CompensatedFloat>(curves, reference, arena, repeats);
+    evaluate<numerics::Fixed<16>>(curves, reference, arena, repeats);
+    return 0;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+// ============================================================================
+// AnalysisCache — per-file transfer-curve analysis results on FFat
+// ============================================================================
+// Re-analysing a stored run means reading and parsing the whole CSV again,
+// and every change of smoothing parameters starts from scratch. The cache
+// keeps one compact binary block per (file content, analysis parameters) in
+// /cache:
+//
+//   /cache/<file CRC-32>_<parameter hash>.bin   header + one record per curve
+//   /cache/<measurement name>.crc               size, mtime and CRC of a file
+//
+// The .crc memo lets a repeated request find its block without reading the
+// raw data: only a file whose size or modification time changed is hashed
+// again (always, when the file system reports no modification time). Blocks
+// are keyed by content, so a copy of a run under another name shares them.
+// At most MAX_BLOCKS blocks are kept; the oldest is dropped to make room.
+//
+// request() is safe to call from the web server task: it only reads the
+// memo and the block. Hashing, parsing and analysis run on a worker task
+// (Core 0, below the live analysis) and the caller asks again for the result.
+// ============================================================================
+
+#include <Arduino.h>
+#include <vector>
+#include "math_engine.h"
+
+// ----------------------------------------------------------------------------
+// AnalysisParams — what a cached result depends on besides the file
+// ----------------------------------------------------------------------------
+struct AnalysisParams {
+    math_engine::GmConfig gm;                                               ///< Gm smoothing
+    float                 vtCurrent = 1e-5f;                                ///< Constant-current Vt criterion (A)
+    math_engine::SSMethod ssMethod  = math_engine::SSMethod::SlidingWindow; ///< SS estimator
+
+    /** FNV-1a over every field and AnalysisCache::FORMAT_VERSION. */
+    uint32_t hash() const;
+};
+
+// ----------------------------------------------------------------------------
+// CachedCurve — one curve of a block, stored as-is in the .bin file
+// ----------------------------------------------------------------------------
+struct CachedCurve {
+    float    vds;                ///< Drain voltage of the curve (V)
+    uint32_t points;             ///< Samples in the curve
+    float    vt;                 ///< Max-Gm extrapolated Vt (V), as on the "# VDS=" line
+    float    ss;                 ///< Subthreshold swing (mV/dec); 0 = not found
+    float    maxGm;              ///< Peak transconductance (S)
+    float    vtSecondDerivative; ///< Vt by each VtResult method (V); 0 = not found
+    float    vtConstantCurrent;
+    float    vtYFunction;
+    float    ssX1, ssY1;         ///< SS tangent in (VGS, log10 Ids), for the chart
+    float    ssX2, ssY2;
+};
+
+struct AnalysisBlock {
+    uint32_t                 fileCrc    = 0;
+    uint32_t                 paramsHash = 0;
+    std::vector<CachedCurve> curves;
+};
+
+// ============================================================================
+// AnalysisCache
+// ============================================================================
+class AnalysisCache {
+public:
+    static const char* CACHE_DIR;                   ///< "/cache"
+    static const uint16_t FORMAT_VERSION = 1;       ///< Bump when analysis or record layout changes
+    static const int      MAX_BLOCKS     = 64;      ///< Blocks kept before the oldest is evicted
+    static constexpr float VDS_TOLERANCE = 0.015f;  ///< A VDS change beyond this starts a new curve
+
+    /** Outcome of request(). */
+    enum class Lookup : uint8_t {
+        Ready,    ///< `block` holds the analysis
+        Pending,  ///< Queued or running on the worker; ask again
+        Busy,     ///< The worker is on another request; ask again
+        Failed    ///< File missing, invalid or not a transfer sweep
+    };
+
+    /**
+     * @brief Create the /cache directory if absent and start the worker task
+     *
+     * FFat must already be mounted. Without the worker, request() analyses
+     * on the calling task.
+     */
+    static bool init();
+
+    /**
+     * @brief Analysis of a stored SWEEP_VGS measurement under `params`, without blocking
+     *
+     * Answers from the block when the file's memo is current. Otherwise the
+     * request goes to the worker, which runs get(); once it is done, the
+     * next call with the same arguments returns Ready.
+     *
+     * @param fromCache Set to true if the block was stored before this request
+     */
+    static Lookup request(const String& filename, const AnalysisParams& params,
+                          AnalysisBlock& block, bool& fromCache);
+
+    /**
+     * @brief Blocking analysis: hashes the file if needed, then reads or builds its block
+     *
+     * Parses the CSV and runs math_engine::CurveAnalyzer over every curve on
+     * a miss, storing the block for the next request. Runs on the worker;
+     * call it directly only off the web server task.
+     *
+     * @param fromCache Set to true if the block was read from the cache
+     * @return false if the file is missing, invalid or not a transfer sweep
+     */
+    static bool get(const String& filename, const AnalysisParams& params,
+                    AnalysisBlock& block, bool& fromCache);
+
+    /** Drop the CRC memo of a deleted measurement and every block of its content. */
+    static void forget(const String& filename);
+
+    /** Delete every block and memo. */
+    static void clear();
+
+private:
+    static String memoPath(const String& filename);
+    static String blockPath(uint32_t fileCrc, uint32_t paramsHash);
+
+    /** CRC-32 of a measurement from its memo; false unless size and a non-zero mtime still match. */
+    static bool memoCrc(const String& filename, uint32_t& crc);
+    /** CRC-32 of a measurement, from its memo or by reading the whole file. */
+    static bool fileCrc(const String& filename, uint32_t& crc);
+    /** Read the block of (fileCrc, paramsHash) if it is stored and intact. */
+    static bool loadBlock(uint32_t fileCrc, uint32_t paramsHash, AnalysisBlock& block);
+    static bool readBlock(const String& path, AnalysisBlock& block);
+    static bool analyse(const String& filename, const AnalysisParams& params, AnalysisBlock& block);
+    static void writeBlock(const String& path, const AnalysisBlock& block);
+    /** Remove the oldest blocks until fewer than MAX_BLOCKS remain. */
+    static void evict();
+    /** Worker task: runs get() for the queued request. */
+    static void workerTask(void* param);
+};
@@ -0,0 +1,96 @@
+#ifndef CONVERSION_SOURCE_H
+#define CONVERSION_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Continuous-conversion acquisition
+// ============================================================================
+// A single-shot ADC read configures the converter, starts one conversion
+// and polls the bus until it completes, for every sample. In continuous
+// mode the converter free-runs at its data rate and signals each finished
+// conversion (ADS1115: the ALERT/RDY pin); the reader sleeps until the
+// signal and then only fetches the result.
+//
+// IConversionSource abstracts that signal so acquireContinuous() runs
+// unchanged against the ADS1115 (hal::AdsReadySource) and against a host
+// mock that reproduces the conversion timing (bench/ads_continuous_bench.cpp).
+// No Arduino or FreeRTOS dependency here.
+// ============================================================================
+
+namespace hal {
+
+class IConversionSource {
+public:
+    virtual ~IConversionSource() = default;
+
+    /** Start free-running conversions. Returns false if the converter did not accept it. */
+    virtual bool     start() = 0;
+    /** Stop conversions (back to power-down single-shot). */
+    virtual void     stop() = 0;
+    /**
+     * @brief Sleep until a conversion completes.
+     * @return Conversions completed since the previous call (more than 1
+     *         means results were overwritten before they were read); 0 on timeout
+     */
+    virtual uint32_t waitReady(uint32_t timeoutUs) = 0;
+    /** Result of the latest completed conversion. */
+    virtual int16_t  readConversion() = 0;
+    /** Nominal time between conversions (µs). */
+    virtual uint32_t conversionUs() const = 0;
+};
+
+struct ContinuousStats {
+    uint32_t samples  = 0;  ///< Results captured
+    uint32_t missed   = 0;  ///< Conversions overwritten before they were read
+    uint32_t timeouts = 0;  ///< Ready signals that never came
+};
+
+/**
+ * @brief Capture `n` consecutive conversions into `ring`
+ *
+ * One start, then per sample one wait for the ready signal and one result
+ * read, then one stop. Negative results are clamped to 0 (0 V floor), as in
+ * the single-shot path. A missing ready signal (4 conversion periods)
+ * ends the capture early.
+ *
+ * @param done Called with each captured code; returning true ends the
+ *             capture there (sequential oversampling)
+ * @return Samples captured; n unless the ready signal timed out or `done` stopped it
+ */
+template <typename Done>
+inline uint16_t acquireContinuous(IConversionSource& source, uint16_t* ring, uint16_t n,
+                                  ContinuousStats* stats, Done done) {
+    ContinuousStats local;
+    ContinuousStats& s = stats ? *stats : local;
+    if (n == 0 || !source.start()) return 0;
+
+    const uint32_t timeoutUs = 4 * source.conversionUs();
+    uint16_t count = 0;
+    while (count < n) {
+        const uint32_t ready = source.waitReady(timeoutUs);
+        if (ready == 0) {
+            s.timeouts++;
+            break;
+        }
+        s.missed += ready - 1;
+
+        const int16_t raw = source.readConversion();
+        ring[count] = (raw < 0) ? 0 : static_cast<uint16_t>(raw);
+        if (done(ring[count++])) break;
+    }
+    source.stop();
+
+    s.samples += count;
+    return count;
+}
+
+inline uint16_t acquireContinuous(IConversionSource& source, uint16_t* ring, uint16_t n,
+                                  ContinuousStats* stats = nullptr) {
+    return acquireContinuous(source, ring, n, stats, [](uint16_t) { return false; });
+}
+
+} // namespace hal
+
+#endif // CONVERSION_SOURCE_H
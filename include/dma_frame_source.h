@@ -0,0 +1,176 @@
+#ifndef DMA_FRAME_SOURCE_H
+#define DMA_FRAME_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// DMA-backed ADC acquisition
+// ============================================================================
+// The ESP32 continuous ADC driver samples at a fixed rate into DMA buffers
+// and hands them over a frame at a time (one interrupt per frame); the task
+// blocks on the driver between frames instead of running one analogRead()
+// per sample. Each frame holds 2-byte words, little-endian, ESP32 TYPE1
+// layout: channel in bits 15..12, 12-bit code in bits 11..0.
+//
+// acquireDmaWindow() starts and stops the driver around each point;
+// acquireDmaStream() reads from a driver left running for a whole curve.
+// IDmaFrameSource abstracts the driver so both run unchanged on the ESP32
+// (hal::AdcDmaSource) and against a host mock that reproduces frame timing
+// and the driver's leftovers (bench/adc_dma_bench.cpp).
+// No Arduino or ESP-IDF dependency here.
+// ============================================================================
+
+namespace hal {
+
+const size_t  DMA_WORD_BYTES      = 2;    ///< One TYPE1 word per conversion
+const size_t  DMA_FRAME_MAX_BYTES = 512;  ///< Largest frame the readers accept (256 codes)
+const uint8_t DMA_WARMUP_FRAMES   = 1;    ///< Frames acquireDmaWindow() drops after start (may hold the previous run)
+
+inline uint8_t  dmaWordChannel(uint16_t word) { return static_cast<uint8_t>(word >> 12); }
+inline uint16_t dmaWordCode(uint16_t word)    { return word & 0x0FFF; }
+
+class IDmaFrameSource {
+public:
+    virtual ~IDmaFrameSource() = default;
+
+    /** Start sampling. Returns false if the driver refused. */
+    virtual bool     start() = 0;
+    /** Stop sampling; frames already converted stay queued. */
+    virtual void     stop() = 0;
+    /**
+     * @brief Copy the next queued frame into `buf`, waiting up to `timeoutMs`.
+     * @param overrun Set when the driver reports it dropped frames
+     * @return Bytes copied; 0 on timeout
+     */
+    virtual size_t   readFrame(uint8_t* buf, size_t maxBytes, uint32_t timeoutMs, bool& overrun) = 0;
+    /** Bytes per frame. */
+    virtual size_t   frameBytes() const = 0;
+    /** Conversions per second. */
+    virtual uint32_t sampleRateHz() const = 0;
+};
+
+struct DmaStats {
+    uint32_t samples  = 0;  ///< Codes delivered to windows
+    uint32_t frames   = 0;  ///< Frames the codes came from
+    uint32_t stale    = 0;  ///< Leftover and warm-up frames discarded
+    uint32_t foreign  = 0;  ///< Words tagged with another channel, dropped
+    uint32_t overruns = 0;  ///< Frames read while the driver reported dropped frames
+    uint32_t timeouts = 0;  ///< Frames that never came
+};
+
+namespace detail {
+
+/** Decode whole frames into `window` until it holds `n` codes; the first `skip` frames are dropped. */
+template <typename Done>
+inline uint16_t readDmaFrames(IDmaFrameSource& source, uint8_t channel, uint16_t* window, uint16_t n,
+                              uint8_t skip, bool countOverruns, DmaStats& s, Done done) {
+    uint8_t frame[DMA_FRAME_MAX_BYTES];
+    size_t  bytes = source.frameBytes();
+    if (bytes > DMA_FRAME_MAX_BYTES) bytes = DMA_FRAME_MAX_BYTES;
+    bool overrun = false;
+
+    const uint32_t frameMs   = 1 + static_cast<uint32_t>(bytes / DMA_WORD_BYTES * 1000 / source.sampleRateHz());
+    const uint32_t timeoutMs = 4 * frameMs;
+    uint16_t count   = 0;
+    bool     stopped = false;
+    while (count < n && !stopped) {
+        const size_t len = source.readFrame(frame, bytes, timeoutMs, overrun);
+        if (len == 0) {
+            s.timeouts++;
+            break;
+        }
+        if (overrun && countOverruns) s.overruns++;
+        if (skip > 0) {
+            skip--;
+            s.stale++;
+            continue;
+        }
+        s.frames++;
+        for (size_t i = 0; i + 1 < len && count < n && !stopped; i += DMA_WORD_BYTES) {
+            const uint16_t word = static_cast<uint16_t>(frame[i] | (frame[i + 1] << 8));
+            if (dmaWordChannel(word) != channel) {
+                s.foreign++;
+                continue;
+            }
+            window[count] = dmaWordCode(word);
+            stopped = done(window[count++]);
+        }
+    }
+    s.samples += count;
+    return count;
+}
+
+/** Discard every frame already queued. */
+inline void drainDmaFrames(IDmaFrameSource& source, DmaStats& s) {
+    uint8_t frame[DMA_FRAME_MAX_BYTES];
+    size_t  bytes = source.frameBytes();
+    if (bytes > DMA_FRAME_MAX_BYTES) bytes = DMA_FRAME_MAX_BYTES;
+    bool overrun = false;
+    while (source.readFrame(frame, bytes, 0, overrun) > 0) s.stale++;
+}
+
+} // namespace detail
+
+/**
+ * @brief Sample one window of `n` consecutive codes of `channel`
+ *
+ * Frames still queued from the previous window are discarded, sampling
+ * starts, the warm-up frame is dropped, and whole frames are decoded until
+ * the window is full; the rest of the last frame is dropped and sampling
+ * stops, so nothing runs between points. A frame missing for 4 frame
+ * periods ends the window early.
+ *
+ * @param done Called with each captured code; returning true ends the
+ *             window there (sequential oversampling)
+ * @return Codes captured; n unless the driver timed out or `done` stopped it
+ */
+template <typename Done>
+inline uint16_t acquireDmaWindow(IDmaFrameSource& source, uint8_t channel, uint16_t* window, uint16_t n,
+                                 DmaStats* stats, Done done) {
+    DmaStats local;
+    DmaStats& s = stats ? *stats : local;
+    if (n == 0) return 0;
+
+    detail::drainDmaFrames(source, s);
+    if (!source.start()) return 0;
+    const uint16_t count = detail::readDmaFrames(source, channel, window, n, DMA_WARMUP_FRAMES, true, s, done);
+    source.stop();
+    return count;
+}
+
+inline uint16_t acquireDmaWindow(IDmaFrameSource& source, uint8_t channel, uint16_t* window, uint16_t n,
+                                 DmaStats* stats = nullptr) {
+    return acquireDmaWindow(source, channel, window, n, stats, [](uint16_t) { return false; });
+}
+
+/**
+ * @brief Sample one window of `n` codes from a source left running for a whole curve
+ *
+ * No start, stop or warm-up frame: frames queued since the previous window
+ * (converted while the point settled) are discarded and the next frames are
+ * decoded. The first of them was already being converted when the call
+ * came, up to one frame period earlier; `keepInFlight` keeps it, for
+ * callers whose settling time covers that period, otherwise it is dropped.
+ * The driver overflowing its ring buffer between windows only loses frames
+ * that would be discarded, so overruns are not counted.
+ */
+template <typename Done>
+inline uint16_t acquireDmaStream(IDmaFrameSource& source, uint8_t channel, uint16_t* window, uint16_t n,
+                                 bool keepInFlight, DmaStats* stats, Done done) {
+    DmaStats local;
+    DmaStats& s = stats ? *stats : local;
+    if (n == 0) return 0;
+
+    detail::drainDmaFrames(source, s);
+    return detail::readDmaFrames(source, channel, window, n, keepInFlight ? 0 : 1, false, s, done);
+}
+
+inline uint16_t acquireDmaStream(IDmaFrameSource& source, uint8_t channel, uint16_t* window, uint16_t n,
+                                 bool keepInFlight, DmaStats* stats = nullptr) {
+    return acquireDmaStream(source, channel, window, n, keepInFlight, stats, [](uint16_t) { return false; });
+}
+
+} // namespace hal
+
+#endif // DMA_FRAME_SOURCE_H
@@ -0,0 +1,63 @@
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <cstddef>
+
+// ============================================================================
+// DSP kernels — inner loops shared by the math engine
+// ============================================================================
+// Every hot loop in the analysis path reduces to one of these:
+//
+//   dot()         Σ a[k]·b[k] (multiply-accumulate reduction)
+//   correlate()   dot() of the taps with every full window of a signal; the
+//                 SG interior convolution, with no index clamping — edges
+//                 are the caller's business
+//   scale()       out[i] = in[i]·c
+//   runningMean() centred moving average from a sliding sum, O(n) in the
+//                 window size
+//
+// On the ESP32, when the esp-dsp component is on the include path, dot(),
+// correlate() and scale() call dsps_dotprod_f32, dsps_corr_f32 and
+// dsps_mulc_f32 (the AE32 assembly versions). Everywhere else, or when
+// built with -DMATH_ENGINE_ESP_DSP=0, the portable loops below are used;
+// they accumulate in the same order as esp-dsp's ANSI reference code.
+// bench/dsp_kernels_check.cpp bit-compares them against that reference.
+// ============================================================================
+
+namespace math_engine {
+namespace kernels {
+
+/** Name of the compiled-in backend: "esp-dsp" or "portable". */
+const char* backend();
+
+/** Σ a[k]·b[k] for k < n, accumulated from k = 0 upwards. */
+float dot(const float* a, const float* b, size_t n);
+
+/**
+ * @brief Valid-mode correlation: out[i] = dot(in + i, taps, taps_n)
+ *
+ * Writes n - taps_n + 1 outputs; nothing when n < taps_n. A single-output
+ * call produces exactly the value of the matching full call, so streaming
+ * and batch users of the same taps agree bit for bit on every backend.
+ */
+void correlate(const float* in, size_t n, const float* taps, size_t taps_n, float* out);
+
+/** out[i] = in[i] · c for i < n; in and out may be the same buffer. */
+void scale(const float* in, float* out, size_t n, float c);
+
+/**
+ * @brief Centred moving average, shrinking at the edges
+ *
+ * out[i] is the mean of in[i - window/2 .. i + window/2] clipped to the
+ * data, matching the windowed mean it replaces. The sliding sum is
+ * Neumaier-compensated, so rounding does not build up along long curves.
+ * in and out must not alias.
+ *
+ * @param window Odd window size (>= 1)
+ */
+void runningMean(const float* in, float* out, size_t n, size_t window);
+
+} // namespace kernels
+} // namespace math_engine
+
+#endif // DSP_KERNELS_H
@@ -110,6 +110,20 @@ public:
 
     static const char* MEASUREMENTS_DIR; ///< "/measurements"
 
+    /**
+     * @brief Parse one line of a saved measurement.
+     *
+     * Data rows are "timestamp,vd,vg,vsh,ids,samples,fsr"; files saved before
+     * the samples and fsr columns end at ids and parse the same way.
+     *
+     * @return false for comments, blank lines, the column header and
+     *         malformed rows; vds/vgs/ids are only written on true.
+     */
+    static bool parseDataRow(const String& line, float& vds, float& vgs, float& ids);
+
+    /** True for the "# Sweep Mode:" comment of an output (VDS) sweep. */
+    static bool isOutputSweepHeader(const String& line);
+
     /** Snapshot of FFat partition usage. */
     static StorageInfo getStorageInfo();
 
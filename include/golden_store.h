@@ -0,0 +1,88 @@
+#pragma once
+
+// ============================================================================
+// GoldenStore — reference transfer-curve families on FFat
+// ============================================================================
+// One file per part number in /golden, holding the Id–VGS curves of a known
+// good device and the pass limits for that part:
+//
+//   # Golden Reference
+//   # Part: BS170
+//   # Source: bs170_ref_1712345678.csv
+//   # Tolerance: rmse=1.000e-04 r2=0.99000 chi2=5.000e-02
+//   vds,vgs,ids
+//   0.100,0.000,1.234e-09
+//   ...
+//
+// References are created from a stored SWEEP_VGS measurement, so the shop
+// measures one good device, promotes the file, and bins against it. During
+// a sweep with a part number set, MOSFETController compares every curve
+// with the reference curve of the nearest VDS (math_engine::GoldenComparator).
+// ============================================================================
+
+#include <Arduino.h>
+#include <vector>
+#include "math_engine.h"
+
+// ----------------------------------------------------------------------------
+// GoldenCurve / GoldenFamily — a loaded reference
+// ----------------------------------------------------------------------------
+struct GoldenCurve {
+    float              vds = 0.0f;  ///< Drain voltage of this curve (V)
+    std::vector<float> vgs;         ///< Ascending gate voltages (V)
+    std::vector<float> ids;         ///< Drain current at each vgs (A)
+};
+
+struct GoldenFamily {
+    String                       part;
+    math_engine::GoldenTolerance tolerance;
+    std::vector<GoldenCurve>     curves;
+
+    /** Curve whose VDS is nearest to `vds`, or nullptr if none is within VDS_TOLERANCE. */
+    const GoldenCurve* find(float vds) const;
+
+    void clear();
+};
+
+// ============================================================================
+// GoldenStore
+// ============================================================================
+class GoldenStore {
+public:
+    static const char* GOLDEN_DIR;                ///< "/golden"
+    static constexpr float VDS_TOLERANCE = 0.015f; ///< VDS match window (V), as in compare_iv.py
+
+    /** Create the /golden directory if absent. FFat must already be mounted. */
+    static bool init();
+
+    /**
+     * @brief Validate a part number used as a file name.
+     *
+     * 1–32 characters: alphanumerics, underscore, hyphen and dot, no "..".
+     */
+    static bool isValidPartNumber(const String& part);
+
+    /** Part numbers that have a reference, in directory order. */
+    static std::vector<String> listParts();
+
+    /**
+     * @brief Promote a stored measurement to the reference for `part`.
+     *
+     * The measurement must be a SWEEP_VGS file in /measurements. An existing
+     * reference for the part is replaced.
+     *
+     * @return false if the file is missing, not a transfer sweep, or holds
+     *         no curve of at least 2 points.
+     */
+    static bool createFromMeasurement(const String& part, const String& filename,
+                                      const math_engine::GoldenTolerance& tolerance);
+
+    /** Load the reference for `part`. Returns false if it is missing or malformed. */
+    static bool load(const String& part, GoldenFamily& family);
+
+    /** Delete the reference for `part`. */
+    static bool remove(const String& part);
+
+private:
+    static String pathFor(const String& part);
+};
@@ -9,6 +9,23 @@
 #include <Adafruit_MCP4725.h>
 #include <Adafruit_ADS1X15.h>
 
+#include "conversion_source.h"
+#include "dma_frame_source.h"
+#include "oversampling.h"
+#include "pga_autorange.h"
+
+// ADS1115 ALERT/RDY → GPIO for interrupt-driven continuous conversion;
+// -1 = not wired (single-shot polling). Set with -DADS_ALERT_PIN=<gpio>.
+#ifndef ADS_ALERT_PIN
+#define ADS_ALERT_PIN -1
+#endif
+
+// InternalADC sampling through the continuous (DMA) ADC driver; 0 = one
+// analogRead() per sample. Set with -DINTERNAL_ADC_DMA=1.
+#ifndef INTERNAL_ADC_DMA
+#define INTERNAL_ADC_DMA 0
+#endif
+
 // ============================================================================
 // Hardware Abstraction Layer
 // ============================================================================
@@ -20,12 +37,13 @@
 //   HW_INTERNAL mode:
 //     - DAC VDS : InternalDAC ch1 (GPIO25, 8-bit)
 //     - DAC VGS : InternalDAC ch2 (GPIO26, 8-bit)
-//     - ADC     : InternalADC     (GPIO34, 12-bit + oversampling)
+//     - ADC     : InternalADC     (GPIO34, 12-bit + oversampling, DMA)
 //
 //   HW_EXTERNAL mode (default) — fully I2C since v4.2.0:
 //     - DAC VDS : ExternalDAC2 MCP4725 (I2C 0x61, ADDR→VCC, 12-bit)
 //     - DAC VGS : ExternalDAC  MCP4725 (I2C 0x60, ADDR→GND, 12-bit)
-//     - ADC     : ExternalADC  ADS1115 (I2C 0x48, A0, 16-bit + oversampling)
+//     - ADC     : ExternalADC  ADS1115 (I2C 0x48, A0, 16-bit + oversampling),
+//                 or HybridADC: GPIO34 coarse read + ADS1115 (ads_hybrid)
 // ============================================================================
 
 namespace hal {
@@ -57,7 +75,11 @@ class IVoltageSource {
 public:
     virtual ~IVoltageSource() = default;
 
-    /** Set output voltage (clamped to valid range). */
+    /**
+     * Set output voltage (clamped to valid range). The bus write is skipped
+     * when the quantized code equals the last one written (shadow register);
+     * see HardwareHAL::getDacWriteStats().
+     */
     virtual void    setVoltage(float voltage) = 0;
     /** Maximum output voltage in Volts. */
     virtual float   getMaxVoltage() const = 0;
@@ -73,7 +95,7 @@ public:
  * @brief Abstract interface for voltage/current sensor (ADC).
  *
  * Implementations provide noise-reduced voltage readings via oversampling
- * (Insertion Sort + Trimmed Mean). Used to read the shunt resistor voltage.
+ * (estimators in oversampling.h). Used to read the shunt resistor voltage.
  */
 class ICurrentSensor {
 public:
@@ -89,8 +111,25 @@ public:
     virtual uint16_t getOversamplingCount() const = 0;
     /** Set number of samples (1–256). */
     virtual void     setOversamplingCount(uint16_t count) = 0;
+    /** Estimator reducing the samples to one reading. */
+    virtual OversamplingMethod getOversamplingMethod() const = 0;
+    virtual void     setOversamplingMethod(OversamplingMethod method) = 0;
+    /** Stop sampling early once the reading is precise enough (when enabled). */
+    virtual void     setAdaptive(const AdaptiveOversampling& adaptive) = 0;
+    /** Samples behind the last readVoltage(): the count, or fewer in adaptive mode. */
+    virtual uint16_t getLastSampleCount() const = 0;
+    /** Full-scale input of the last readVoltage() in Volts (the PGA range on the ADS1115). */
+    virtual float    getLastFullScale() const = 0;
     /** Effective number of bits (ENOB) accounting for oversampling gain. */
     virtual float    getEffectiveBits() const = 0;
+    /**
+     * @brief The points of one curve follow, at least `settlingMs` apart, until endCurve()
+     *
+     * A sensor may keep its converter running in between instead of
+     * starting it for every point. No-op by default.
+     */
+    virtual void     beginCurve(uint32_t settlingMs) { (void)settlingMs; }
+    virtual void     endCurve() {}
 };
 
 // ============================================================================
@@ -106,6 +145,21 @@ struct HalConfig {
 
     // Oversampling (applies to both internal and external ADC)
     uint16_t adc_oversampling = 16;
+    OversamplingMethod adc_method = OversamplingMethod::TrimmedMean;
+    AdaptiveOversampling adc_adaptive;  // Disabled: always adc_oversampling samples
+
+    // ADS1115 ALERT/RDY pin (HW_EXTERNAL mode); -1 = single-shot polling
+    int8_t   ads_alert_pin    = ADS_ALERT_PIN;
+
+    // ADS1115 PGA (HW_EXTERNAL mode): gain code, or the first point's range
+    // when auto-ranging (0=±6.144V 1=±4.096V 2=±2.048V 4=±1.024V 8=±0.512V 16=±0.256V)
+    uint8_t  ads_gain         = 16;
+    bool     ads_autorange    = false;
+
+    // Hybrid ranging (HW_EXTERNAL mode): a coarse GPIO34 read picks the PGA
+    // range and skips the ADS1115 when the point is off-scale or below the floor
+    bool     ads_hybrid       = false;
+    float    hybrid_floor_v   = 0.0f;  // 0 = never skip at the low end
 
     // Reference voltages and safety limits
     float dac_vref = 3.3f;
@@ -132,6 +186,11 @@ constexpr uint16_t ADC_MAX_VALUE       = 4095;
 constexpr float    ADC_VREF            = 3.3f;
 constexpr uint16_t ADC_DEFAULT_SAMPLES = 64;
 
+// Internal ADC continuous driver (INTERNAL_ADC_DMA)
+constexpr uint32_t ADC_DMA_SAMPLE_HZ     = 100000;  // Fixed conversion rate
+constexpr uint16_t ADC_DMA_FRAME_SAMPLES = 64;      // Conversions per DMA frame until a curve resizes it (0.64 ms)
+constexpr uint8_t  ADC_DMA_BUFFER_FRAMES = 8;       // Driver ring buffer, in frames
+
 // External DAC (MCP4725 — 12-bit, 0–3.3 V)
 constexpr uint8_t  EXT_DAC_VGS_ADDR  = 0x60;  // ADDR pin → GND
 constexpr uint8_t  EXT_DAC_VDS_ADDR  = 0x61;  // ADDR pin → VCC (future)
@@ -147,6 +206,12 @@ constexpr uint8_t  EXT_ADC_ADDR    = 0x48;    // ADDR pin → GND
 constexpr uint8_t  EXT_ADC_BITS    = 16;
 constexpr float    EXT_ADC_VREF    = 0.256f;  // Default FSR: GAIN_SIXTEEN (±0.256 V)
 constexpr int16_t  EXT_ADC_MAX_RAW = 32767;   // Positive full-scale
+constexpr uint32_t EXT_ADC_CONVERSION_US = 1163;  // 1 / 860 SPS
+
+// Hybrid ranging (HybridADC): GPIO34 coarse read ahead of the ADS1115
+constexpr uint16_t HYBRID_COARSE_SAMPLES = 16;     // ~0.16 ms of analogRead(), ~0.8 ms as a DMA window
+constexpr float    HYBRID_COARSE_MARGIN  = 0.10f;  // V; uncalibrated 11 dB offset and the ~0.1 V dead zone
+constexpr float    HYBRID_WIDE_RANGE_V   = 3.0f;   // Coarse reading at or above: 11 dB curve too bent to pick a range, widest one used
 
 // Safety voltage limits
 constexpr float MAX_VDS_VOLTAGE = 3.3f;
@@ -176,20 +241,66 @@ public:
 private:
     uint8_t channel_;
     float   maxVoltage_;
-    uint8_t currentValue_ = 0;
+    uint8_t currentValue_ = 0;      ///< Shadow of the last code written
+    bool    shadowValid_  = false;  ///< false until a write succeeds: the next one always goes out
     bool    initialized_  = false;
 };
 
 
+// ============================================================================
+// AdcDmaSource — ESP32 continuous ADC driver on one ADC1 channel
+// ============================================================================
+// begin() installs the driver (adc_digi_*, ESP-IDF 4.4) for a single
+// channel at ADC_DMA_SAMPLE_HZ, 11 dB attenuation like analogRead(). The
+// ISR only moves finished frames into the driver's ring buffer; the reading
+// task blocks in readFrame(). Sampling runs only between start() and stop(),
+// so analogRead() still works outside them. ADC2 pins are not supported.
+class AdcDmaSource : public IDmaFrameSource {
+public:
+    explicit AdcDmaSource(uint8_t pin) : pin_(pin) {}
+    ~AdcDmaSource() override;
+
+    /**
+     * @brief Install the driver for the pin's ADC1 channel, `frameSamples` conversions per frame
+     *
+     * Called again with another frame size, reinstalls it (sampling must be
+     * stopped). Returns false if unavailable.
+     */
+    bool     begin(uint16_t frameSamples = ADC_DMA_FRAME_SAMPLES);
+
+    bool     start() override;
+    void     stop() override;
+    size_t   readFrame(uint8_t* buf, size_t maxBytes, uint32_t timeoutMs, bool& overrun) override;
+    size_t   frameBytes() const override   { return frameSamples_ * DMA_WORD_BYTES; }
+    uint32_t sampleRateHz() const override { return ADC_DMA_SAMPLE_HZ; }
+
+    uint8_t  channel() const { return channel_; }
+
+private:
+    uint8_t  pin_;
+    uint8_t  channel_      = 0;
+    uint16_t frameSamples_ = ADC_DMA_FRAME_SAMPLES;
+    bool     installed_    = false;
+};
+
+
 // ============================================================================
 // InternalADC — ESP32 built-in 12-bit ADC with oversampling
 // ============================================================================
 /**
- * Oversampling strategy: Insertion Sort + Trimmed Mean (10% each side).
+ * Oversampling strategy (default): Trimmed Mean, 10% each side.
  *   1. Collect N raw readings.
- *   2. Sort with Insertion Sort (stack-only, MCU-friendly).
- *   3. Discard bottom 10% and top 10%.
- *   4. Average the central 80%.
+ *   2. Quickselect the 10% and 90% cut points (average O(N)).
+ *   3. Average the central 80%.
+ * Samples come from the continuous driver (AdcDmaSource) when
+ * INTERNAL_ADC_DMA is set and the pin is on ADC1: the task sleeps while the
+ * DMA fills the window. Between beginCurve() and endCurve() the driver runs
+ * for the whole curve with frames of the oversampling count, so a point only
+ * waits for the end of the frame in flight instead of a start and a warm-up
+ * frame; a curve whose settling time is shorter than a frame uses
+ * analogRead(). Otherwise, or if the driver stalls, one analogRead() per
+ * sample; MinMaxReject then reads straight into a running sum (unless
+ * adaptive oversampling needs the samples to decide when to stop).
  *
  * Effective ENOB gain ≈ log2(N)/2  (e.g., 64× → ~15 ENOB from 12-bit ADC).
  */
@@ -203,14 +314,36 @@ public:
     float    getResolution() const override         { return ADC_VREF / (ADC_MAX_VALUE + 1); }
     uint16_t getOversamplingCount() const override  { return oversamplingCount_; }
     void     setOversamplingCount(uint16_t count) override;
+    OversamplingMethod getOversamplingMethod() const override { return method_; }
+    void     setOversamplingMethod(OversamplingMethod method) override { method_ = method; }
+    void     setAdaptive(const AdaptiveOversampling& adaptive) override { adaptive_ = adaptive; }
+    uint16_t getLastSampleCount() const override    { return lastSampleCount_; }
+    float    getLastFullScale() const override      { return ADC_VREF; }
     float    getEffectiveBits() const override;
+    /** The last readVoltage() sat at code ADC_MAX_VALUE: the input is beyond the ADC's range. */
+    bool     getLastClipped() const                 { return lastClipped_; }
+
+    void     beginCurve(uint32_t settlingMs) override;
+    void     endCurve() override;
 
     void begin();
 
+    /** DMA counters since begin(); all zero when sampling with analogRead(). */
+    const DmaStats& getDmaStats() const { return dmaStats_; }
+
 private:
     uint8_t  pin_;
     uint16_t oversamplingCount_;
-    bool     initialized_ = false;
+    OversamplingMethod method_ = OversamplingMethod::TrimmedMean;
+    AdaptiveOversampling adaptive_;
+    uint16_t lastSampleCount_ = 0;
+    bool     lastClipped_  = false;
+    bool     initialized_  = false;
+    bool     dmaActive_    = false;  // AdcDmaSource path in use
+    bool     inCurve_      = false;  // Between beginCurve() and endCurve()
+    bool     streaming_    = false;  // Driver running for the current curve
+    AdcDmaSource dma_;
+    DmaStats     dmaStats_;
 };
 
 
@@ -239,12 +372,44 @@ public:
 private:
     uint8_t          i2cAddr_;
     float            maxVoltage_;
-    uint16_t         currentValue_ = 0;
+    uint16_t         currentValue_ = 0;      ///< Shadow of the last code written
+    bool             shadowValid_  = false;  ///< false until a write succeeds: the next one always goes out
     bool             initialized_  = false;
     Adafruit_MCP4725 mcp_;
 };
 
 
+// ============================================================================
+// AdsReadySource — ADS1115 continuous conversion paced by ALERT/RDY
+// ============================================================================
+// start() puts the ADS1115 in continuous mode with ALERT/RDY as a
+// conversion-ready output (one low pulse per conversion). The pin's ISR
+// only sends a task notification to the task that called start(); that
+// task, asleep in waitReady() until then, reads the result over I2C — I2C
+// is never touched from interrupt context. Uses notification index 0 of
+// the calling task, which must not expect other notifications meanwhile.
+class AdsReadySource : public IConversionSource {
+public:
+    AdsReadySource(Adafruit_ADS1115& ads, int8_t alertPin) : ads_(ads), alertPin_(alertPin) {}
+
+    bool     start() override;
+    void     stop() override;
+    uint32_t waitReady(uint32_t timeoutUs) override;
+    int16_t  readConversion() override;
+    uint32_t conversionUs() const override { return EXT_ADC_CONVERSION_US; }
+
+    bool   wired() const { return alertPin_ >= 0; }
+    int8_t pin() const   { return alertPin_; }
+
+private:
+    static void onReady(void* arg);
+
+    Adafruit_ADS1115&     ads_;
+    int8_t                alertPin_;
+    volatile TaskHandle_t waiter_ = nullptr;
+};
+
+
 // ============================================================================
 // ExternalADC — ADS1115 I2C 16-bit ADC with oversampling
 // ============================================================================
@@ -252,19 +417,31 @@ private:
 // I2C address: 0x48 (ADDR pin tied to GND). Channel: A0.
 // Gain: GAIN_TWO (±2.048 V FSR) for best resolution in 0–3.3 V range.
 //
-// Applies the same Insertion Sort + Trimmed Mean algorithm as InternalADC,
-// using ads.readADC_SingleEnded(0) as the raw sample source.
+// Reduces the samples with the same estimators as InternalADC.
+// Raw samples come from continuous conversion paced by ALERT/RDY when the
+// pin is wired (AdsReadySource), else from ads.readADC_SingleEnded(0). A
+// ready signal that never arrives switches back to single-shot for good.
+//
+// With auto-ranging (setAutoRange()) each reading leaves the PGA on the
+// range pgaNextRange() picks for the next point, and a reading with a
+// clipped sample is repeated one range wider (pga_autorange.h).
 class ExternalADC : public ICurrentSensor {
 public:
     explicit ExternalADC(uint8_t i2cAddr = EXT_ADC_ADDR,
-                         uint16_t oversamplingCount = ADC_DEFAULT_SAMPLES);
+                         uint16_t oversamplingCount = ADC_DEFAULT_SAMPLES,
+                         int8_t alertPin = ADS_ALERT_PIN);
     ~ExternalADC() override = default;
 
     float    readVoltage() override;
     uint16_t readRaw() override;
-    float    getResolution() const override         { return EXT_ADC_VREF / (EXT_ADC_MAX_RAW + 1); }
+    float    getResolution() const override         { return fsr_ / (EXT_ADC_MAX_RAW + 1); }
     uint16_t getOversamplingCount() const override  { return oversamplingCount_; }
     void     setOversamplingCount(uint16_t count) override;
+    OversamplingMethod getOversamplingMethod() const override { return method_; }
+    void     setOversamplingMethod(OversamplingMethod method) override { method_ = method; }
+    void     setAdaptive(const AdaptiveOversampling& adaptive) override { adaptive_ = adaptive; }
+    uint16_t getLastSampleCount() const override    { return lastSampleCount_; }
+    float    getLastFullScale() const override      { return lastFsr_; }
     float    getEffectiveBits() const override;
 
     /** Initialize the ADS1115. Returns true on success. */
@@ -279,12 +456,77 @@ public:
      */
     void setGain(uint8_t gainCode);
 
+    /** Pick the range of every point from the previous reading, starting at the setGain() range. */
+    void setAutoRange(bool enabled) { autoRange_ = enabled; }
+    /** Program PGA_RANGES[index]; the next conversion uses it. */
+    void applyRange(uint8_t index);
+
+    /** Continuous-mode counters since begin(); all zero in single-shot mode. */
+    const ContinuousStats& getContinuousStats() const { return continuousStats_; }
+
 private:
+    /** One oversampled reading at the current range; `clipped` when a sample hit full scale. */
+    float    sampleVoltage(bool& clipped);
+
     uint8_t          i2cAddr_;
     uint16_t         oversamplingCount_;
+    OversamplingMethod method_    = OversamplingMethod::TrimmedMean;
+    AdaptiveOversampling adaptive_;
+    uint16_t         lastSampleCount_ = 0;
     bool             initialized_ = false;
+    bool             continuous_  = false;          // ALERT/RDY path in use
     float            fsr_         = EXT_ADC_VREF;  // current FSR, updated by setGain()
+    float            lastFsr_     = EXT_ADC_VREF;  // FSR of the last readVoltage()
+    uint8_t          rangeIndex_  = PGA_RANGE_COUNT - 1;  // PGA_RANGES entry behind fsr_
+    bool             autoRange_   = false;
     Adafruit_ADS1115 ads_;
+    AdsReadySource   ready_;
+    ContinuousStats  continuousStats_;
+};
+
+
+// ============================================================================
+// HybridADC — GPIO34 coarse read ahead of the ADS1115
+// ============================================================================
+// HW_EXTERNAL mode with GPIO34 wired to the shunt node, as in HW_INTERNAL.
+// Every reading starts with one short InternalADC window (~0.16 ms):
+//   - a clipped coarse reading (code 4095) means the point is off-scale
+//     (compliance): it is returned and the ADS1115 is not used
+//   - below the floor (when set) the coarse reading is returned as well
+//   - at or above HYBRID_WIDE_RANGE_V the 11 dB curve is too nonlinear to
+//     choose a range from, so the fine reading uses the widest one
+//   - otherwise it picks the ADS1115 range (pgaRangeFor() with
+//     HYBRID_COARSE_MARGIN) and the fine reading follows; a clipped fine
+//     reading is still repeated one range wider
+// getLastFullScale() is ADC_VREF for coarse-only readings. Oversampling
+// settings apply to the fine conversion.
+class HybridADC : public ICurrentSensor {
+public:
+    HybridADC(std::unique_ptr<ExternalADC> fine, uint8_t coarsePin, float floorV);
+    ~HybridADC() override = default;
+
+    float    readVoltage() override;
+    uint16_t readRaw() override                     { return fine_->readRaw(); }
+    float    getResolution() const override         { return fine_->getResolution(); }
+    uint16_t getOversamplingCount() const override  { return fine_->getOversamplingCount(); }
+    void     setOversamplingCount(uint16_t count) override { fine_->setOversamplingCount(count); }
+    OversamplingMethod getOversamplingMethod() const override { return fine_->getOversamplingMethod(); }
+    void     setOversamplingMethod(OversamplingMethod method) override { fine_->setOversamplingMethod(method); }
+    void     setAdaptive(const AdaptiveOversampling& adaptive) override { fine_->setAdaptive(adaptive); }
+    uint16_t getLastSampleCount() const override    { return lastSampleCount_; }
+    float    getLastFullScale() const override      { return lastFsr_; }
+    float    getEffectiveBits() const override      { return fine_->getEffectiveBits(); }
+    void     beginCurve(uint32_t settlingMs) override { coarse_.beginCurve(settlingMs); }
+    void     endCurve() override                    { coarse_.endCurve(); }
+
+    void begin();
+
+private:
+    std::unique_ptr<ExternalADC> fine_;
+    InternalADC coarse_;
+    float       floorV_;
+    uint16_t    lastSampleCount_ = 0;
+    float       lastFsr_         = ADC_VREF;
 };
 
 
@@ -310,7 +552,8 @@ public:
 
 private:
     float            maxVoltage_;
-    uint16_t         currentValue_ = 0;
+    uint16_t         currentValue_ = 0;      ///< Shadow of the last code written
+    bool             shadowValid_  = false;  ///< false until a write succeeds: the next one always goes out
     bool             initialized_  = false;
     Adafruit_MCP4725 mcp_;
 };
@@ -353,6 +596,29 @@ public:
     };
     static ExternalDeviceStatus checkExternalDevices();
 
+    /**
+     * @brief DAC writes since the last resetDacWriteStats(), both channels.
+     *
+     * `elided` counts setVoltage() calls skipped by the shadow registers
+     * because the quantized code had not changed (e.g. the constant VGS
+     * re-applied on every point of an output-curve sweep).
+     */
+    struct DacWriteStats {
+        uint32_t written = 0;  ///< Codes sent to a DAC
+        uint32_t elided  = 0;  ///< Calls answered from the shadow register
+    };
+    static DacWriteStats getDacWriteStats();
+    static void          resetDacWriteStats();
+
+    /** HybridADC readings since the last resetHybridStats(). */
+    struct HybridStats {
+        uint32_t fine       = 0;  ///< Readings that ran the ADS1115
+        uint32_t offScale   = 0;  ///< Coarse clipped at code 4095, ADS1115 skipped
+        uint32_t belowFloor = 0;  ///< Coarse below the floor, ADS1115 skipped
+    };
+    static HybridStats getHybridStats();
+    static void        resetHybridStats();
+
     IVoltageSource&  getVDS()      { return *dacVDS_; }
     IVoltageSource&  getVGS()      { return *dacVGS_; }
     ICurrentSensor&  getShuntADC() { return *adcShunt_; }
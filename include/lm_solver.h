@@ -0,0 +1,247 @@
+#ifndef LM_SOLVER_H
+#define LM_SOLVER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Levenberg–Marquardt on fixed-size stack matrices
+// ============================================================================
+// Minimises Σ rᵢ(p)² over P parameters. The Jacobian is never stored: each
+// iteration streams the points once, accumulating JᵀJ (P×P) and Jᵀr (P)
+// directly, so memory is O(P²) on the stack whatever the point count. The
+// damped normal equations (JᵀJ + λ·diag(JᵀJ))·δ = −Jᵀr are solved by
+// Cholesky; a step that fails to lower the cost raises λ and is retried
+// without recomputing the Jacobian. Bounds are applied by the model's
+// constrain(); parameters held at a bound drop out of the step.
+//
+// The model is any type providing
+//
+//   size_t size() const;                                   // point count
+//   bool   residual(size_t i, const float* p,
+//                   float& r, float* jac) const;          // jac may be null
+//   void   constrain(float* p) const;                      // project p into bounds
+//
+// residual() returns false to skip a point (e.g. outside the model's domain).
+// A trial step that changes how many points are used is rejected like one
+// that raises the cost: sums over different point sets do not compare, and
+// a step that drops the worst-fitting points would otherwise always "win".
+//
+// Runtime is bounded by maxIterations, and optionally by a wall-clock
+// budget read through a caller-supplied microsecond clock, so the solver
+// stays free of platform headers.
+// ============================================================================
+
+namespace math_engine {
+namespace lm {
+
+/** Row-major R×C matrix by value — no heap, sized at compile time. */
+template <size_t R, size_t C>
+struct Matrix {
+    float m[R][C] = {};
+
+    float*       operator[](size_t r)       { return m[r]; }
+    const float* operator[](size_t r) const { return m[r]; }
+};
+
+template <size_t N>
+using Vector = Matrix<N, 1>;
+
+/**
+ * @brief Solve A·x = b for symmetric positive-definite A (Cholesky)
+ *
+ * @return false if A is not positive definite
+ */
+template <size_t N>
+bool choleskySolve(const Matrix<N, N>& A, const Vector<N>& b, Vector<N>& x) {
+    Matrix<N, N> L;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j <= i; j++) {
+            float sum = A[i][j];
+            for (size_t k = 0; k < j; k++) sum -= L[i][k] * L[j][k];
+            if (i == j) {
+                if (!(sum > 0)) return false;
+                L[i][i] = sqrtf(sum);
+            } else {
+                L[i][j] = sum / L[j][j];
+            }
+        }
+    }
+    // Forward (L·y = b), then back (Lᵀ·x = y) substitution
+    Vector<N> y;
+    for (size_t i = 0; i < N; i++) {
+        float sum = b[i][0];
+        for (size_t k = 0; k < i; k++) sum -= L[i][k] * y[k][0];
+        y[i][0] = sum / L[i][i];
+    }
+    for (size_t i = N; i-- > 0;) {
+        float sum = y[i][0];
+        for (size_t k = i + 1; k < N; k++) sum -= L[k][i] * x[k][0];
+        x[i][0] = sum / L[i][i];
+    }
+    return true;
+}
+
+struct Config {
+    uint16_t maxIterations = 40;      ///< Jacobian evaluations
+    float    tolerance     = 1e-6f;   ///< Stop when the relative cost decrease falls below this
+    float    lambda0       = 1e-3f;   ///< Initial damping
+    uint32_t budgetUs      = 0;       ///< Wall-clock limit (µs); 0 = none
+    uint32_t (*clockUs)()  = nullptr; ///< Microsecond clock for budgetUs (e.g. micros)
+};
+
+enum class Status : uint8_t {
+    Converged,       ///< Cost stopped decreasing within tolerance
+    IterationLimit,  ///< maxIterations reached
+    BudgetExhausted, ///< budgetUs elapsed; parameters are the best so far
+    Failed           ///< Fewer usable points than parameters, or no descent possible
+};
+
+template <size_t P>
+struct Result {
+    float    params[P] = {};
+    float    cost       = 0.0f;  ///< Σ r² at params
+    size_t   points     = 0;     ///< Points that contributed at params
+    uint16_t iterations = 0;
+    Status   status     = Status::Failed;
+};
+
+/**
+ * @brief Fit `model` starting from `initial`
+ *
+ * @return Best parameters found and why the solver stopped
+ */
+template <size_t P, class Model>
+Result<P> solve(const Model& model, const float (&initial)[P], const Config& config = Config()) {
+    Result<P> result;
+    const uint32_t start = config.clockUs ? config.clockUs() : 0;
+    auto outOfTime = [&] {
+        return config.budgetUs && config.clockUs && config.clockUs() - start >= config.budgetUs;
+    };
+
+    float p[P];
+    for (size_t k = 0; k < P; k++) p[k] = initial[k];
+    model.constrain(p);
+
+    // Cost only (trial steps)
+    auto costAt = [&](const float* q, size_t& used) {
+        float sum = 0;
+        used = 0;
+        for (size_t i = 0; i < model.size(); i++) {
+            float r;
+            if (!model.residual(i, q, r, nullptr)) continue;
+            sum += r * r;
+            used++;
+        }
+        return sum;
+    };
+
+    float lambda = config.lambda0;
+    size_t used;
+    float cost = costAt(p, used);
+    if (used < P) {
+        for (size_t k = 0; k < P; k++) result.params[k] = p[k];
+        return result;
+    }
+
+    result.status = Status::IterationLimit;
+    for (uint16_t it = 0; it < config.maxIterations; it++) {
+        if (outOfTime()) {
+            result.status = Status::BudgetExhausted;
+            break;
+        }
+        result.iterations = it + 1;
+
+        // ── JᵀJ and Jᵀr in one pass ───────────────────────────────────────
+        Matrix<P, P> jtj;
+        Vector<P>    jtr;
+        for (size_t i = 0; i < model.size(); i++) {
+            float r, jac[P];
+            if (!model.residual(i, p, r, jac)) continue;
+            for (size_t a = 0; a < P; a++) {
+                jtr[a][0] += jac[a] * r;
+                for (size_t b = 0; b <= a; b++) jtj[a][b] += jac[a] * jac[b];
+            }
+        }
+        for (size_t a = 0; a < P; a++) {
+            for (size_t b = a + 1; b < P; b++) jtj[a][b] = jtj[b][a];
+        }
+
+        // ── Damped step, retried with more damping until the cost drops ───
+        bool improved = false;
+        float newCost = cost;
+        while (!improved && lambda < 1e10f) {
+            Matrix<P, P> A = jtj;
+            Vector<P>    rhs;
+            for (size_t a = 0; a < P; a++) {
+                A[a][a] += lambda * (jtj[a][a] > 1e-20f ? jtj[a][a] : 1e-20f);
+                rhs[a][0] = -jtr[a][0];
+            }
+
+            Vector<P> delta;
+            if (choleskySolve(A, rhs, delta)) {
+                float trial[P];
+                for (size_t k = 0; k < P; k++) trial[k] = p[k] + delta[k][0];
+                model.constrain(trial);
+
+                // Parameters pinned at a bound that the step pushes further
+                // out are held fixed and the rest re-solved; projecting the
+                // full step instead stalls progress along the free directions.
+                bool pinned[P] = {};
+                bool anyPinned = false;
+                for (size_t k = 0; k < P; k++) {
+                    if (trial[k] == p[k] && delta[k][0] != 0.0f) pinned[k] = anyPinned = true;
+                }
+                if (anyPinned) {
+                    for (size_t a = 0; a < P; a++) {
+                        for (size_t b = 0; b < P; b++) {
+                            if (pinned[a] || pinned[b]) A[a][b] = (a == b) ? 1.0f : 0.0f;
+                        }
+                        if (pinned[a]) rhs[a][0] = 0.0f;
+                    }
+                    if (!choleskySolve(A, rhs, delta)) {
+                        lambda *= 10.0f;
+                        continue;
+                    }
+                    for (size_t k = 0; k < P; k++) trial[k] = p[k] + delta[k][0];
+                    model.constrain(trial);
+                }
+
+                size_t trialUsed;
+                newCost = costAt(trial, trialUsed);
+                if (trialUsed == used && newCost < cost) {
+                    for (size_t k = 0; k < P; k++) p[k] = trial[k];
+                    used = trialUsed;
+                    improved = true;
+                    lambda = lambda * 0.1f > 1e-7f ? lambda * 0.1f : 1e-7f;
+                    break;
+                }
+            }
+            lambda *= 10.0f;
+            if (outOfTime()) break;
+        }
+
+        if (!improved) {
+            result.status = outOfTime() ? Status::BudgetExhausted : Status::Converged;
+            break;
+        }
+
+        const float decrease = cost - newCost;
+        cost = newCost;
+        if (decrease <= config.tolerance * (cost > 1e-30f ? cost : 1e-30f)) {
+            result.status = Status::Converged;
+            break;
+        }
+    }
+
+    for (size_t k = 0; k < P; k++) result.params[k] = p[k];
+    result.cost   = cost;
+    result.points = used;
+    return result;
+}
+
+} // namespace lm
+} // namespace math_engine
+
+#endif // LM_SOLVER_H
@@ -1,8 +1,11 @@
 #ifndef MATH_ENGINE_H
 #define MATH_ENGINE_H
 
-#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <utility>
+#include "regression_numerics.h"
 
 // ============================================================================
 // Math Engine for MOSFET Parameter Calculation
@@ -11,10 +14,138 @@
 //   - Gm (Transconductance): dIds/dVgs
 //   - Vt (Threshold Voltage): Extrapolated from max Gm point
 //   - SS (Subthreshold Swing): mV/decade in exponential region
+//
+// Every routine exists in two flavours:
+//   - std::vector API: convenient, allocates its result and temporaries.
+//   - Span + ScratchArena API: writes into caller buffers and draws all
+//     temporaries from an arena that outlives the sweep, so per-curve
+//     analysis performs no heap allocation at all.
 // ============================================================================
 
 namespace math_engine {
 
+// ============================================================================
+// Span — non-owning view over contiguous data
+// ============================================================================
+/**
+ * @brief Minimal C++17 stand-in for std::span
+ *
+ * Implicitly constructible from any container exposing data()/size()
+ * (std::vector, std::array, another Span), so vector callers can use the
+ * span overloads directly.
+ */
+template <typename T>
+class Span {
+public:
+    constexpr Span() = default;
+    constexpr Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename C, typename = decltype(static_cast<T*>(std::declval<C&>().data()))>
+    constexpr Span(C& c) : data_(c.data()), size_(c.size()) {}
+
+    constexpr T*     data()  const { return data_; }
+    constexpr size_t size()  const { return size_; }
+    constexpr bool   empty() const { return size_ == 0; }
+    constexpr T*     begin() const { return data_; }
+    constexpr T*     end()   const { return data_ + size_; }
+    constexpr T&     operator[](size_t i) const { return data_[i]; }
+
+    /** View of [offset, offset + count), clipped to the span. */
+    constexpr Span subspan(size_t offset, size_t count) const {
+        if (offset > size_) offset = size_;
+        if (count > size_ - offset) count = size_ - offset;
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T*     data_ = nullptr;
+    size_t size_ = 0;
+};
+
+using FloatSpan      = Span<float>;
+using ConstFloatSpan = Span<const float>;
+
+// ============================================================================
+// ScratchArena — bump allocator for analysis temporaries
+// ============================================================================
+/**
+ * @brief Fixed-capacity scratch memory reused across curves
+ *
+ * Either wraps a caller-supplied buffer or owns a single block allocated up
+ * front. alloc() carves aligned sub-buffers; Scope rewinds the arena when a
+ * function returns, so nested calls share the same block without leaking.
+ * Exhaustion never touches the heap: alloc() returns an empty Span and the
+ * analysis routine reports an invalid result instead.
+ */
+class ScratchArena {
+public:
+    ScratchArena() = default;
+
+    /** Use caller-owned memory (not freed by the arena). */
+    ScratchArena(void* buffer, size_t bytes);
+
+    /** Allocate and own a block of `bytes` (one heap allocation). */
+    explicit ScratchArena(size_t bytes);
+
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&)            = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Ensure an owned block of at least `bytes`
+     *
+     * No-op when the current block is already large enough; otherwise the
+     * arena is reset and reallocated. Returns false on allocation failure.
+     */
+    bool reserve(size_t bytes);
+
+    /** Carve `count` elements of T, or an empty Span if exhausted. */
+    template <typename T>
+    Span<T> alloc(size_t count) {
+        void* p = allocBytes(count * sizeof(T), alignof(T));
+        return p ? Span<T>(static_cast<T*>(p), count) : Span<T>();
+    }
+
+    size_t capacity()  const { return capacity_; }
+    size_t used()      const { return used_; }
+    size_t highWater() const { return highWater_; }
+    void   reset()           { used_ = 0; }
+
+    /** RAII guard that rewinds the arena to its state at construction. */
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena) : arena_(arena), mark_(arena.used_) {}
+        ~Scope() { arena_.used_ = mark_; }
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        ScratchArena& arena_;
+        size_t        mark_;
+    };
+
+private:
+    void* allocBytes(size_t bytes, size_t align);
+    void  release();
+
+    uint8_t* base_      = nullptr;
+    size_t   capacity_  = 0;
+    size_t   used_      = 0;
+    size_t   highWater_ = 0;
+    bool     owned_     = false;
+};
+
+/**
+ * @brief Arena size that covers any single analysis call on a curve
+ *
+ * CurveAnalyzer is the largest consumer (sample buffers + SS prefix sums);
+ * allocate this once per sweep for the longest curve.
+ *
+ * @param points Number of points per curve
+ * @return Required capacity in bytes
+ */
+size_t scratchBytes(size_t points);
+
 /**
  * @brief Result of SS (Subthreshold Swing) calculation
  * 
@@ -37,18 +168,46 @@ struct SSResult {
     size_t regionEnd = 0;
 };
 
+/** Subthreshold-slope estimator used by calculateSS() and CurveAnalyzer. */
+enum class SSMethod : uint8_t {
+    SlidingWindow,  ///< Best-R² window of 5-20 points (default)
+    TheilSen,       ///< Median of pairwise slopes over the located region
+    Ransac          ///< Bounded-iteration consensus line over the located region
+};
+
+/**
+ * @brief Configuration for SS calculation
+ *
+ * The robust methods locate the subthreshold region in O(n) — the steepest
+ * monotonic rise of despiked log10(Ids), grown while the local slope stays
+ * within 5% of its peak — then fit the raw log10(Ids) of that region.
+ */
+struct SSConfig {
+    SSMethod method = SSMethod::SlidingWindow;
+    uint16_t ransacIterations = 64;     ///< Candidate lines tried by Ransac
+    float    ransacTolerance  = 0.05f;  ///< Inlier band (decades of Ids)
+    uint32_t ransacSeed       = 1;      ///< Sample sequence; fixed for repeatable results
+};
+
+/** Largest region the robust SS methods fit, in points (bounds Theil–Sen's pair buffer). */
+const size_t SS_ROBUST_MAX_POINTS = 40;
+
 /**
  * @brief Configuration for Gm calculation
  */
 struct GmConfig {
-    size_t smoothingWindow = 5;  // Moving average window size
+    size_t smoothingWindow = 5;  // Filter window (odd; SG tables cover 5-11)
+    size_t polyOrder = 2;        // Savitzky-Golay polynomial order (2-4)
     bool useSavitzkyGolay = true; // Use Savitzky-Golay filter for better SNR
 };
 
 /**
  * @brief Calculate transconductance (Gm = dIds/dVgs)
  * 
- * Uses central difference with optional smoothing.
+ * With Savitzky-Golay enabled, a single derivative-kernel convolution
+ * selected by smoothingWindow/polyOrder yields Gm directly; a non-uniform
+ * VGS grid gets the same fit through a GridKernel. Otherwise moving-average
+ * smoothing is followed by a central difference.
  * 
  * @param ids Vector of drain current values
  * @param vgs Vector of gate-source voltage values
@@ -61,6 +220,91 @@ std::vector<float> calculateGm(
     const GmConfig& config = GmConfig()
 );
 
+/**
+ * @brief Allocation-free calculateGm()
+ *
+ * @param gm Output buffer, same size as ids (zero-filled on failure)
+ * @param arena Scratch for the moving-average path and the GridKernel table
+ * @return true on success
+ */
+bool calculateGm(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    FloatSpan gm,
+    ScratchArena& arena,
+    const GmConfig& config = GmConfig()
+);
+
+// ============================================================================
+// Operating-region segmentation
+// ============================================================================
+
+/** Operating region of one transfer-curve point. */
+enum class OperatingRegion : uint8_t {
+    Off,           ///< Noise floor and the bend just above it
+    Subthreshold,  ///< Exponential rise of Ids
+    Saturation,    ///< Above threshold, Gm still rising (VGS − Vt < VDS)
+    Linear         ///< Past the Gm peak (triode, or mobility-limited)
+};
+
+/**
+ * @brief Region boundaries of one transfer curve, as point indices
+ *
+ * Regions are contiguous and in sweep order; each field is the first index
+ * of its region, so [subthreshold, saturation) is the exponential region
+ * and [linear, size) lies past the Gm peak.
+ *
+ * When `valid` is false no exponential region was found: subthreshold and
+ * saturation are 0 and only the Gm boundary is meaningful.
+ */
+struct CurveRegions {
+    bool   valid        = false;  ///< An exponential region was located
+    size_t subthreshold = 0;      ///< First subthreshold point; earlier points are off
+    size_t saturation   = 0;      ///< First point above the exponential region
+    size_t linear       = 0;      ///< First point past the Gm peak
+    size_t size         = 0;      ///< Curve length
+    size_t gmPeak       = 0;      ///< First Gm maximum; size when no Gm was given
+    size_t steepStart   = 0;      ///< Steepest span of the exponential region,
+    size_t steepEnd     = 0;      ///< [steepStart, steepEnd] inclusive
+
+    /** Region of point i; before the Gm peak of an invalid result, Saturation. */
+    OperatingRegion at(size_t i) const {
+        if (i >= linear) return OperatingRegion::Linear;
+        if (!valid || i >= saturation) return OperatingRegion::Saturation;
+        if (i >= subthreshold) return OperatingRegion::Subthreshold;
+        return OperatingRegion::Off;
+    }
+};
+
+/**
+ * @brief Locate the operating regions of a transfer curve in O(n)
+ *
+ * On despiked log10(Ids) — points more than 0.2 decades off the median of
+ * their nine neighbours (up to four ADC spikes) are interpolated from the
+ * clean points around them:
+ *   1. the rising run with the largest total gain — the climb from the
+ *      noise floor towards strong inversion; floor noise never sustains one
+ *   2. within it, at least one decade above its foot (where the floor still
+ *      bends the curve), the span of ~80 mV (at least 4 steps) whose
+ *      flattest 40 mV piece is steepest: a span has to be steep throughout,
+ *      so noise near the floor cannot win it
+ *   3. grown left and right while the slope over 40 mV stays within 5% of
+ *      that peak: the straight part of the exponential region, clear of the
+ *      knee and the floor a robust fit would otherwise take for the trend
+ * The Gm peak then splits the rest into saturation and linear. Pass an
+ * empty gm to skip that split (linear = size).
+ *
+ * The result feeds the region overloads of calculateSS(), calculateVt()
+ * and extractVt(), so each curve is segmented once instead of every
+ * consumer scanning it again. Needs n floats of arena.
+ */
+CurveRegions segmentCurve(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    ScratchArena& arena
+);
+
 /**
  * @brief Find threshold voltage (Vt) using maximum Gm extrapolation
  * 
@@ -80,6 +324,172 @@ float calculateVt(
     const std::vector<float>& ids
 );
 
+/**
+ * @brief calculateVt() over spans
+ *
+ * The second-derivative fallback is evaluated point by point. On a
+ * non-uniform VGS grid it differentiates Gm with a GridKernel built in the
+ * arena (gridKernelBytes(n, 5)), released on return.
+ */
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ScratchArena& arena
+);
+
+/**
+ * @brief calculateVt() with the Gm peak index already known
+ *
+ * Skips the max-Gm search for callers (CurveAnalyzer) that located the
+ * peak themselves; otherwise identical to the overload above.
+ */
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    size_t peakIdx,
+    ScratchArena& arena
+);
+
+/**
+ * @brief calculateVt() on a segmented curve
+ *
+ * Takes the Gm peak from `regions` and searches the second-derivative
+ * fallback only over [regions.subthreshold, regions.linear): d²Ids/dVgs
+ * peaks between the exponential region and the Gm peak, so the off and
+ * linear regions can only contribute noise and edge artefacts. Needs no
+ * scratch memory, so the fallback uses the uniform-grid table whatever the
+ * grid; the arena overload below does not.
+ */
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    const CurveRegions& regions
+);
+
+/**
+ * @brief calculateVt() on a segmented curve, exact on any VGS grid
+ *
+ * As above, but a non-uniform grid has its fallback differentiated with a
+ * GridKernel from `arena` (gridKernelBytes(n, 5)). CurveAnalyzer matches
+ * this overload.
+ */
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    const CurveRegions& regions,
+    ScratchArena& arena
+);
+
+// ============================================================================
+// Multi-method threshold voltage
+// ============================================================================
+
+/** Confidence flags attached to each Vt estimate. */
+enum VtFlag : uint8_t {
+    VT_FOUND        = 1 << 0,  ///< An estimate was produced
+    VT_AT_EDGE      = 1 << 1,  ///< Feature sits at a sweep end; the true one may lie outside
+    VT_EXTRAPOLATED = 1 << 2,  ///< Vt lies outside the swept VGS range
+    VT_POOR_FIT     = 1 << 3,  ///< Y-function fit R² below VtConfig::minYFitR2; second derivative on a non-uniform grid without a GridKernel
+    VT_OUTLIER      = 1 << 4,  ///< Off the median of the other estimates by more than the tolerance
+};
+
+/** One Vt estimate and its VtFlag bits. */
+struct VtEstimate {
+    float   vt    = 0.0f;  ///< Threshold voltage (V), 0 when not found
+    uint8_t flags = 0;     ///< VtFlag bits
+
+    bool found()     const { return flags & VT_FOUND; }
+    /** Found with no warning flag set. */
+    bool confident() const { return flags == VT_FOUND; }
+};
+
+/** Parameters for extractVt(). */
+struct VtConfig {
+    float constantCurrent    = 1e-5f;  ///< Drain current that defines constant-current Vt (A)
+    float minYFitR2          = 0.98f;  ///< Y-function fits below this are flagged VT_POOR_FIT
+    float agreementTolerance = 0.1f;   ///< Distance from the median that flags VT_OUTLIER (V)
+};
+
+/** Vt by every supported method, from one extractVt() call. */
+struct VtResult {
+    VtEstimate maxGm;             ///< Linear extrapolation at the Gm peak
+    VtEstimate secondDerivative;  ///< Peak of d²Ids/dVgs, interpolated between samples
+    VtEstimate constantCurrent;   ///< VGS where Ids crosses VtConfig::constantCurrent
+    VtEstimate yFunction;         ///< x-intercept of Y = Ids/√Gm beyond the Gm peak
+};
+
+/**
+ * @brief Extract Vt by four methods in a single pass over the curve
+ *
+ * Every method reads the Gm already computed for the curve; nothing is
+ * smoothed again and no scratch memory is used:
+ *   - maxGm: Vt = VGS − Ids/Gm at the Gm peak
+ *   - secondDerivative: peak of the Savitzky-Golay derivative of Gm (the
+ *     calculateVt() fallback), refined with a parabola through its
+ *     neighbours. The tables assume a uniform VGS step: on any other grid
+ *     this estimate is flagged VT_POOR_FIT; the arena overload below
+ *     differentiates with a GridKernel instead
+ *   - constantCurrent: first upward crossing of config.constantCurrent,
+ *     interpolated in log10(Ids)
+ *   - yFunction: least-squares line through Y = Ids/√Gm for the points
+ *     from the Gm peak on, which cancels first-order mobility degradation
+ *
+ * With three or more estimates found, any that disagree with their median
+ * by more than config.agreementTolerance are flagged VT_OUTLIER.
+ *
+ * @param peakIdx Index of the Gm maximum
+ */
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    size_t peakIdx,
+    const VtConfig& config = VtConfig()
+);
+
+/** @brief extractVt() with the Gm peak located here. */
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    const VtConfig& config = VtConfig()
+);
+
+/**
+ * @brief extractVt() on a segmented curve
+ *
+ * The Gm peak comes from `regions` and the second-derivative peak is
+ * searched over [regions.subthreshold, regions.linear) only, as in the
+ * region overload of calculateVt().
+ */
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    const CurveRegions& regions,
+    const VtConfig& config = VtConfig()
+);
+
+/**
+ * @brief extractVt() on a segmented curve, exact on any VGS grid
+ *
+ * A non-uniform grid has the second-derivative estimate computed with a
+ * GridKernel from `arena` (gridKernelBytes(n, 5)) instead of being flagged
+ * VT_POOR_FIT. CurveAnalyzer matches this overload.
+ */
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    const CurveRegions& regions,
+    ScratchArena& arena,
+    const VtConfig& config = VtConfig()
+);
+
 /**
  * @brief Calculate Subthreshold Swing (SS)
  * 
@@ -99,12 +509,73 @@ SSResult calculateSS(
     const std::vector<float>& vgs
 );
 
+/**
+ * @brief Allocation-free calculateSS(); needs scratchBytes(n) of arena.
+ */
+SSResult calculateSS(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    ScratchArena& arena
+);
+
+/**
+ * @brief calculateSS() with a selectable estimator
+ *
+ * SSMethod::SlidingWindow is the overload above. The robust methods read
+ * the unsmoothed curve, so a single ADC spike moves at most a few of the
+ * pairwise slopes (Theil–Sen, 29% breakdown) or falls outside the inlier
+ * band (Ransac) instead of tilting a least-squares fit:
+ *   - TheilSen: exact median of the m(m−1)/2 pairwise slopes by
+ *     quickselect (m ≤ SS_ROBUST_MAX_POINTS), intercept the median of
+ *     y − slope·x
+ *   - Ransac: config.ransacIterations lines through two random region
+ *     points, the one with most points within config.ransacTolerance
+ *     refitted by least squares over its inliers
+ * Results pass the same 60-1000 mV/dec plausibility check. Needs
+ * scratchBytes(n) of arena.
+ */
+SSResult calculateSS(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    ScratchArena& arena,
+    const SSConfig& config
+);
+
+/**
+ * @brief calculateSS() restricted to the exponential region of `regions`
+ *
+ * The robust methods fit up to SS_ROBUST_MAX_POINTS of
+ * [regions.subthreshold, regions.saturation), centred on the steepest span,
+ * without locating the region again. SSMethod::SlidingWindow scans only
+ * that region plus 4 points on either side, so a window may
+ * still straddle its ends; it scans the whole curve when `regions` is not
+ * valid, where the robust methods give up, and when the region is shorter
+ * than the longest window (20 points, e.g. a coarse VGS step), where the
+ * best window may lie partly outside it.
+ *
+ * Windows are 5-20 points and must cover half a decade, so on grids finer
+ * than about SS/40 (2 mV at 80 mV/dec) no window qualifies and the
+ * SlidingWindow result is invalid with or without regions; the robust
+ * methods fit up to SS_ROBUST_MAX_POINTS and do not have that limit.
+ */
+SSResult calculateSS(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    const CurveRegions& regions,
+    ScratchArena& arena,
+    const SSConfig& config = SSConfig()
+);
+
 /**
  * @brief Apply Savitzky-Golay smoothing filter
  * 
+ * Coefficients come from compile-time tables (see savitzky_golay.h).
+ * Unsupported sizes are clamped to the nearest tabulated kernel; inputs
+ * shorter than 5 points fall back to a moving average.
+ * 
  * @param data Input data vector
- * @param windowSize Window size (must be odd, default 5)
- * @param polyOrder Polynomial order (default 2)
+ * @param windowSize Window size (odd, 5-11, default 5)
+ * @param polyOrder Polynomial order (2-4, default 2)
  * @return Smoothed data vector
  */
 std::vector<float> savitzkyGolaySmooth(
@@ -113,6 +584,95 @@ std::vector<float> savitzkyGolaySmooth(
     size_t polyOrder = 2
 );
 
+/** @brief Savitzky-Golay smoothing into `out` (same size as `data`). */
+void savitzkyGolaySmooth(
+    ConstFloatSpan data,
+    FloatSpan out,
+    size_t windowSize = 5,
+    size_t polyOrder = 2
+);
+
+/**
+ * @brief Savitzky-Golay derivative in one convolution pass
+ * 
+ * @param data Input data vector (uniformly spaced samples)
+ * @param step Sample spacing (e.g. VGS step in Volts)
+ * @param windowSize Window size (odd, 5-11, default 5)
+ * @param polyOrder Polynomial order (2-4, default 2)
+ * @param deriv Derivative order (0-2, default 1)
+ * @return d^deriv(data)/dx^deriv, or zeros if the input is too short
+ */
+std::vector<float> savitzkyGolayDerivative(
+    const std::vector<float>& data,
+    float step,
+    size_t windowSize = 5,
+    size_t polyOrder = 2,
+    size_t deriv = 1
+);
+
+/** @brief Savitzky-Golay derivative into `out` (same size as `data`). */
+void savitzkyGolayDerivative(
+    ConstFloatSpan data,
+    FloatSpan out,
+    float step,
+    size_t windowSize = 5,
+    size_t polyOrder = 2,
+    size_t deriv = 1
+);
+
+/**
+ * @brief Local-polynomial derivative weights for a non-uniform grid
+ *
+ * The Savitzky-Golay tables assume a constant step. On any other grid
+ * (DAC code rounding, denser steps near threshold) the same least-squares
+ * polynomial is fitted around each point at its true x positions, once per
+ * curve, and the result is kept as a weight table: every output is then one
+ * `window`-tap dot product, as on a uniform grid. Edge points take the
+ * nearest full window, as sg::apply() does, so on a uniform grid the output
+ * matches savitzkyGolayDerivative() to rounding.
+ */
+struct GridKernel {
+    size_t       window  = 0;        ///< Taps per point (odd)
+    size_t       size    = 0;        ///< Points the table was built for
+    const float* weights = nullptr;  ///< size x window, row-major (in the build arena)
+
+    bool valid() const { return weights != nullptr; }
+    /** First sample of point i's window. */
+    size_t start(size_t i) const;
+    /** Output at point i: the dot product of row i with y[start(i)..]. */
+    float at(ConstFloatSpan y, size_t i) const;
+    /** Every output into `out` (same size as y, which must be `size` long). */
+    void apply(ConstFloatSpan y, FloatSpan out) const;
+};
+
+/** Arena bytes buildGridKernel() takes for `points` and a window of up to `window` taps. */
+size_t gridKernelBytes(size_t points, size_t window);
+
+/**
+ * @brief Build the per-curve weight table for derivative `deriv` of data on x
+ *
+ * Window and order are clamped as for savitzkyGolayDerivative(). The table
+ * lives in `arena` and stays valid until the caller's Scope ends.
+ *
+ * @return false if x is too short, a window has coincident points, deriv
+ *         exceeds 2 or the arena is too small
+ */
+bool buildGridKernel(
+    ConstFloatSpan x,
+    ScratchArena& arena,
+    GridKernel& kernel,
+    size_t windowSize = 5,
+    size_t polyOrder = 2,
+    size_t deriv = 1
+);
+
+/**
+ * @brief True if every step of x is within `tolerance` (relative) of the mean step
+ *
+ * Selects between the compile-time Savitzky-Golay tables and a GridKernel.
+ */
+bool isUniformGrid(ConstFloatSpan x, float tolerance = 1e-3f);
+
 /**
  * @brief Simple moving average smoothing
  * 
@@ -125,6 +685,13 @@ std::vector<float> movingAverageSmooth(
     size_t windowSize = 5
 );
 
+/** @brief Moving average into `out` (same size as `data`). */
+void movingAverageSmooth(
+    ConstFloatSpan data,
+    FloatSpan out,
+    size_t windowSize = 5
+);
+
 /**
  * @brief Linear regression on (x, y) data
  * 
@@ -141,6 +708,583 @@ float linearRegression(
     float& intercept
 );
 
+/**
+ * @brief Linear regression with a selectable numerics policy
+ *
+ * Accumulates moments about the sample mean with numerics::Double,
+ * CompensatedFloat or Fixed<F> (see regression_numerics.h); R² comes from
+ * the moments, Sxy² / (Sxx·Syy).
+ */
+template <class Numerics>
+float linearRegression(ConstFloatSpan x, ConstFloatSpan y, float& slope, float& intercept) {
+    if (x.size() != y.size() || x.size() < 2) {
+        slope = 0;
+        intercept = 0;
+        return 0;
+    }
+
+    // Origin near the mean keeps the centred sums small; it need not be exact
+    float mx = 0, my = 0;
+    for (size_t i = 0; i < x.size(); i++) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= x.size();
+    my /= y.size();
+
+    typename Numerics::Moments m;
+    for (size_t i = 0; i < x.size(); i++) m.add(x[i], y[i], mx, my);
+    return m.fit(static_cast<uint32_t>(x.size()), mx, my, slope, intercept);
+}
+
+/**
+ * @brief O(1) windowed linear regression over running prefix sums
+ *
+ * build() accumulates prefix moments (Σx, Σy, Σxy, Σx², Σy²) and the usable-
+ * point count once per curve (O(n)). Afterwards fit() returns slope,
+ * intercept and R² for any window [start, end) in constant time, considering
+ * only the points flagged usable — identical to calling linearRegression()
+ * on the usable subset of that window.
+ *
+ * The tables can also be grown one point at a time with begin()/push(); a
+ * window is ready to fit as soon as its last point has been pushed.
+ *
+ * Moments are taken relative to the first usable point so differences of
+ * large prefixes do not cancel catastrophically; how they are stored and
+ * combined is set by the Numerics policy (regression_numerics.h). The
+ * tables live in the arena passed to build()/begin() and are valid until
+ * that arena is rewound.
+ */
+template <class Numerics>
+class BasicWindowedRegression {
+public:
+    /**
+     * @brief Accumulate prefix sums for a curve
+     *
+     * @param x X-axis data
+     * @param y Y-axis data (same size as x)
+     * @param usable Per-point mask; zero entries are skipped
+     * @param arena Storage for the prefix tables
+     * @return false if the arena could not hold the tables
+     */
+    bool build(
+        ConstFloatSpan x,
+        ConstFloatSpan y,
+        Span<const uint8_t> usable,
+        ScratchArena& arena
+    );
+
+    /**
+     * @brief Start an empty table with room for `capacity` points
+     *
+     * @return false if the arena could not hold the tables
+     */
+    bool begin(size_t capacity, ScratchArena& arena);
+
+    /** Append one point; ignored once capacity is reached. */
+    void push(float x, float y, bool usable);
+
+    /** Number of points pushed so far. */
+    size_t size() const { return size_; }
+
+    /** Number of usable points in [start, end). */
+    size_t count(size_t start, size_t end) const {
+        return cnt_[end] - cnt_[start];
+    }
+
+    /** Index of the first usable point at or after i (size() if none yet). */
+    size_t firstUsable(size_t i) const { return i < pending_ ? next_[i] : size_; }
+
+    /** Index of the last usable point at or before i (capacity if none). */
+    size_t lastUsable(size_t i) const { return prev_[i]; }
+
+    /**
+     * @brief Fit y = slope * x + intercept over the usable points of [start, end)
+     *
+     * @return R² value (0-1); 0 with slope = 0 when fewer than 2 points or
+     *         the x values are degenerate
+     */
+    float fit(size_t start, size_t end, float& slope, float& intercept) const {
+        return (prefix_[end] - prefix_[start]).fit(
+            static_cast<uint32_t>(count(start, end)), x0_, y0_, slope, intercept);
+    }
+
+private:
+    using Moments = typename Numerics::Moments;
+
+    float  x0_ = 0.0f;
+    float  y0_ = 0.0f;
+    bool   centred_ = false;   ///< x0_/y0_ taken from the first usable point
+    size_t size_     = 0;
+    size_t capacity_ = 0;
+    size_t pending_  = 0;      ///< First index whose next_ entry is not known yet
+    Span<Moments>  prefix_;
+    Span<uint32_t> cnt_;
+    Span<uint32_t> next_, prev_;
+};
+
+/** Windowed regression with the build-selected numerics (numerics::Active). */
+using WindowedRegression = BasicWindowedRegression<numerics::Active>;
+
+/**
+ * @brief Sliding-window SS search fed one point at a time
+ *
+ * Holds the calculateSS() pipeline (3-point smoothing, log10, windowed
+ * regression, filters) in incremental form: every candidate window is
+ * scored as soon as its last point is known, so finish() only has to
+ * validate the best window. calculateSS() runs through this class too,
+ * which keeps the batch and streaming results bit-identical.
+ */
+template <class Numerics>
+class BasicSSScanner {
+public:
+    /**
+     * @brief Prepare for up to `capacity` points
+     *
+     * @return false if the arena could not hold the tables
+     */
+    bool begin(size_t capacity, ScratchArena& arena);
+
+    /** Append one (VGS, Ids) sample. */
+    void push(float vgs, float ids);
+
+    /** Score the last point and return the best window (invalid if < 10 points). */
+    SSResult finish();
+
+    /** Number of samples pushed so far. */
+    size_t size() const { return count_; }
+
+    /** VGS samples pushed so far. */
+    ConstFloatSpan vgs() const { return ConstFloatSpan(vgs_.data(), count_); }
+
+private:
+    void process(size_t i, float idsSmooth);
+
+    BasicWindowedRegression<Numerics> reg_;
+    FloatSpan vgs_;
+    FloatSpan logIds_;
+    size_t    count_ = 0;
+    float     prevIds_[2] = { 0.0f, 0.0f };  ///< Raw Ids at count_-2, count_-1
+    bool      ready_ = false;
+
+    float  bestR2_        = -1.0f;
+    float  bestSlope_     = 0.0f;
+    float  bestIntercept_ = 0.0f;
+    size_t bestStart_     = 0;
+    size_t bestWin_       = 0;
+};
+
+/** SS search with the build-selected numerics (numerics::Active). */
+using SSScanner = BasicSSScanner<numerics::Active>;
+
+namespace sg { struct Kernel; }
+
+/**
+ * @brief Per-curve Gm/Vt/SS analysis fed point by point during a sweep
+ *
+ * push() is called from the acquisition loop right after each reading. It
+ * emits the Savitzky-Golay Gm of every point whose window is complete and
+ * scores the SS windows that end at the new point, so the work is spread
+ * over the settling delays instead of piling up after the last VGS step.
+ * finish() only scales Gm by the final VGS step, evaluates the edge
+ * points, segments the curve once (segmentCurve()) and resolves Vt
+ * (calculateVt() plus every extractVt() method) from those regions.
+ *
+ * Results are identical to calculateGm() + segmentCurve() + the region
+ * and arena overloads of calculateVt()/extractVt(), with SS from the
+ * streamed whole-curve calculateSS() scan, or the region overload for the
+ * robust SSConfig methods. Configurations that cannot stream (moving-average Gm,
+ * or a curve cut shorter than the SG window) fall back to calculateGm() at
+ * finish(); so does SS for the robust SSConfig methods, which need the
+ * whole curve. All buffers come from the arena passed to begin().
+ */
+class CurveAnalyzer {
+public:
+    struct Result {
+        float        vt    = 0.0f;  ///< Threshold voltage (V), 0 if not found
+        float        maxGm = 0.0f;  ///< Peak transconductance (S)
+        SSResult     ss;            ///< Subthreshold swing and tangent line
+        VtResult     vtMethods;     ///< Vt by every extractVt() method
+        CurveRegions regions;       ///< Operating regions found by segmentCurve()
+    };
+
+    /**
+     * @brief Prepare for a curve of up to `capacity` points
+     *
+     * Needs scratchBytes(capacity) of arena.
+     *
+     * @return false if the arena could not hold the buffers; push() and
+     *         finish() then yield an empty result
+     */
+    bool begin(size_t capacity, ScratchArena& arena, const GmConfig& config = GmConfig(),
+               const VtConfig& vtConfig = VtConfig(), const SSConfig& ssConfig = SSConfig());
+
+    /** Append one (VGS, Ids) sample. */
+    void push(float vgs, float ids);
+
+    /** Complete the analysis of the pushed points. */
+    Result finish();
+
+    /** Number of samples pushed so far. */
+    size_t size() const { return count_; }
+
+    /** Gm per point; complete after finish(). */
+    ConstFloatSpan gm() const { return ConstFloatSpan(gm_.data(), count_); }
+
+private:
+    GmConfig          config_;
+    VtConfig          vtConfig_;
+    SSConfig          ssConfig_;
+    const sg::Kernel* kernel_ = nullptr;  ///< Streaming SG kernel, nullptr = batch Gm
+    ScratchArena*     arena_  = nullptr;
+    FloatSpan         vgs_;               ///< Robust SS methods only; the scanner keeps VGS otherwise
+    FloatSpan         ids_;
+    FloatSpan         gm_;
+    SSScanner         ss_;                ///< SSMethod::SlidingWindow only
+    size_t            count_ = 0;
+    bool              ready_ = false;
+};
+
+// ============================================================================
+// Bootstrap confidence intervals
+// ============================================================================
+
+/** Parameters for bootstrapCurve(). */
+struct BootstrapConfig {
+    uint16_t iterations    = 64;     ///< Resampled curves at most
+    uint16_t minIterations = 20;     ///< Fewer estimates leave an interval invalid
+    uint32_t seed          = 1;      ///< Resample sequence; fixed for repeatable intervals
+    uint32_t budgetUs      = 0;      ///< Wall-clock limit (µs); 0 = none
+    uint32_t (*clockUs)()  = nullptr; ///< Microsecond clock for budgetUs (e.g. micros)
+    /** Polled between resamples; returning true ends the run (e.g. new work queued). */
+    bool (*stopRequested)(void* context) = nullptr;
+    void*    context       = nullptr;
+    GmConfig gm;                     ///< Analysis applied to every resample,
+    VtConfig vt;                     ///< as for the measured curve
+    SSConfig ss;
+};
+
+/** Central 95% interval of one parameter over the resamples. */
+struct ConfidenceInterval {
+    bool     valid = false;  ///< At least BootstrapConfig::minIterations estimates
+    uint16_t n     = 0;      ///< Resamples that produced an estimate
+    float    lo    = 0.0f;   ///< 2.5th percentile
+    float    hi    = 0.0f;   ///< 97.5th percentile
+};
+
+struct BootstrapResult {
+    uint16_t iterations  = 0;      ///< Resamples analysed
+    bool     interrupted = false;  ///< Ended by budgetUs or stopRequested
+    ConfidenceInterval vt;         ///< Threshold voltage (V)
+    ConfidenceInterval ss;         ///< Subthreshold swing (mV/dec)
+    ConfidenceInterval maxGm;      ///< Peak transconductance (S)
+};
+
+/** Arena bytes bootstrapCurve() needs for a curve of `points` (includes scratchBytes()). */
+size_t bootstrapScratchBytes(size_t points, size_t iterations);
+
+/**
+ * @brief 95% intervals for Vt, SS and max Gm by wild residual bootstrap
+ *
+ * The curve is smoothed (Savitzky-Golay, window 5, order 2) and every
+ * resample adds the residual of each point back with a random sign:
+ * Ids*ᵢ = sᵢ ± (Idsᵢ − sᵢ)/√(1 − hᵢ), hᵢ being the smoother's leverage
+ * (17/35 inside the curve) that would otherwise leave the resampled noise
+ * ~30% too small. This keeps the VGS grid the derivative kernels
+ * assume and each point's own noise level, which spans decades along a
+ * transfer curve, so one shared residual pool would not fit. Each resample
+ * goes through CurveAnalyzer with the configured analysis; intervals are
+ * the percentiles of the resulting estimates. They describe the noise
+ * spread of each estimate, not its noise bias: max Gm (and Vt at the Gm
+ * peak) reads high on a noisy curve, and the interval sits high with it
+ * (bench/bootstrap_coverage_check.cpp).
+ *
+ * Runs until config.iterations, budgetUs or stopRequested, whichever comes
+ * first. Needs bootstrapScratchBytes(n, config.iterations) of arena and
+ * does not allocate.
+ */
+BootstrapResult bootstrapCurve(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ScratchArena& arena,
+    const BootstrapConfig& config = BootstrapConfig()
+);
+
+// ============================================================================
+// Compact model fit
+// ============================================================================
+
+/** Parameters for fitCompactModel(). */
+struct ModelFitConfig {
+    size_t   maxPoints     = 64;     ///< Curve is decimated to at most this many points
+    float    minCurrent    = 1e-9f;  ///< Points below this Ids (A) are left out of the fit
+    uint16_t maxIterations = 40;     ///< Levenberg–Marquardt iterations
+    uint32_t budgetUs      = 0;      ///< Wall-clock limit (µs); 0 = none
+    uint32_t (*clockUs)()  = nullptr; ///< Microsecond clock for budgetUs (e.g. micros)
+};
+
+/** Fitted compact-model parameters for one transfer curve. */
+struct ModelFit {
+    bool     valid      = false;  ///< Enough points and a finite fit
+    bool     converged  = false;  ///< Solver stopped on tolerance, not on a limit
+    bool     budgetHit  = false;  ///< Stopped by ModelFitConfig::budgetUs
+    float    vt    = 0.0f;        ///< Threshold voltage (V)
+    float    n     = 0.0f;        ///< Slope factor (SS = n·UT·ln10)
+    float    is    = 0.0f;        ///< Specific current (A)
+    float    theta = 0.0f;        ///< Mobility degradation (1/V)
+    float    rs    = 0.0f;        ///< Source series resistance (Ω)
+    float    rmsDecades = 0.0f;   ///< RMS of log10(Ids_model / Ids) over the fitted points
+    uint16_t iterations = 0;
+};
+
+/**
+ * @brief Fit an EKV compact model to a transfer curve
+ *
+ *   Ids = Is · (Lf² − Lr²) / (1 + θ·2nUT·Lf),   L(x) = ln(1 + eˣ)
+ *   Lf  = L((Vgs − Vt − n·Ids·Rs) / 2nUT),  Lr = L((Vgs − Vt − n·VDS) / 2nUT)
+ *
+ * Weak inversion, strong inversion (square law) and the linear/saturation
+ * transition are one expression; θ degrades mobility with overdrive and Rs
+ * debiases the source, solved implicitly per point. Residuals are taken
+ * in ln(Ids) so every decade weighs the same.
+ *
+ * The fit runs lm::solve<5> on stack matrices — no heap, no arena — over at
+ * most config.maxPoints points, bounded by maxIterations and budgetUs.
+ *
+ * @param vds Drain voltage of the curve (V)
+ * @param vtGuess Starting Vt (e.g. from calculateVt); 0 = middle of the sweep
+ * @param ssGuess Starting SS (mV/dec); 0 = 90 mV/dec
+ */
+ModelFit fitCompactModel(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    float vds,
+    float vtGuess,
+    float ssGuess,
+    const ModelFitConfig& config = ModelFitConfig()
+);
+
+// ============================================================================
+// Output curves (Id vs VDS at fixed VGS)
+// ============================================================================
+
+/** Parameters for OutputCurveAnalyzer. */
+struct OutputConfig {
+    size_t smoothingWindow = 5;     ///< SG window for gds = dIds/dVds (odd, 5-11)
+    float  satFraction     = 0.1f;  ///< Saturation starts where gds drops below this × 1/Ron
+};
+
+/**
+ * @brief Per-curve Ron / gds / Vdsat / λ analysis fed point by point
+ *
+ * The SWEEP_VDS counterpart of CurveAnalyzer. push() stores the sample,
+ * extends the prefix sums and emits the Savitzky-Golay gds of every point
+ * whose window is complete; finish() then works in O(n):
+ *   - Ron: 1 / gds at the first point, i.e. the slope at VDS → 0 of the
+ *     quadratic fitted to the first SG window (on an irregular VDS grid
+ *     gds is recomputed with a GridKernel, as CurveAnalyzer does for Gm)
+ *   - saturation onset: the first point whose gds is below
+ *     satFraction / Ron; Vdsat is the VDS where gds crosses that level,
+ *     interpolated between samples (≈ 0.9·Vov for a square-law device at
+ *     the default fraction)
+ *   - gds, λ: line Ids = Id0 · (1 + λ·VDS) fitted over the saturation
+ *     region; gds is its slope and λ = gds / Id0
+ *
+ * Fits use double moments whatever numerics::Active is: Ids is in amps,
+ * far below the resolution of the fixed-point policy. All buffers come
+ * from the arena; scratchBytes(capacity) is enough.
+ */
+class OutputCurveAnalyzer {
+public:
+    struct Result {
+        bool   valid     = false;  ///< Ron found (positive conductance at the first point)
+        bool   saturated = false;  ///< A saturation region of >= 3 points was found
+        float  ron    = 0.0f;      ///< Linear-region on-resistance (Ω)
+        float  gds    = 0.0f;      ///< Saturation output conductance (S)
+        float  vdsat  = 0.0f;      ///< Saturation onset (V)
+        float  lambda = 0.0f;      ///< Channel-length modulation (1/V)
+        size_t satStart = 0;       ///< First point of the saturation fit
+    };
+
+    /**
+     * @brief Prepare for a curve of up to `capacity` points
+     *
+     * @return false if the arena could not hold the buffers; push() and
+     *         finish() then yield an empty result
+     */
+    bool begin(size_t capacity, ScratchArena& arena, const OutputConfig& config = OutputConfig());
+
+    /** Append one (VDS, Ids) sample. */
+    void push(float vds, float ids);
+
+    /** Complete the analysis of the pushed points. */
+    Result finish();
+
+    /** Number of samples pushed so far. */
+    size_t size() const { return count_; }
+
+    /** gds per point; complete after finish(). */
+    ConstFloatSpan gds() const { return ConstFloatSpan(gds_.data(), count_); }
+
+private:
+    OutputConfig      config_;
+    const sg::Kernel* kernel_ = nullptr;
+    ScratchArena*     arena_  = nullptr;  ///< GridKernel for an irregular VDS grid
+    FloatSpan         vds_;
+    FloatSpan         ids_;
+    FloatSpan         gds_;
+    BasicWindowedRegression<numerics::Double> reg_;
+    size_t            count_ = 0;
+    bool              ready_ = false;
+};
+
+// ============================================================================
+// Family analysis (the VDS curves of one transfer sweep)
+// ============================================================================
+
+/**
+ * @brief DIBL, Vt(VDS) and SS(VDS) of a curve family, updated per curve
+ *
+ * add() takes the summary of one finished transfer curve and updates, in
+ * O(1) and without keeping any curve:
+ *   - DIBL = −ΔVt / ΔVDS between the lowest- and highest-VDS curves with a
+ *     Vt, the usual two-point definition
+ *   - dVt/dVDS: least-squares slope over every curve with a Vt, and its R²;
+ *     its negative is a DIBL estimate that uses the whole family
+ *   - dSS/dVDS: least-squares slope over every curve with an SS, and the
+ *     SS range
+ * Curves may arrive in any VDS order. Fits use double moments.
+ */
+class FamilyAnalyzer {
+public:
+    struct Result {
+        uint16_t curves    = 0;     ///< Curves added
+        uint16_t vtCurves  = 0;     ///< ... with a Vt
+        uint16_t ssCurves  = 0;     ///< ... with an SS
+        bool     diblValid = false; ///< Vt known at two different VDS
+        float    dibl      = 0.0f;  ///< Two-point DIBL (mV/V)
+        float    vdsLow    = 0.0f;  ///< Lowest VDS with a Vt (V)
+        float    vtLow     = 0.0f;  ///< ... and its Vt (V)
+        float    vdsHigh   = 0.0f;  ///< Highest VDS with a Vt (V)
+        float    vtHigh    = 0.0f;  ///< ... and its Vt (V)
+        float    vtSlope   = 0.0f;  ///< dVt/dVDS over all curves (mV/V)
+        float    vtSlopeR2 = 0.0f;
+        float    ssSlope   = 0.0f;  ///< dSS/dVDS over all curves (mV/dec per V)
+        float    ssMin     = 0.0f;  ///< (mV/dec)
+        float    ssMax     = 0.0f;  ///< (mV/dec)
+    };
+
+    /** Start a new family. */
+    void begin();
+
+    /**
+     * @brief Add one finished curve
+     *
+     * @param vtFound, ssFound false leave the curve out of the Vt or SS
+     *        statistics
+     */
+    void add(float vds, float vt, bool vtFound, float ss, bool ssFound);
+
+    const Result& result() const { return result_; }
+
+private:
+    using Moments = numerics::Double::Moments;
+
+    Moments vtMoments_;
+    Moments ssMoments_;
+    float   vtX0_ = 0.0f, vtY0_ = 0.0f;  ///< First Vt point; moments are centred on it
+    float   ssX0_ = 0.0f, ssY0_ = 0.0f;
+    Result  result_;
+};
+
+// ============================================================================
+// Golden-curve comparison
+// ============================================================================
+
+/** Pass limits for GoldenComparator; a limit of 0 is not checked. */
+struct GoldenTolerance {
+    float maxRmse = 0.0f;  ///< Largest RMSE of the residuals (A)
+    float minR2   = 0.0f;  ///< Smallest coefficient of determination
+    float maxChi2 = 0.0f;  ///< Largest reduced χ² (residuals normalised by |Ids|²)
+};
+
+enum class GoldenVerdict : uint8_t {
+    Incomplete,  ///< Fewer than 2 reference points were covered
+    Pass,
+    Fail
+};
+
+/**
+ * @brief Streaming comparison of a transfer curve against a reference
+ *
+ * The on-device counterpart of scripts/compare_iv.py: measured points are
+ * linearly interpolated onto the reference VGS grid as they arrive
+ * (ascending VGS), and the residuals ref − meas feed running sums for
+ *   - RMSE  = √(Σr² / N)
+ *   - R²    = 1 − Σr² / Σ(ref − mean ref)²
+ *   - χ²    = mean(r² / max(meas², 1e-15))
+ * with the script's definitions, so its numbers and these agree.
+ *
+ * push() is O(1) amortised and touches no heap. It returns false once the
+ * device has failed whatever the rest of the sweep brings: Σr² and
+ * Σr²/meas² only grow, so when either already exceeds its limit times the
+ * number of reference points the sweep will cover, the final RMSE or χ²
+ * cannot come back under it. R² has no such bound and is judged at the end.
+ */
+class GoldenComparator {
+public:
+    struct Stats {
+        size_t n    = 0;     ///< Reference points compared
+        float  rmse = 0.0f;  ///< (A)
+        float  r2   = 0.0f;
+        float  chi2 = 0.0f;
+        float  bias = 0.0f;  ///< Mean residual ref − meas (A)
+    };
+
+    /**
+     * @brief Compare the next curve against (refVgs, refIds)
+     *
+     * @param refVgs Reference grid, ascending; must outlive the comparison
+     * @param vgsStart, vgsEnd Planned sweep range; reference points inside
+     *        it are the ones the early-fail bound counts on
+     */
+    void begin(ConstFloatSpan refVgs, ConstFloatSpan refIds, const GoldenTolerance& tolerance,
+               float vgsStart, float vgsEnd);
+
+    /**
+     * @brief Add one measured (VGS, Ids) sample
+     *
+     * @return false once the curve can no longer pass
+     */
+    bool push(float vgs, float ids);
+
+    /** True once push() has reported a certain failure. */
+    bool failed() const { return failed_; }
+
+    Stats stats() const;
+
+    /** Verdict on the points compared so far. */
+    GoldenVerdict verdict() const;
+
+private:
+    void accumulate(float ref, float meas);
+
+    ConstFloatSpan  refVgs_;
+    ConstFloatSpan  refIds_;
+    GoldenTolerance tolerance_;
+    size_t next_     = 0;  ///< First reference point not yet reached
+    size_t expected_ = 0;  ///< Reference points inside the planned sweep
+    float  prevVgs_  = 0.0f;
+    float  prevIds_  = 0.0f;
+    bool   hasPrev_  = false;
+    bool   failed_   = false;
+
+    // Residual sums in double: currents span many decades
+    size_t n_ = 0;
+    double sumR_ = 0, sumR2_ = 0, sumChi2_ = 0;
+    double refMean_ = 0, refM2_ = 0;  ///< Welford mean / Σ(ref − mean)²
+};
+
 } // namespace math_engine
 
 #endif // MATH_ENGINE_H
@@ -7,6 +7,8 @@
 // Drives VDS and VGS through a configurable grid, reads the shunt ADC, and
 // streams each data point directly to FFat in a CSV file. The sweep runs on
 // a dedicated FreeRTOS task (Core 1) so it never blocks the HTTP server.
+// Completed transfer curves are handed to an analysis task on Core 0, so
+// acquisition of the next curve starts without waiting for Gm/Vt/SS.
 //
 // Typical usage:
 //   1. Call begin() once from setup().
@@ -18,6 +20,10 @@
 #include <FFat.h>
 #include <vector>
 #include "log_buffer.h"
+#include "math_engine.h"
+#include "golden_store.h"
+#include "spsc_queue.h"
+#include "oversampling.h"
 
 // Pin and HAL definitions live in hardware_hal.h.
 
@@ -42,10 +48,29 @@ struct SweepConfig {
     float rshunt;               ///< Shunt resistor (Ω); Ids = Vsh / Rshunt
     int   settling_ms;          ///< Wait after setting a new voltage before sampling (ms)
     uint16_t oversampling = 16; ///< ADC samples averaged per point (1 = off, 16 = default)
+    hal::OversamplingMethod oversampling_method = hal::OversamplingMethod::TrimmedMean; ///< How the samples are reduced
+    hal::AdaptiveOversampling adaptive; ///< Stop sampling a point once precise enough; `oversampling` is then the cap
     uint8_t  adc_gain     = 2;  ///< ADS1115 PGA gain selector: 0=±6.144V 1=±4.096V 2=±2.048V 4=±1.024V 8=±0.512V 16=±0.256V
+    bool     adc_autorange = false; ///< Pick the PGA range per point; adc_gain is the first point's range
+    bool     hybrid_adc    = false; ///< GPIO34 coarse read picks the range and skips clipped points (external HW)
+    float    hybrid_floor_v = 0.0f; ///< Hybrid: coarse readings below this skip the ADS1115 (0 = never)
     bool use_external_hw  = true; ///< true = MCP4725 + ADS1115; false = internal ESP32 peripherals
     String filename;            ///< Base filename (timestamp will be appended)
     SweepMode sweep_mode = SWEEP_VGS; ///< Which axis drives the inner loop
+    float vt_current = 1e-5f;   ///< Drain current defining the constant-current Vt (A)
+    math_engine::SSMethod ss_method = math_engine::SSMethod::SlidingWindow; ///< Subthreshold-swing estimator
+    uint16_t bootstrap_iterations = 0; ///< Bootstrap resamples per curve for Vt/SS/Gm intervals (0 = off)
+    String part_number;         ///< Golden reference to bin against (SWEEP_VGS); empty = no binning
+};
+
+// ----------------------------------------------------------------------------
+// BinResult — outcome of a sweep run against a golden reference
+// ----------------------------------------------------------------------------
+enum BinResult : uint8_t {
+    BIN_NONE,        ///< No part number, or no sweep has finished yet
+    BIN_PASS,        ///< Every compared curve within tolerance
+    BIN_FAIL,        ///< A curve out of tolerance (the sweep may have stopped early)
+    BIN_INCOMPLETE   ///< No curve of the sweep matched a reference VDS
 };
 
 // ----------------------------------------------------------------------------
@@ -118,6 +143,10 @@ public:
         String message;           ///< Human-readable status line
         bool   has_error;         ///< true if the sweep encountered a fatal error
         String error_message;     ///< Non-empty when has_error is true
+        BinResult bin;            ///< Result of the last binned sweep
+        uint32_t devices_tested;  ///< Binned sweeps completed since boot
+        uint32_t devices_passed;  ///< ... of which BIN_PASS
+        math_engine::FamilyAnalyzer::Result family;  ///< DIBL / Vt(VDS) / SS(VDS) of the current or last transfer sweep
     };
 
     /** Returns a copy of the current progress state. Thread-safe. */
@@ -129,8 +158,9 @@ public:
 private:
     void   performSweep();
     static void measurementTaskWrapper(void* param);
+    static void analysisTaskWrapper(void* param);
 
-    float readAnalogVoltage();
+    float readAnalogVoltage(uint16_t& samples, float& fullScale);
     bool  openMeasurementFile();
     void  closeMeasurementFile();
 
@@ -141,7 +171,8 @@ private:
     TaskHandle_t     taskHandle_ = nullptr;
 
     // Per-VDS curve data collected during a SWEEP_VGS pass.
-    // Flushed to disk after calculateCurveParams() and then cleared.
+    // Filled by the measurement task, analysed by the analysis task, then
+    // its summary line is written and the slot is reused for a later curve.
     struct CurveData {
         float vds;      ///< Fixed VDS for this curve (V)
         float vt;       ///< Threshold voltage (V)
@@ -158,12 +189,64 @@ private:
         // Tangent line endpoints in (VGS, log10(Ids)) space for dashboard overlay
         float ss_x1 = 0, ss_y1 = 0;
         float ss_x2 = 0, ss_y2 = 0;
-    };
 
-    void calculateCurveParams(CurveData& curve);
-    void writeEnhancedCSV(const std::vector<CurveData>& results);
+        math_engine::VtResult vt_methods;  ///< Vt by every extraction method, with flags
+        math_engine::CurveRegions regions; ///< Operating-region boundaries, segmented once per curve
+        math_engine::ModelFit model;       ///< EKV compact-model parameters
+        math_engine::BootstrapResult bootstrap; ///< 95% intervals; empty unless bootstrap_iterations > 0
+
+        /** Reserve capacity for `points` samples in every per-point vector. */
+        void reserve(size_t points);
+        /** Reset all fields while keeping the reserved vector capacity. */
+        void clear();
+    };
 
-    std::vector<CurveData> results_buffer_;
+    void calculateCurveParams(CurveData& curve, math_engine::CurveAnalyzer& analyzer);
+
+    // ---- Curve analysis handoff (Core 1 -> Core 0) -------------------------
+    // Single producer (measurement task) / single consumer (analysis task).
+    // Slots are owned by the producer until submitted and handed back through
+    // finishedCurves_, so no buffer is ever touched by both tasks at once.
+
+    /** Analysis task body: analyse every submitted curve, hand it back. */
+    void analysisLoop();
+    /** Run CurveAnalyzer over a completed curve (analysis task, or inline fallback). */
+    void analyzeCurve(CurveData& curve);
+    /** Bootstrap intervals for an analysed curve; stops as soon as another curve is queued. */
+    void bootstrapCurve(CurveData& curve);
+    /** BootstrapConfig::stopRequested callback; `controller` is this. */
+    static bool bootstrapShouldStop(void* controller);
+    /** Free slot for the next curve; writes finished curves while waiting for one. */
+    CurveData* acquireCurveSlot();
+    /** Queue a completed curve for analysis and wake the analysis task. */
+    void submitCurve(CurveData* curve);
+    /** Write the "# VDS=" line of every analysed curve, add it to family_ and release its slot. */
+    void writeFinishedCurves();
+    /** Copy family_'s result where getProgress() can read it. */
+    void publishFamily();
+    /** Write the "# Family:" footer of a transfer sweep. */
+    void writeFamilyFooter();
+
+    static const uint8_t CURVE_SLOTS = 2;  ///< One curve acquiring, one being analysed
+
+    CurveData curveSlots_[CURVE_SLOTS];
+    bool      slotBusy_[CURVE_SLOTS] = {};  ///< Measurement-task bookkeeping only
+    uint8_t   curvesInFlight_ = 0;          ///< Submitted but not yet written
+    SpscQueue<uint8_t, CURVE_SLOTS> pendingCurves_;   ///< Measurement -> analysis
+    SpscQueue<uint8_t, CURVE_SLOTS> finishedCurves_;  ///< Analysis -> measurement
+    math_engine::ScratchArena analysisArena_;         ///< Sized per sweep, used by analyzeCurve()
+    TaskHandle_t analysisTaskHandle_ = nullptr;
+
+    // ---- Golden-reference binning (measurement task only) ------------------
+    GoldenFamily                  golden_;      ///< Reference loaded for config_.part_number
+    math_engine::GoldenComparator comparator_;  ///< Compares the curve being acquired
+    volatile BinResult binResult_     = BIN_NONE;
+    volatile uint32_t  devicesTested_ = 0;
+    volatile uint32_t  devicesPassed_ = 0;
+
+    // ---- Family analysis (measurement task; snapshot guarded by mutex_) ----
+    math_engine::FamilyAnalyzer         family_;
+    math_engine::FamilyAnalyzer::Result familySnapshot_;
 
     volatile float currentVds_      = 0.0f;
     volatile int   progressPercent_ = 0;
@@ -0,0 +1,185 @@
+#ifndef OVERSAMPLING_H
+#define OVERSAMPLING_H
+
+#include <algorithm>
+#include <cstdint>
+
+// ============================================================================
+// Oversampling estimators — N raw ADC codes → one averaged code
+// ============================================================================
+// Shared by InternalADC and ExternalADC; the estimator is chosen per sweep
+// (HalConfig::adc_method, "oversampling_method" in /api/start).
+//
+//   TrimmedMean   Two quickselects place the 10% and 90% cut points, then
+//                 the central 80% is summed. Average O(n); same result as
+//                 sorting and trimming (the former insertion sort, O(n²)).
+//   Histogram     The same trimmed mean, with the samples ordered by an LSD
+//                 radix sort: one counting histogram per digit (6 bits when
+//                 the samples differ only in their low 12 bits, else 8), and
+//                 a digit equal in every sample is skipped. O(n), no
+//                 comparisons.
+//   MinMaxReject  Streaming: the running sum minus the single lowest and
+//                 highest sample. No sample buffer; rejects one spike per
+//                 side instead of 10%.
+//
+// With AdaptiveOversampling enabled the sample count becomes a cap: a
+// SequentialMean follows the samples as they arrive and sampling stops once
+// the standard error of the mean reaches the target precision. Quiet points
+// (e.g. large shunt voltages in saturation) then take a few conversions and
+// noisy subthreshold points the full count. The estimator above still
+// reduces whatever was collected.
+//
+// Portable (no Arduino dependency) so bench/oversampling_bench.cpp times the
+// same code on host.
+// ============================================================================
+
+namespace hal {
+
+const uint16_t OVERSAMPLING_MAX_SAMPLES  = 256;  ///< Upper bound of setOversamplingCount()
+const uint16_t OVERSAMPLING_TRIM_DIVISOR = 10;   ///< Trim n/10 samples from each end
+
+enum class OversamplingMethod : uint8_t {
+    TrimmedMean  = 0,  ///< Quickselect trimmed mean, 10% each side (default)
+    Histogram    = 1,  ///< Radix-sorted trimmed mean, 10% each side
+    MinMaxReject = 2,  ///< Streaming mean without the extreme samples
+};
+
+inline const char* oversamplingMethodName(OversamplingMethod method) {
+    switch (method) {
+        case OversamplingMethod::Histogram:    return "histogram";
+        case OversamplingMethod::MinMaxReject: return "minmax";
+        default:                               return "trimmed";
+    }
+}
+
+/** Mean of the central samples, 10% off each end. Reorders `samples`. */
+inline float trimmedMeanSelect(uint16_t* samples, uint16_t n) {
+    if (n == 0) return 0.0f;
+    const uint16_t trim = n / OVERSAMPLING_TRIM_DIVISOR;
+    uint16_t* lo = samples + trim;
+    uint16_t* hi = samples + (n - trim);
+    if (trim > 0) {
+        std::nth_element(samples, lo, samples + n);  // [0, trim) ≤ *lo ≤ [trim, n)
+        std::nth_element(lo, hi, samples + n);       // [trim, n - trim) ≤ *hi ≤ rest
+    }
+    uint32_t sum = 0;
+    for (const uint16_t* p = lo; p < hi; ++p) sum += *p;
+    return static_cast<float>(sum) / (n - 2 * trim);
+}
+
+/** Same estimate as trimmedMeanSelect(), ordering by radix sort. Reorders `samples`. */
+inline float trimmedMeanHistogram(uint16_t* samples, uint16_t n) {
+    if (n == 0) return 0.0f;
+    if (n > OVERSAMPLING_MAX_SAMPLES) n = OVERSAMPLING_MAX_SAMPLES;
+
+    // Bits that differ between samples decide which digit passes are needed
+    uint16_t differ = 0;
+    for (uint16_t i = 1; i < n; i++) differ |= samples[i] ^ samples[0];
+
+    // 12-bit spreads sort in two 6-bit digits (64 buckets), wider ones in bytes
+    const uint8_t  bits    = (differ < 0x1000) ? 6 : 8;
+    const uint16_t buckets = 1u << bits;
+    const uint16_t mask    = buckets - 1;
+
+    uint16_t  scratch[OVERSAMPLING_MAX_SAMPLES];
+    uint16_t* src = samples;
+    uint16_t* dst = scratch;
+    for (uint8_t shift = 0; (differ >> shift) != 0; shift += bits) {
+        if (((differ >> shift) & mask) == 0) continue;
+
+        uint16_t count[256];
+        for (uint16_t b = 0; b < buckets; b++) count[b] = 0;
+        for (uint16_t i = 0; i < n; i++) count[(src[i] >> shift) & mask]++;
+        uint16_t offset = 0;
+        for (uint16_t b = 0; b < buckets; b++) { const uint16_t c = count[b]; count[b] = offset; offset += c; }
+        for (uint16_t i = 0; i < n; i++) dst[count[(src[i] >> shift) & mask]++] = src[i];
+
+        uint16_t* t = src; src = dst; dst = t;
+    }
+
+    const uint16_t trim = n / OVERSAMPLING_TRIM_DIVISOR;
+    uint32_t sum = 0;
+    for (uint16_t i = trim; i < n - trim; i++) sum += src[i];
+    return static_cast<float>(sum) / (n - 2 * trim);
+}
+
+/** Running mean that leaves out the lowest and highest sample (from 3 samples on). */
+class MinMaxRejectMean {
+public:
+    void add(uint16_t code) {
+        sum_ += code;
+        if (code < min_) min_ = code;
+        if (code > max_) max_ = code;
+        count_++;
+    }
+
+    float mean() const {
+        if (count_ == 0) return 0.0f;
+        if (count_ < 3)  return static_cast<float>(sum_) / count_;
+        return static_cast<float>(sum_ - min_ - max_) / (count_ - 2);
+    }
+
+private:
+    uint32_t sum_   = 0;
+    uint16_t min_   = 0xFFFF;
+    uint16_t max_   = 0;
+    uint16_t count_ = 0;
+};
+
+struct AdaptiveOversampling {
+    bool     enabled      = false;
+    uint16_t minSamples   = 4;       ///< Samples before the first stop check (at least 2)
+    float    relPrecision = 0.002f;  ///< Target standard error / |mean|
+    float    absPrecision = 0.0f;    ///< Target standard error in volts (dominates near 0 V)
+};
+
+/** Running mean and variance of ADC codes (Welford). */
+class SequentialMean {
+public:
+    void add(uint16_t code) {
+        count_++;
+        const float delta = code - mean_;
+        mean_ += delta / count_;
+        m2_   += delta * (code - mean_);
+    }
+
+    uint16_t count() const    { return count_; }
+    float    mean() const     { return mean_; }
+    float    variance() const { return count_ > 1 ? m2_ / (count_ - 1) : 0.0f; }
+
+    /**
+     * @brief True once the standard error of the mean is within the target
+     * @param absCodes `adaptive.absPrecision` converted to codes by the caller
+     */
+    bool precise(const AdaptiveOversampling& adaptive, float absCodes) const {
+        const uint16_t minSamples = adaptive.minSamples < 2 ? 2 : adaptive.minSamples;
+        if (count_ < minSamples) return false;
+        const float relCodes = adaptive.relPrecision * (mean_ < 0.0f ? -mean_ : mean_);
+        const float target   = relCodes > absCodes ? relCodes : absCodes;
+        return variance() <= target * target * count_;  // σ²/n ≤ target²
+    }
+
+private:
+    uint16_t count_ = 0;
+    float    mean_  = 0.0f;
+    float    m2_    = 0.0f;
+};
+
+/** Averaged code of `n` samples under `method`. May reorder `samples`. */
+inline float reduceSamples(OversamplingMethod method, uint16_t* samples, uint16_t n) {
+    switch (method) {
+        case OversamplingMethod::Histogram:
+            return trimmedMeanHistogram(samples, n);
+        case OversamplingMethod::MinMaxReject: {
+            MinMaxRejectMean acc;
+            for (uint16_t i = 0; i < n; i++) acc.add(samples[i]);
+            return acc.mean();
+        }
+        default:
+            return trimmedMeanSelect(samples, n);
+    }
+}
+
+} // namespace hal
+
+#endif // OVERSAMPLING_H
@@ -0,0 +1,80 @@
+#ifndef PGA_AUTORANGE_H
+#define PGA_AUTORANGE_H
+
+#include <cstdint>
+
+// ============================================================================
+// ADS1115 PGA auto-ranging
+// ============================================================================
+// A transfer sweep spans several decades of Ids: a gain that resolves the
+// subthreshold shunt voltage clips in saturation, and one that fits
+// saturation leaves subthreshold points a few LSB wide. With auto-ranging
+// ExternalADC picks the range of each point from the previous reading:
+//
+//   widen    the reading is above PGA_WIDEN_FRACTION of the current FSR, or
+//            a sample clipped (the point is then read again one range wider)
+//   narrow   the reading would sit below PGA_NARROW_FRACTION of the next
+//            narrower FSR
+//
+// Narrowing needs 80% of a narrower range, widening 90% of the current one,
+// so a reading near a boundary stays where it is instead of flapping from
+// point to point. Ranges are in the "adc_gain" code order of /api/start.
+//
+// Portable (no Arduino dependency) so bench/pga_autorange_bench.cpp runs the
+// same decisions on host.
+// ============================================================================
+
+namespace hal {
+
+struct PgaRange {
+    uint8_t code;  ///< "adc_gain" code: 0, 1, 2, 4, 8, 16
+    float   fsr;   ///< Full-scale input, volts
+};
+
+/** Widest first. */
+const PgaRange PGA_RANGES[] = {
+    {  0, 6.144f },
+    {  1, 4.096f },
+    {  2, 2.048f },
+    {  4, 1.024f },
+    {  8, 0.512f },
+    { 16, 0.256f },
+};
+const uint8_t PGA_RANGE_COUNT       = sizeof(PGA_RANGES) / sizeof(PGA_RANGES[0]);
+const float   PGA_WIDEN_FRACTION    = 0.90f;  ///< Of the current FSR
+const float   PGA_NARROW_FRACTION   = 0.80f;  ///< Of the next narrower FSR
+
+/** Index in PGA_RANGES of a gain code; unknown codes map to ±0.256 V, as setGain() does. */
+inline uint8_t pgaRangeIndex(uint8_t code) {
+    for (uint8_t i = 0; i < PGA_RANGE_COUNT; i++) {
+        if (PGA_RANGES[i].code == code) return i;
+    }
+    return PGA_RANGE_COUNT - 1;
+}
+
+/**
+ * @brief Range for the next point, given the last reading at range `index`
+ * @param volts   Last reading (magnitude is used)
+ * @param clipped A sample of the last reading hit positive full scale
+ */
+inline uint8_t pgaNextRange(uint8_t index, float volts, bool clipped) {
+    const float v = volts < 0.0f ? -volts : volts;
+    if (clipped || v > PGA_WIDEN_FRACTION * PGA_RANGES[index].fsr) {
+        return index > 0 ? index - 1 : index;
+    }
+    // Skip straight to the narrowest range the reading fits (e.g. after cut-off)
+    while (index + 1 < PGA_RANGE_COUNT && v < PGA_NARROW_FRACTION * PGA_RANGES[index + 1].fsr) index++;
+    return index;
+}
+
+/** Narrowest range holding `volts` within PGA_NARROW_FRACTION (range from an estimate, e.g. HybridADC's coarse read). */
+inline uint8_t pgaRangeFor(float volts) {
+    const float v = volts < 0.0f ? -volts : volts;
+    uint8_t index = 0;
+    while (index + 1 < PGA_RANGE_COUNT && v < PGA_NARROW_FRACTION * PGA_RANGES[index + 1].fsr) index++;
+    return index;
+}
+
+} // namespace hal
+
+#endif // PGA_AUTORANGE_H
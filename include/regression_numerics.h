@@ -0,0 +1,328 @@
+#ifndef REGRESSION_NUMERICS_H
+#define REGRESSION_NUMERICS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Regression numerics policies
+// ============================================================================
+// The ESP32 FPU is single precision only, so every double add/multiply in a
+// least-squares fit is a software routine. The regression code is templated
+// on a policy that decides how the moments Σdx, Σdy, Σdxdy, Σdx², Σdy² are
+// accumulated and turned into slope / intercept / R²:
+//
+//   Double           — double sums; the reference path and the default
+//   CompensatedFloat — float sums with Neumaier compensation, each kept as a
+//                      (hi, lo) pair; products, prefix differences and the
+//                      fit itself keep the low part too (~48 bits)
+//   Fixed<F>         — samples quantised to Q.F, exact int64 sums; prefix
+//                      differences are exact, final ratios taken in float
+//
+// Samples are accumulated relative to an origin (x0, y0) chosen by the
+// caller — the first usable point for prefix tables, the sample mean for
+// a one-off fit — which keeps the sums small.
+//
+// Moments support subtraction, so a table of running Moments gives the
+// moments of any window as the difference of two entries.
+//
+// The SS search uses numerics::Active, picked at build time with
+// -DMATH_ENGINE_NUMERICS=0 (Double), 1 (CompensatedFloat) or 2 (Fixed<16>).
+// Measure accuracy on representative curves before changing it (see
+// bench/regression_numerics_bench.cpp).
+// ============================================================================
+
+#ifndef MATH_ENGINE_NUMERICS
+#define MATH_ENGINE_NUMERICS 0
+#endif
+
+namespace math_engine {
+namespace numerics {
+
+// ----------------------------------------------------------------------------
+// Double — reference path
+// ----------------------------------------------------------------------------
+struct Double {
+    static const char* name() { return "double"; }
+
+    struct Moments {
+        double sx = 0, sy = 0, sxy = 0, sxx = 0, syy = 0;
+
+        void add(float x, float y, float x0, float y0) {
+            const double dx = x - static_cast<double>(x0);
+            const double dy = y - static_cast<double>(y0);
+            sx  += dx;
+            sy  += dy;
+            sxy += dx * dy;
+            sxx += dx * dx;
+            syy += dy * dy;
+        }
+
+        Moments operator-(const Moments& o) const {
+            Moments d;
+            d.sx  = sx  - o.sx;
+            d.sy  = sy  - o.sy;
+            d.sxy = sxy - o.sxy;
+            d.sxx = sxx - o.sxx;
+            d.syy = syy - o.syy;
+            return d;
+        }
+
+        /** Fit n accumulated points; returns R² (0 with slope = 0 if degenerate). */
+        float fit(uint32_t n, float x0, float y0, float& slope, float& intercept) const {
+            if (n < 2) {
+                slope = 0;
+                intercept = 0;
+                return 0;
+            }
+
+            // Both terms are translation-invariant, so the centred sums give
+            // the same slope and degeneracy test as a fit on raw data.
+            const double sxyN = n * sxy - sx * sy;
+            const double sxxN = n * sxx - sx * sx;
+            const double syyN = n * syy - sy * sy;
+
+            if (fabs(sxxN) < 1e-12) {
+                slope = 0;
+                intercept = static_cast<float>(sy / n + y0);
+                return 0;
+            }
+
+            slope = static_cast<float>(sxyN / sxxN);
+            intercept = static_cast<float>((sy - slope * sx) / n + y0 - slope * static_cast<double>(x0));
+
+            // R² = Sxy² / (Sxx·Syy) for an ordinary least-squares line
+            if (syyN / n < 1e-12) return 1.0f;
+            return static_cast<float>((sxyN * sxyN) / (sxxN * syyN));
+        }
+    };
+};
+
+// ----------------------------------------------------------------------------
+// CompensatedFloat — single-precision FPU only
+// ----------------------------------------------------------------------------
+/**
+ * Every quantity that cancels is a float pair (hi, lo) worth ~48 bits:
+ * products enter the sums with their exact rounding error (fmaf, a single
+ * madd.s on the ESP32), window differences and centring keep the error of
+ * each subtraction (TwoSum), and R² is formed as 1 − Sres/Syy from a
+ * residual sum carried the same way, so near-equal windows are ranked
+ * about as finely as with double sums.
+ */
+struct CompensatedFloat {
+    static const char* name() { return "compensated float"; }
+
+    /** Neumaier-compensated running sum; value = hi + lo. */
+    struct Sum {
+        float hi = 0, lo = 0;
+
+        void add(float v) {
+            const float t = hi + v;
+            if (fabsf(hi) >= fabsf(v)) lo += (hi - t) + v;
+            else                       lo += (v - t) + hi;
+            hi = t;
+        }
+
+        /** Add a·b together with the rounding error of the product. */
+        void addProduct(float a, float b) {
+            const float p = a * b;
+            add(p);
+            lo += fmaf(a, b, -p);
+        }
+
+        /** Window difference: the rounding error of hi − o.hi goes to lo. */
+        Sum operator-(const Sum& o) const {
+            Sum d = twoSum(hi, -o.hi);
+            d.lo += lo - o.lo;
+            return d;
+        }
+
+        float value() const { return hi + lo; }
+    };
+
+    // Pair arithmetic (Dekker / Knuth); results are normalised, |lo| ≤ ulp(hi)/2
+    static Sum twoSum(float a, float b) {
+        Sum r;
+        r.hi = a + b;
+        const float bv = r.hi - a;
+        r.lo = (a - (r.hi - bv)) + (b - bv);
+        return r;
+    }
+
+    static Sum normalise(const Sum& a) {
+        Sum r;
+        r.hi = a.hi + a.lo;
+        r.lo = a.lo - (r.hi - a.hi);
+        return r;
+    }
+
+    static Sum sub(const Sum& a, const Sum& b) { return normalise(a - b); }
+
+    static Sum mul(const Sum& a, const Sum& b) {
+        Sum r;
+        r.hi = a.hi * b.hi;
+        r.lo = fmaf(a.hi, b.hi, -r.hi) + (a.hi * b.lo + a.lo * b.hi);
+        return normalise(r);
+    }
+
+    static Sum div(const Sum& a, const Sum& b) {
+        Sum q;
+        q.hi = a.hi / b.hi;
+        Sum qb;
+        qb.hi = q.hi;
+        const Sum r = sub(a, mul(qb, b));
+        q.lo = r.hi / b.hi;
+        return normalise(q);
+    }
+
+    /** Σab − Σa·Σb/n, the centred second moment, as a pair. */
+    static Sum centred(const Sum& ab, const Sum& a, const Sum& b, float fn) {
+        Sum n;
+        n.hi = fn;
+        return sub(normalise(ab), div(mul(normalise(a), normalise(b)), n));
+    }
+
+    struct Moments {
+        Sum sx, sy, sxy, sxx, syy;
+
+        void add(float x, float y, float x0, float y0) {
+            const float dx = x - x0;
+            const float dy = y - y0;
+            sx.add(dx);
+            sy.add(dy);
+            sxy.addProduct(dx, dy);
+            sxx.addProduct(dx, dx);
+            syy.addProduct(dy, dy);
+        }
+
+        Moments operator-(const Moments& o) const {
+            Moments d;
+            d.sx  = sx  - o.sx;
+            d.sy  = sy  - o.sy;
+            d.sxy = sxy - o.sxy;
+            d.sxx = sxx - o.sxx;
+            d.syy = syy - o.syy;
+            return d;
+        }
+
+        float fit(uint32_t n, float x0, float y0, float& slope, float& intercept) const {
+            if (n < 2) {
+                slope = 0;
+                intercept = 0;
+                return 0;
+            }
+
+            const float fn  = static_cast<float>(n);
+            const float Sx  = sx.value();
+            const float Sy  = sy.value();
+
+            // Centred second moments: Σ(dx - mean)² etc.
+            const Sum Sxy = centred(sxy, sx, sy, fn);
+            const Sum Sxx = centred(sxx, sx, sx, fn);
+            const Sum Syy = centred(syy, sy, sy, fn);
+
+            if (!(Sxx.hi > 1e-12f)) {
+                slope = 0;
+                intercept = Sy / fn + y0;
+                return 0;
+            }
+
+            const Sum b = div(Sxy, Sxx);
+            slope = b.value();
+            intercept = (Sy - slope * Sx) / fn + y0 - slope * x0;
+
+            if (!(Syy.hi / fn > 1e-12f)) return 1.0f;
+            // Sres = Syy − b·Sxy: small next to Syy on a good window, so it
+            // is taken from the pairs rather than from a rounded R²
+            const float r2 = 1.0f - sub(Syy, mul(b, Sxy)).value() / Syy.value();
+            return r2 > 1.0f ? 1.0f : r2;
+        }
+    };
+};
+
+// ----------------------------------------------------------------------------
+// Fixed<F> — integer sums on Q.F samples
+// ----------------------------------------------------------------------------
+/**
+ * Centred samples must satisfy |dx|, |dy| < 2^(31-F); with F = 16 that is
+ * ±32768 V / decades. Sums are exact while n·Σd² stays below 2^63, i.e. up
+ * to ~1000 points spanning 16 V / 16 decades — far beyond one SS window.
+ */
+template <unsigned FracBits = 16>
+struct Fixed {
+    static const char* name() { return "fixed point"; }
+
+    static int32_t toQ(float v) {
+        return static_cast<int32_t>(lrintf(v * static_cast<float>(1UL << FracBits)));
+    }
+
+    struct Moments {
+        int64_t sx = 0, sy = 0, sxy = 0, sxx = 0, syy = 0;
+
+        void add(float x, float y, float x0, float y0) {
+            const int64_t dx = toQ(x) - toQ(x0);
+            const int64_t dy = toQ(y) - toQ(y0);
+            sx  += dx;
+            sy  += dy;
+            sxy += dx * dy;
+            sxx += dx * dx;
+            syy += dy * dy;
+        }
+
+        Moments operator-(const Moments& o) const {
+            Moments d;
+            d.sx  = sx  - o.sx;
+            d.sy  = sy  - o.sy;
+            d.sxy = sxy - o.sxy;
+            d.sxx = sxx - o.sxx;
+            d.syy = syy - o.syy;
+            return d;
+        }
+
+        float fit(uint32_t n, float x0, float y0, float& slope, float& intercept) const {
+            if (n < 2) {
+                slope = 0;
+                intercept = 0;
+                return 0;
+            }
+
+            const float unit = 1.0f / static_cast<float>(1UL << FracBits);
+            const float fn   = static_cast<float>(n);
+
+            // n·Σdxdy − ΣdxΣdy is exact in int64; only the ratios are rounded
+            const int64_t sxyN = static_cast<int64_t>(n) * sxy - sx * sy;
+            const int64_t sxxN = static_cast<int64_t>(n) * sxx - sx * sx;
+            const int64_t syyN = static_cast<int64_t>(n) * syy - sy * sy;
+
+            if (sxxN <= 0) {
+                slope = 0;
+                intercept = static_cast<float>(sy) * unit / fn + y0;
+                return 0;
+            }
+
+            slope = static_cast<float>(sxyN) / static_cast<float>(sxxN);
+            intercept = (static_cast<float>(sy) - slope * static_cast<float>(sx)) * unit / fn
+                      + y0 - slope * x0;
+
+            if (syyN <= 0) return 1.0f;
+            const float r = static_cast<float>(sxyN);
+            return (r / static_cast<float>(sxxN)) * (r / static_cast<float>(syyN));
+        }
+    };
+};
+
+#if MATH_ENGINE_NUMERICS == 0
+using Active = Double;
+#elif MATH_ENGINE_NUMERICS == 1
+using Active = CompensatedFloat;
+#elif MATH_ENGINE_NUMERICS == 2
+using Active = Fixed<16>;
+#else
+#error "MATH_ENGINE_NUMERICS must be 0 (double), 1 (compensated float) or 2 (fixed point)"
+#endif
+
+} // namespace numerics
+} // namespace math_engine
+
+#endif // REGRESSION_NUMERICS_H
@@ -0,0 +1,198 @@
+#ifndef SAVITZKY_GOLAY_H
+#define SAVITZKY_GOLAY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Savitzky-Golay kernel design (compile time)
+// ============================================================================
+// A Savitzky-Golay filter fits a polynomial of degree `Order` to every
+// `Window`-point neighbourhood by least squares and evaluates the fit (or one
+// of its derivatives) at the centre. The fit is linear in the samples, so it
+// reduces to a fixed set of convolution weights:
+//
+//   P = (JᵀJ)⁻¹ Jᵀ          J[k][j] = (k - half)^j
+//   weight_D[k] = D! · P[D][k]
+//
+// P is solved here with constexpr Gauss-Jordan elimination, so the ESP32 only
+// ever sees the finished float tables in flash — no runtime matrix inversion.
+// The full projection P is kept as well; it lets the edge points (where a
+// centred window does not fit) be evaluated from the nearest full window's
+// polynomial with a short dot product.
+// ============================================================================
+
+namespace math_engine {
+namespace sg {
+
+constexpr size_t MIN_WINDOW = 5;
+constexpr size_t MAX_WINDOW = 11;
+constexpr size_t MIN_ORDER  = 2;
+constexpr size_t MAX_ORDER  = 4;
+constexpr size_t MAX_DERIV  = 2;
+
+namespace detail {
+
+constexpr double absd(double v) { return v < 0 ? -v : v; }
+
+constexpr double ipow(double base, size_t exp) {
+    double r = 1.0;
+    for (size_t i = 0; i < exp; i++) r *= base;
+    return r;
+}
+
+constexpr double factorial(size_t n) {
+    double r = 1.0;
+    for (size_t i = 2; i <= n; i++) r *= i;
+    return r;
+}
+
+/** Least-squares projection P = (JᵀJ)⁻¹Jᵀ, row-major (Order+1) x Window. */
+template <size_t Window, size_t Order>
+constexpr std::array<float, (Order + 1) * Window> projection() {
+    constexpr size_t P    = Order + 1;
+    constexpr int    half = static_cast<int>(Window / 2);
+
+    // Augmented system [JᵀJ | Jᵀ], reduced in place to [I | P]
+    double a[P][P + Window] = {};
+    for (size_t i = 0; i < P; i++) {
+        for (size_t j = 0; j < P; j++) {
+            for (int k = -half; k <= half; k++) a[i][j] += ipow(k, i + j);
+        }
+        for (int k = -half; k <= half; k++) a[i][P + k + half] = ipow(k, i);
+    }
+
+    for (size_t col = 0; col < P; col++) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < P; r++) {
+            if (absd(a[r][col]) > absd(a[pivot][col])) pivot = r;
+        }
+        for (size_t c = 0; c < P + Window; c++) {
+            double t = a[col][c]; a[col][c] = a[pivot][c]; a[pivot][c] = t;
+        }
+        const double inv = 1.0 / a[col][col];
+        for (size_t c = 0; c < P + Window; c++) a[col][c] *= inv;
+        for (size_t r = 0; r < P; r++) {
+            if (r == col) continue;
+            const double f = a[r][col];
+            for (size_t c = 0; c < P + Window; c++) a[r][c] -= f * a[col][c];
+        }
+    }
+
+    std::array<float, P * Window> out = {};
+    for (size_t i = 0; i < P; i++) {
+        for (size_t k = 0; k < Window; k++) out[i * Window + k] = static_cast<float>(a[i][P + k]);
+    }
+    return out;
+}
+
+/** Centre-point weights for derivative Deriv (all zero when Deriv > Order). */
+template <size_t Window, size_t Order, size_t Deriv>
+constexpr std::array<float, Window> centerWeights() {
+    std::array<float, Window> out = {};
+    if (Deriv > Order) return out;
+    constexpr auto p = projection<Window, Order>();
+    for (size_t k = 0; k < Window; k++) {
+        out[k] = static_cast<float>(factorial(Deriv) * p[Deriv * Window + k]);
+    }
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief Compile-time Savitzky-Golay design for one (window, order) pair
+ *
+ * All members are constexpr tables; instantiating the template costs only
+ * flash, never CPU time on the target.
+ */
+template <size_t Window, size_t Order>
+struct Design {
+    static_assert(Window % 2 == 1, "Savitzky-Golay window must be odd");
+    static_assert(Order < Window, "Polynomial order must be below the window size");
+
+    static constexpr std::array<float, (Order + 1) * Window> proj =
+        detail::projection<Window, Order>();
+    static constexpr std::array<float, Window> d0 = detail::centerWeights<Window, Order, 0>();
+    static constexpr std::array<float, Window> d1 = detail::centerWeights<Window, Order, 1>();
+    static constexpr std::array<float, Window> d2 = detail::centerWeights<Window, Order, 2>();
+};
+
+/**
+ * @brief Runtime view of one Design<> instantiation
+ */
+struct Kernel {
+    uint8_t      window;                 ///< Number of taps (odd)
+    uint8_t      order;                  ///< Polynomial degree
+    const float* proj;                   ///< (order+1) x window projection, row-major
+    const float* center[MAX_DERIV + 1];  ///< Centre weights per derivative
+};
+
+/**
+ * @brief Look up a precomputed kernel
+ *
+ * Tables exist for odd windows MIN_WINDOW..MAX_WINDOW and orders
+ * MIN_ORDER..MAX_ORDER.
+ *
+ * @return Kernel, or nullptr if the combination is not tabulated
+ */
+const Kernel* findKernel(size_t window, size_t order);
+
+/**
+ * @brief Closest tabulated kernel that fits a curve of n points
+ *
+ * Rounds even windows up, clamps window and order into the tabulated
+ * range and shrinks the window until it fits in n.
+ *
+ * @return Kernel, or nullptr if n < MIN_WINDOW
+ */
+const Kernel* selectKernel(size_t window, size_t order, size_t n);
+
+/**
+ * @brief Convolve data with a kernel, evaluating derivative `deriv`
+ *
+ * Interior points use the centre weights (one dot product each). The first
+ * and last window/2 points are evaluated from the polynomial fitted to the
+ * first/last full window. Output is divided by step^deriv, so passing the
+ * sample spacing yields a true derivative.
+ *
+ * @param in Input samples (n >= kernel.window)
+ * @param out Output buffer of n samples (must not alias in)
+ */
+void apply(const Kernel& kernel, size_t deriv, const float* in, float* out, size_t n, float step = 1.0f);
+
+/** 1 / step^deriv — the factor apply() multiplies every output by. */
+float derivativeScale(size_t deriv, float step);
+
+/**
+ * @brief Unscaled centre-weight dot product for one window
+ *
+ * Lets a caller that receives samples one at a time produce interior
+ * outputs as soon as `kernel.window` samples are available; multiply by
+ * derivativeScale() to get the value apply() would write.
+ *
+ * @param x First sample of the window (kernel.window samples are read)
+ */
+float convolvePoint(const Kernel& kernel, size_t deriv, const float* x);
+
+/**
+ * @brief One edge output of apply(), for idx < window/2 or idx >= n - window/2
+ *
+ * Lets a caller walk a derivative point by point without an output buffer.
+ *
+ * @param scale derivativeScale() for the same deriv/step
+ */
+float edgePoint(const Kernel& kernel, size_t deriv, const float* in, size_t n, size_t idx, float scale);
+
+/**
+ * @brief Fill only the first and last window/2 outputs, as apply() does
+ *
+ * @param scale derivativeScale() for the same deriv/step
+ */
+void applyEdges(const Kernel& kernel, size_t deriv, const float* in, float* out, size_t n, float scale);
+
+} // namespace sg
+} // namespace math_engine
+
+#endif // SAVITZKY_GOLAY_H
@@ -0,0 +1,56 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// SpscQueue — lock-free single-producer / single-consumer ring
+// ============================================================================
+// Exactly one task may call push() and exactly one (other) task may call
+// pop(); under that contract no mutex or critical section is needed, so the
+// handoff is safe between tasks pinned to different cores. The producer
+// publishes with a release store of head_, the consumer with a release store
+// of tail_; each side reads the other's index with acquire ordering.
+//
+// Capacity must be a power of two. Indices run freely and wrap naturally,
+// so all Capacity entries are usable.
+// ============================================================================
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    /** Producer side. Returns false if the queue is full. */
+    bool push(const T& item) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= Capacity) return false;
+        items_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer side. Returns false if the queue is empty. */
+    bool pop(T& item) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) return false;
+        item = items_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Approximate from either side; exact when the other side is idle. */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    T items_[Capacity] = {};
+    std::atomic<uint32_t> head_{0};  ///< Next slot to write (producer-owned)
+    std::atomic<uint32_t> tail_{0};  ///< Next slot to read (consumer-owned)
+};
+
+#endif // SPSC_QUEUE_H
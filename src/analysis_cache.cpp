@@ -0,0 +1,507 @@
+#include "analysis_cache.h"
+#include "file_manager.h"
+#include "log_buffer.h"
+#include <FFat.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+const char* AnalysisCache::CACHE_DIR = "/cache";
+
+namespace {
+
+const uint32_t BLOCK_MAGIC = 0x4843414D;  // "MACH"
+
+// Fixed header in front of the CachedCurve records of a .bin file
+struct BlockHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t curves;
+    uint32_t fileCrc;
+    uint32_t paramsHash;
+};
+
+// What a .crc memo holds
+struct CrcMemo {
+    uint32_t size;
+    uint32_t lastWrite;
+    uint32_t crc;
+};
+
+// Worker hand-off: one request at a time. request() fills `job` and wakes
+// the worker; both hold jobMutex while touching it.
+struct Job {
+    enum State : uint8_t { IDLE, QUEUED, RUNNING, DONE, FAILED };
+    State          state = IDLE;
+    String         filename;
+    AnalysisParams params;
+    uint32_t       paramsHash = 0;
+    uint32_t       fileCrc    = 0;      // DONE: content the block is stored under
+    bool           fromCache  = false;  // DONE: the block existed before the request
+};
+
+Job               job;
+SemaphoreHandle_t jobMutex     = nullptr;
+TaskHandle_t      workerHandle = nullptr;
+
+// Parsing a long run holds a curve of vectors plus CurveAnalyzer on the stack
+const uint32_t WORKER_STACK_BYTES = 8192;
+
+/** Bare names of the files in the cache directory. */
+std::vector<String> listCache() {
+    std::vector<String> names;
+    File dir = FFat.open(AnalysisCache::CACHE_DIR);
+    if (!dir) return names;
+
+    File file = dir.openNextFile();
+    while (file) {
+        if (!file.isDirectory()) {
+            String name = String(file.name());
+            int slash = name.lastIndexOf('/');
+            if (slash != -1) name = name.substring(slash + 1);
+            names.push_back(name);
+        }
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+    return names;
+}
+
+// CRC-32 (IEEE 802.3), a nibble at a time: 64 bytes of table in flash
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    static const uint32_t TABLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+        crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    }
+    return crc;
+}
+
+uint32_t fnv1a(uint32_t h, const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+CachedCurve analyseCurve(float vds, const std::vector<float>& vgs, const std::vector<float>& ids,
+                         const AnalysisParams& params, math_engine::ScratchArena& arena) {
+    CachedCurve c = {};
+    c.vds    = vds;
+    c.points = ids.size();
+
+    math_engine::VtConfig vtConfig;
+    vtConfig.constantCurrent = params.vtCurrent;
+    math_engine::SSConfig ssConfig;
+    ssConfig.method = params.ssMethod;
+
+    if (!arena.reserve(math_engine::scratchBytes(ids.size()))) return c;
+    math_engine::ScratchArena::Scope scope(arena);
+    math_engine::CurveAnalyzer analyzer;
+    if (!analyzer.begin(ids.size(), arena, params.gm, vtConfig, ssConfig)) return c;
+    for (size_t i = 0; i < ids.size(); i++) analyzer.push(vgs[i], ids[i]);
+    const math_engine::CurveAnalyzer::Result r = analyzer.finish();
+
+    c.vt    = r.vt;
+    c.maxGm = r.maxGm;
+    c.vtSecondDerivative = r.vtMethods.secondDerivative.vt;
+    c.vtConstantCurrent  = r.vtMethods.constantCurrent.vt;
+    c.vtYFunction        = r.vtMethods.yFunction.vt;
+    if (r.ss.valid) {
+        c.ss   = r.ss.ss_mVdec;
+        c.ssX1 = r.ss.x1;
+        c.ssY1 = r.ss.y1;
+        c.ssX2 = r.ss.x2;
+        c.ssY2 = r.ss.y2;
+    }
+    return c;
+}
+
+} // namespace
+
+uint32_t AnalysisParams::hash() const {
+    uint32_t h = 2166136261u;
+    const uint16_t version = AnalysisCache::FORMAT_VERSION;
+    const uint32_t window  = gm.smoothingWindow;
+    const uint32_t order   = gm.polyOrder;
+    const uint8_t  sg      = gm.useSavitzkyGolay ? 1 : 0;
+    const uint8_t  method  = static_cast<uint8_t>(ssMethod);
+    h = fnv1a(h, &version, sizeof(version));
+    h = fnv1a(h, &window, sizeof(window));
+    h = fnv1a(h, &order, sizeof(order));
+    h = fnv1a(h, &sg, sizeof(sg));
+    h = fnv1a(h, &vtCurrent, sizeof(vtCurrent));
+    h = fnv1a(h, &method, sizeof(method));
+    return h;
+}
+
+bool AnalysisCache::init() {
+    if (!FFat.exists(CACHE_DIR)) {
+        if (!FFat.mkdir(CACHE_DIR)) {
+            LOG_ERROR("Failed to create %s directory", CACHE_DIR);
+            return false;
+        }
+        LOG_INFO("Created %s directory", CACHE_DIR);
+    }
+
+    if (!workerHandle) {
+        jobMutex = xSemaphoreCreateMutex();
+        // Priority 0 on Core 0: below MOS_Analysis, so a live sweep is never held up
+        if (!jobMutex || xTaskCreatePinnedToCore(workerTask, "CacheWorker", WORKER_STACK_BYTES,
+                                                 nullptr, 0, &workerHandle, 0) != pdPASS) {
+            workerHandle = nullptr;
+            LOG_WARN("Failed to create analysis cache worker - misses will be analysed inline");
+        }
+    }
+    return true;
+}
+
+String AnalysisCache::memoPath(const String& filename) {
+    return String(CACHE_DIR) + "/" + filename.substring(0, filename.length() - 4) + ".crc";
+}
+
+String AnalysisCache::blockPath(uint32_t fileCrc, uint32_t paramsHash) {
+    char name[32];
+    snprintf(name, sizeof(name), "/%08lx_%08lx.bin", (unsigned long)fileCrc, (unsigned long)paramsHash);
+    return String(CACHE_DIR) + name;
+}
+
+AnalysisCache::Lookup AnalysisCache::request(const String& filename, const AnalysisParams& params,
+                                              AnalysisBlock& block, bool& fromCache) {
+    block = AnalysisBlock();
+    fromCache = false;
+    if (!FileManager::isValidFilename(filename)) return Lookup::Failed;
+
+    const uint32_t hash = params.hash();
+    if (!workerHandle) {
+        return get(filename, params, block, fromCache) ? Lookup::Ready : Lookup::Failed;
+    }
+
+    // The worker's own request is answered by the worker, so a block it has
+    // just stored is not reported as cached
+    Lookup   result;
+    uint32_t crc = 0;
+    bool     own = true;
+    xSemaphoreTake(jobMutex, portMAX_DELAY);
+    if (job.filename != filename || job.paramsHash != hash || job.state == Job::IDLE) {
+        own = false;
+    } else if (job.state == Job::QUEUED || job.state == Job::RUNNING) {
+        result = Lookup::Pending;
+    } else {
+        result    = job.state == Job::DONE ? Lookup::Ready : Lookup::Failed;
+        crc       = job.fileCrc;
+        fromCache = job.fromCache;
+        job.state = Job::IDLE;
+    }
+    xSemaphoreGive(jobMutex);
+
+    if (own) {
+        if (result == Lookup::Ready && !loadBlock(crc, hash, block)) result = Lookup::Failed;
+        return result;
+    }
+
+    if (memoCrc(filename, crc) && loadBlock(crc, hash, block)) {
+        fromCache = true;
+        return Lookup::Ready;
+    }
+
+    bool wake = false;
+    xSemaphoreTake(jobMutex, portMAX_DELAY);
+    if (job.state == Job::QUEUED || job.state == Job::RUNNING) {
+        const bool mine = job.filename == filename && job.paramsHash == hash;
+        result = mine ? Lookup::Pending : Lookup::Busy;
+    } else {
+        // An unclaimed DONE or FAILED of another request is dropped
+        job.state      = Job::QUEUED;
+        job.filename   = filename;
+        job.params     = params;
+        job.paramsHash = hash;
+        result = Lookup::Pending;
+        wake   = true;
+    }
+    xSemaphoreGive(jobMutex);
+
+    if (wake) xTaskNotifyGive(workerHandle);
+    return result;
+}
+
+void AnalysisCache::workerTask(void* param) {
+    (void)param;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(jobMutex, portMAX_DELAY);
+        if (job.state != Job::QUEUED) {
+            xSemaphoreGive(jobMutex);
+            continue;
+        }
+        job.state = Job::RUNNING;
+        const String         filename = job.filename;
+        const AnalysisParams params   = job.params;
+        xSemaphoreGive(jobMutex);
+
+        AnalysisBlock block;
+        bool fromCache = false;
+        const bool ok = get(filename, params, block, fromCache);
+
+        xSemaphoreTake(jobMutex, portMAX_DELAY);
+        job.state     = ok ? Job::DONE : Job::FAILED;
+        job.fileCrc   = block.fileCrc;
+        job.fromCache = fromCache;
+        xSemaphoreGive(jobMutex);
+    }
+}
+
+bool AnalysisCache::get(const String& filename, const AnalysisParams& params,
+                        AnalysisBlock& block, bool& fromCache) {
+    block = AnalysisBlock();
+    fromCache = false;
+    if (!FileManager::isValidFilename(filename)) return false;
+
+    uint32_t crc;
+    if (!fileCrc(filename, crc)) return false;
+
+    const uint32_t hash = params.hash();
+    if (loadBlock(crc, hash, block)) {
+        fromCache = true;
+        return true;
+    }
+
+    block = AnalysisBlock();
+    block.fileCrc    = crc;
+    block.paramsHash = hash;
+    if (!analyse(filename, params, block)) return false;
+    writeBlock(blockPath(crc, hash), block);
+    return true;
+}
+
+bool AnalysisCache::memoCrc(const String& filename, uint32_t& crc) {
+    String srcPath = String(FileManager::MEASUREMENTS_DIR) + "/" + filename;
+    File src = FFat.open(srcPath.c_str(), "r");
+    if (!src) return false;
+    const uint32_t size      = src.size();
+    const uint32_t lastWrite = src.getLastWrite();
+    src.close();
+
+    // Without a modification time a rewrite of the same size would go
+    // unnoticed; such files are hashed on every request
+    if (lastWrite == 0) return false;
+
+    CrcMemo memo = {};
+    File m = FFat.open(memoPath(filename).c_str(), "r");
+    if (!m) return false;
+    const bool read = m.read(reinterpret_cast<uint8_t*>(&memo), sizeof(memo)) == sizeof(memo);
+    m.close();
+    if (!read || memo.size != size || memo.lastWrite != lastWrite) return false;
+
+    crc = memo.crc;
+    return true;
+}
+
+bool AnalysisCache::fileCrc(const String& filename, uint32_t& crc) {
+    if (memoCrc(filename, crc)) return true;
+
+    String srcPath = String(FileManager::MEASUREMENTS_DIR) + "/" + filename;
+    File src = FFat.open(srcPath.c_str(), "r");
+    if (!src) {
+        LOG_ERROR("Analysis source not found: %s", filename.c_str());
+        return false;
+    }
+
+    CrcMemo memo = {};
+    const uint32_t size      = src.size();
+    const uint32_t lastWrite = src.getLastWrite();
+
+    uint8_t buf[512];
+    uint32_t c = 0xFFFFFFFF;
+    while (src.available()) {
+        const size_t n = src.read(buf, sizeof(buf));
+        if (n == 0) break;
+        c = crc32Update(c, buf, n);
+    }
+    src.close();
+    crc = ~c;
+
+    // Written even without a modification time: forget() finds the blocks
+    // of a deleted file through it
+    memo.size      = size;
+    memo.lastWrite = lastWrite;
+    memo.crc       = crc;
+    File m = FFat.open(memoPath(filename).c_str(), "w");
+    if (m) {
+        m.write(reinterpret_cast<const uint8_t*>(&memo), sizeof(memo));
+        m.close();
+    }
+    return true;
+}
+
+bool AnalysisCache::loadBlock(uint32_t fileCrc, uint32_t paramsHash, AnalysisBlock& block) {
+    const String path = blockPath(fileCrc, paramsHash);
+    if (!FFat.exists(path) || !readBlock(path, block)) return false;
+    if (block.fileCrc == fileCrc && block.paramsHash == paramsHash) return true;
+    block = AnalysisBlock();
+    return false;
+}
+
+bool AnalysisCache::readBlock(const String& path, AnalysisBlock& block) {
+    File file = FFat.open(path.c_str(), "r");
+    if (!file) return false;
+
+    BlockHeader header;
+    bool ok = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              header.magic == BLOCK_MAGIC && header.version == FORMAT_VERSION &&
+              file.size() == sizeof(header) + header.curves * sizeof(CachedCurve);
+    if (ok) {
+        block.fileCrc    = header.fileCrc;
+        block.paramsHash = header.paramsHash;
+        block.curves.resize(header.curves);
+        const size_t bytes = header.curves * sizeof(CachedCurve);
+        ok = file.read(reinterpret_cast<uint8_t*>(block.curves.data()), bytes) == bytes;
+    }
+    file.close();
+
+    if (!ok) {
+        LOG_WARN("Discarding corrupt analysis cache block %s", path.c_str());
+        FFat.remove(path.c_str());
+    }
+    return ok;
+}
+
+bool AnalysisCache::analyse(const String& filename, const AnalysisParams& params, AnalysisBlock& block) {
+    String srcPath = String(FileManager::MEASUREMENTS_DIR) + "/" + filename;
+    File src = FFat.open(srcPath.c_str(), "r");
+    if (!src) return false;
+
+    // Rows of one curve are contiguous, so each curve is analysed as soon as
+    // the next VDS starts and only one is held in RAM.
+    std::vector<float> vgs, ids;
+    math_engine::ScratchArena arena;
+    float curveVds = 0.0f;
+    bool transferSweep = true;
+
+    auto flush = [&]() {
+        if (ids.size() >= 2) block.curves.push_back(analyseCurve(curveVds, vgs, ids, params, arena));
+        vgs.clear();
+        ids.clear();
+    };
+
+    while (src.available()) {
+        String line = src.readStringUntil('\n');
+        if (FileManager::isOutputSweepHeader(line)) {
+            transferSweep = false;
+            break;
+        }
+
+        float vds, vg, id;
+        if (!FileManager::parseDataRow(line, vds, vg, id)) continue;
+
+        if (!ids.empty() && fabsf(vds - curveVds) > VDS_TOLERANCE) flush();
+        curveVds = vds;
+        vgs.push_back(vg);
+        ids.push_back(id);
+    }
+    src.close();
+    if (transferSweep) flush();
+
+    if (!transferSweep || block.curves.empty()) {
+        LOG_ERROR("Analysis source %s is not a transfer sweep with data", filename.c_str());
+        return false;
+    }
+
+    LOG_INFO("Analysed %s: %u curves", filename.c_str(), (unsigned)block.curves.size());
+    return true;
+}
+
+void AnalysisCache::writeBlock(const String& path, const AnalysisBlock& block) {
+    evict();
+
+    // Write to a temporary file first so a reader never sees half a block
+    String tmpPath = path.substring(0, path.length() - 4) + ".tmp";
+    File file = FFat.open(tmpPath.c_str(), "w");
+    if (!file) {
+        LOG_WARN("Failed to create analysis cache block %s", path.c_str());
+        return;
+    }
+
+    BlockHeader header = { BLOCK_MAGIC, FORMAT_VERSION, (uint16_t)block.curves.size(),
+                           block.fileCrc, block.paramsHash };
+    const size_t bytes = block.curves.size() * sizeof(CachedCurve);
+    bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              file.write(reinterpret_cast<const uint8_t*>(block.curves.data()), bytes) == bytes;
+    file.close();
+
+    if (FFat.exists(path)) FFat.remove(path.c_str());
+    if (!ok || !FFat.rename(tmpPath.c_str(), path.c_str())) {
+        FFat.remove(tmpPath.c_str());
+        LOG_WARN("Failed to store analysis cache block %s", path.c_str());
+    }
+}
+
+void AnalysisCache::evict() {
+    while (true) {
+        File dir = FFat.open(CACHE_DIR);
+        if (!dir) return;
+
+        int blocks = 0;
+        String oldest;
+        time_t oldestTime = 0;
+        File file = dir.openNextFile();
+        while (file) {
+            String name = String(file.name());
+            if (!file.isDirectory() && name.endsWith(".bin")) {
+                int slash = name.lastIndexOf('/');
+                if (slash != -1) name = name.substring(slash + 1);
+                if (blocks == 0 || file.getLastWrite() < oldestTime) {
+                    oldest     = name;
+                    oldestTime = file.getLastWrite();
+                }
+                blocks++;
+            }
+            file.close();
+            file = dir.openNextFile();
+        }
+        dir.close();
+
+        if (blocks < MAX_BLOCKS) return;
+        FFat.remove((String(CACHE_DIR) + "/" + oldest).c_str());
+    }
+}
+
+void AnalysisCache::forget(const String& filename) {
+    if (!FileManager::isValidFilename(filename)) return;
+    const String path = memoPath(filename);
+    File m = FFat.open(path.c_str(), "r");
+    if (!m) return;  // Never analysed
+
+    CrcMemo memo = {};
+    const bool read = m.read(reinterpret_cast<uint8_t*>(&memo), sizeof(memo)) == sizeof(memo);
+    m.close();
+    FFat.remove(path.c_str());
+    if (!read) return;
+
+    // Every parameter set of this content; a copy under another name loses
+    // them too and is analysed again on its next request
+    char prefix[16];
+    snprintf(prefix, sizeof(prefix), "%08lx_", (unsigned long)memo.crc);
+    int removed = 0;
+    for (const String& name : listCache()) {
+        if (name.startsWith(prefix) && name.endsWith(".bin")) {
+            FFat.remove((String(CACHE_DIR) + "/" + name).c_str());
+            removed++;
+        }
+    }
+    LOG_INFO("Analysis cache: dropped %s and %d block(s)", filename.c_str(), removed);
+}
+
+void AnalysisCache::clear() {
+    const std::vector<String> names = listCache();
+    for (const String& name : names) FFat.remove((String(CACHE_DIR) + "/" + name).c_str());
+    LOG_INFO("Analysis cache cleared (%u files)", (unsigned)names.size());
+}
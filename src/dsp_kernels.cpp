@@ -0,0 +1,82 @@
+#include "dsp_kernels.h"
+#include "regression_numerics.h"
+
+// Use esp-dsp when building for the ESP32 and the component is available
+#ifndef MATH_ENGINE_ESP_DSP
+#  if defined(ESP_PLATFORM) && defined(__has_include)
+#    if __has_include(<esp_dsp.h>)
+#      define MATH_ENGINE_ESP_DSP 1
+#    endif
+#  endif
+#endif
+#ifndef MATH_ENGINE_ESP_DSP
+#  define MATH_ENGINE_ESP_DSP 0
+#endif
+
+#if MATH_ENGINE_ESP_DSP
+#include <esp_dsp.h>
+#endif
+
+namespace math_engine {
+namespace kernels {
+
+#if MATH_ENGINE_ESP_DSP
+
+const char* backend() { return "esp-dsp"; }
+
+float dot(const float* a, const float* b, size_t n) {
+    float result = 0.0f;
+    dsps_dotprod_f32(a, b, &result, static_cast<int>(n));
+    return result;
+}
+
+void correlate(const float* in, size_t n, const float* taps, size_t taps_n, float* out) {
+    if (taps_n == 0 || n < taps_n) return;
+    dsps_corr_f32(in, static_cast<int>(n), taps, static_cast<int>(taps_n), out);
+}
+
+void scale(const float* in, float* out, size_t n, float c) {
+    dsps_mulc_f32(in, out, static_cast<int>(n), c, 1, 1);
+}
+
+#else
+
+const char* backend() { return "portable"; }
+
+float dot(const float* a, const float* b, size_t n) {
+    float acc = 0.0f;
+    for (size_t k = 0; k < n; k++) acc += a[k] * b[k];
+    return acc;
+}
+
+void correlate(const float* in, size_t n, const float* taps, size_t taps_n, float* out) {
+    if (taps_n == 0 || n < taps_n) return;
+    const size_t outputs = n - taps_n + 1;
+    for (size_t i = 0; i < outputs; i++) out[i] = dot(in + i, taps, taps_n);
+}
+
+void scale(const float* in, float* out, size_t n, float c) {
+    for (size_t i = 0; i < n; i++) out[i] = in[i] * c;
+}
+
+#endif
+
+void runningMean(const float* in, float* out, size_t n, size_t window) {
+    if (window < 1) window = 1;
+    const size_t half = window / 2;
+
+    // Window [lo, hi) slides one sample per output: each sample enters and
+    // leaves the sum once, whatever the window size.
+    numerics::CompensatedFloat::Sum sum;
+    size_t lo = 0, hi = 0;
+    for (size_t i = 0; i < n; i++) {
+        const size_t wantHi = (i + half + 1 < n) ? i + half + 1 : n;
+        const size_t wantLo = (i > half) ? i - half : 0;
+        while (hi < wantHi) sum.add(in[hi++]);
+        while (lo < wantLo) sum.add(-in[lo++]);
+        out[i] = sum.value() / static_cast<float>(hi - lo);
+    }
+}
+
+} // namespace kernels
+} // namespace math_engine
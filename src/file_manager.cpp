@@ -2,6 +2,7 @@
 #include "mosfet_controller.h"
 #include <FFat.h>
 #include <algorithm>
+#include <cstdio>
 #include <WebServer.h>
 
 const char* FileManager::MEASUREMENTS_DIR = "/measurements";
@@ -89,6 +90,22 @@ bool FileManager::isValidFilename(const String& filename) {
     return true;
 }
 
+bool FileManager::parseDataRow(const String& line, float& vds, float& vgs, float& ids) {
+    if (line.length() == 0 || line.charAt(0) == '#') return false;
+
+    // Only the leading columns are needed; vsh, samples and fsr are skipped
+    float vd, vg, id;
+    if (sscanf(line.c_str(), "%*u,%f,%f,%*f,%e", &vd, &vg, &id) != 3) return false;
+    vds = vd;
+    vgs = vg;
+    ids = id;
+    return true;
+}
+
+bool FileManager::isOutputSweepHeader(const String& line) {
+    return line.startsWith("# Sweep Mode:") && line.indexOf("VDS") != -1;
+}
+
 int FileManager::countFiles() {
     int count = 0;
     File dir = FFat.open(MEASUREMENTS_DIR);
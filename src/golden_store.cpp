@@ -0,0 +1,200 @@
+#include "golden_store.h"
+#include "file_manager.h"
+#include "log_buffer.h"
+#include <FFat.h>
+#include <cmath>
+#include <cstdio>
+
+const char* GoldenStore::GOLDEN_DIR = "/golden";
+
+const GoldenCurve* GoldenFamily::find(float vds) const {
+    const GoldenCurve* best = nullptr;
+    float bestDiff = GoldenStore::VDS_TOLERANCE;
+    for (const GoldenCurve& c : curves) {
+        float diff = fabsf(c.vds - vds);
+        if (diff <= bestDiff) {
+            best = &c;
+            bestDiff = diff;
+        }
+    }
+    return best;
+}
+
+void GoldenFamily::clear() {
+    part = "";
+    tolerance = math_engine::GoldenTolerance();
+    curves.clear();
+}
+
+bool GoldenStore::init() {
+    if (!FFat.exists(GOLDEN_DIR)) {
+        if (!FFat.mkdir(GOLDEN_DIR)) {
+            LOG_ERROR("Failed to create %s directory", GOLDEN_DIR);
+            return false;
+        }
+        LOG_INFO("Created %s directory", GOLDEN_DIR);
+    }
+    return true;
+}
+
+bool GoldenStore::isValidPartNumber(const String& part) {
+    if (part.length() == 0 || part.length() > 32) return false;
+    if (part.indexOf("..") != -1) return false;
+
+    for (size_t i = 0; i < part.length(); i++) {
+        char c = part.charAt(i);
+        if (!isalnum(c) && c != '_' && c != '-' && c != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+String GoldenStore::pathFor(const String& part) {
+    return String(GOLDEN_DIR) + "/" + part + ".csv";
+}
+
+std::vector<String> GoldenStore::listParts() {
+    std::vector<String> parts;
+    File dir = FFat.open(GOLDEN_DIR);
+    if (!dir) return parts;
+
+    File file = dir.openNextFile();
+    while (file) {
+        if (!file.isDirectory()) {
+            String name = String(file.name());
+            int slash = name.lastIndexOf('/');
+            if (slash != -1) name = name.substring(slash + 1);
+            if (name.endsWith(".csv")) parts.push_back(name.substring(0, name.length() - 4));
+        }
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+    return parts;
+}
+
+bool GoldenStore::createFromMeasurement(const String& part, const String& filename,
+                                        const math_engine::GoldenTolerance& tolerance) {
+    if (!isValidPartNumber(part) || !FileManager::isValidFilename(filename)) {
+        LOG_ERROR("Invalid golden part/file rejected: %s / %s", part.c_str(), filename.c_str());
+        return false;
+    }
+
+    String srcPath = String(FileManager::MEASUREMENTS_DIR) + "/" + filename;
+    File src = FFat.open(srcPath.c_str(), "r");
+    if (!src) {
+        LOG_ERROR("Golden source not found: %s", filename.c_str());
+        return false;
+    }
+
+    // Write to a temporary file first so a failed promotion keeps the old reference
+    String tmpPath = String(GOLDEN_DIR) + "/" + part + ".tmp";
+    File dst = FFat.open(tmpPath.c_str(), "w");
+    if (!dst) {
+        src.close();
+        LOG_ERROR("Failed to create golden file for %s", part.c_str());
+        return false;
+    }
+
+    dst.printf("# Golden Reference\n# Part: %s\n# Source: %s\n", part.c_str(), filename.c_str());
+    dst.printf("# Tolerance: rmse=%.3e r2=%.5f chi2=%.3e\n",
+               tolerance.maxRmse, tolerance.minR2, tolerance.maxChi2);
+    dst.print("vds,vgs,ids\n");
+
+    bool transferSweep = true;
+    size_t rows = 0;
+    while (src.available()) {
+        String line = src.readStringUntil('\n');
+        if (FileManager::isOutputSweepHeader(line)) {
+            transferSweep = false;
+            break;
+        }
+
+        float vds, vgs, ids;
+        if (!FileManager::parseDataRow(line, vds, vgs, ids)) continue;
+        dst.printf("%.3f,%.3f,%.6e\n", vds, vgs, ids);
+        rows++;
+    }
+    src.close();
+    dst.close();
+
+    if (!transferSweep || rows < 2) {
+        FFat.remove(tmpPath.c_str());
+        LOG_ERROR("Golden source %s is not a transfer sweep with data", filename.c_str());
+        return false;
+    }
+
+    String path = pathFor(part);
+    if (FFat.exists(path)) FFat.remove(path.c_str());
+    if (!FFat.rename(tmpPath.c_str(), path.c_str())) {
+        FFat.remove(tmpPath.c_str());
+        LOG_ERROR("Failed to store golden reference for %s", part.c_str());
+        return false;
+    }
+
+    LOG_INFO("Golden reference %s created from %s (%u points)", part.c_str(), filename.c_str(), (unsigned)rows);
+    return true;
+}
+
+bool GoldenStore::load(const String& part, GoldenFamily& family) {
+    family.clear();
+    if (!isValidPartNumber(part)) return false;
+
+    File file = FFat.open(pathFor(part).c_str(), "r");
+    if (!file) {
+        LOG_ERROR("No golden reference for part %s", part.c_str());
+        return false;
+    }
+
+    family.part = part;
+    while (file.available()) {
+        String line = file.readStringUntil('\n');
+        if (line.startsWith("# Tolerance:")) {
+            math_engine::GoldenTolerance& t = family.tolerance;
+            sscanf(line.c_str(), "# Tolerance: rmse=%e r2=%e chi2=%e", &t.maxRmse, &t.minR2, &t.maxChi2);
+            continue;
+        }
+        if (line.length() == 0 || line.charAt(0) == '#') continue;
+
+        float vds, vgs, ids;
+        if (sscanf(line.c_str(), "%f,%f,%e", &vds, &vgs, &ids) != 3) continue;
+
+        // Rows of one curve are contiguous; a VDS change starts the next
+        if (family.curves.empty() || fabsf(family.curves.back().vds - vds) > VDS_TOLERANCE) {
+            family.curves.emplace_back();
+            family.curves.back().vds = vds;
+        }
+        GoldenCurve& curve = family.curves.back();
+        if (!curve.vgs.empty() && vgs <= curve.vgs.back()) {
+            file.close();
+            LOG_ERROR("Golden reference %s: VGS not ascending at VDS=%.3fV", part.c_str(), vds);
+            family.clear();
+            return false;
+        }
+        curve.vgs.push_back(vgs);
+        curve.ids.push_back(ids);
+    }
+    file.close();
+
+    if (family.curves.empty()) {
+        LOG_ERROR("Golden reference %s holds no data", part.c_str());
+        family.clear();
+        return false;
+    }
+
+    LOG_INFO("Golden reference %s loaded: %u curves", part.c_str(), (unsigned)family.curves.size());
+    return true;
+}
+
+bool GoldenStore::remove(const String& part) {
+    if (!isValidPartNumber(part)) return false;
+
+    bool success = FFat.remove(pathFor(part).c_str());
+    if (success) {
+        LOG_INFO("Deleted golden reference: %s", part.c_str());
+    } else {
+        LOG_ERROR("Failed to delete golden reference: %s", part.c_str());
+    }
+    return success;
+}
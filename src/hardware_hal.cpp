@@ -1,12 +1,38 @@
 #include "hardware_hal.h"
 #include "log_buffer.h"
 #include <driver/dac.h>
+#include <driver/adc.h>
 #include <Wire.h>
 #include <memory>
 #include <cmath>
 
 namespace hal {
 
+namespace {
+
+// Shared by every DAC; written only by the measurement task
+volatile uint32_t dacWritten = 0;
+volatile uint32_t dacElided  = 0;
+
+// HybridADC outcomes; written only by the measurement task
+volatile uint32_t hybridFine       = 0;
+volatile uint32_t hybridOffScale   = 0;
+volatile uint32_t hybridBelowFloor = 0;
+
+// Adafruit PGA setting of a PGA_RANGES entry
+adsGain_t adsGain(const PgaRange& range) {
+    switch (range.code) {
+        case  0: return GAIN_TWOTHIRDS;
+        case  1: return GAIN_ONE;
+        case  2: return GAIN_TWO;
+        case  4: return GAIN_FOUR;
+        case  8: return GAIN_EIGHT;
+        default: return GAIN_SIXTEEN;
+    }
+}
+
+} // namespace
+
 // ============================================================================
 // InternalDAC Implementation
 // ============================================================================
@@ -22,7 +48,8 @@ void InternalDAC::begin() {
     dac_channel_t dacChannel = (channel_ == 1) ? DAC_CHANNEL_1 : DAC_CHANNEL_2;
     esp_err_t err = dac_output_enable(dacChannel);
     if (err == ESP_OK) {
-        dac_output_voltage(dacChannel, 0);
+        shadowValid_ = dac_output_voltage(dacChannel, 0) == ESP_OK;
+        currentValue_ = 0;
         initialized_ = true;
         LOG_INFO("InternalDAC CH%d initialized (GPIO%d, 8-bit)",
                  channel_, (channel_ == 1) ? DAC_VDS_PIN : DAC_VGS_PIN);
@@ -35,27 +62,111 @@ void InternalDAC::setVoltage(float voltage) {
     if (!initialized_) { LOG_ERROR("InternalDAC ch%d not initialized!", channel_); return; }
     if (voltage < 0.0f) voltage = 0.0f;
     if (voltage > maxVoltage_) voltage = maxVoltage_;
-    currentValue_ = static_cast<uint8_t>((voltage / DAC_VREF) * DAC_MAX_VALUE);
+    const uint8_t code = static_cast<uint8_t>((voltage / DAC_VREF) * DAC_MAX_VALUE);
+    if (shadowValid_ && code == currentValue_) { dacElided++; return; }
+
+    currentValue_ = code;
     dac_channel_t dacChannel = (channel_ == 1) ? DAC_CHANNEL_1 : DAC_CHANNEL_2;
-    dac_output_voltage(dacChannel, currentValue_);
+    shadowValid_ = dac_output_voltage(dacChannel, currentValue_) == ESP_OK;
+    dacWritten++;
 }
 
 void InternalDAC::shutdown() {
     if (!initialized_) return;
+    // Always written, whatever the shadow says: this is the safety path
     dac_channel_t dacChannel = (channel_ == 1) ? DAC_CHANNEL_1 : DAC_CHANNEL_2;
-    dac_output_voltage(dacChannel, 0);
+    shadowValid_ = dac_output_voltage(dacChannel, 0) == ESP_OK;
     currentValue_ = 0;
 }
 
 
+// ============================================================================
+// AdcDmaSource Implementation
+// ============================================================================
+
+AdcDmaSource::~AdcDmaSource() {
+    if (installed_) adc_digi_deinitialize();
+}
+
+bool AdcDmaSource::begin(uint16_t frameSamples) {
+    const int8_t ch = digitalPinToAnalogChannel(pin_);
+    if (ch < 0 || ch >= ADC1_CHANNEL_MAX) {
+        LOG_WARN("AdcDmaSource: GPIO%d is not an ADC1 pin - no DMA", pin_);
+        return false;
+    }
+
+    // Whole 4-byte words for the I2S DMA, at most what the readers accept
+    frameSamples = (frameSamples + 1) & ~1u;
+    if (frameSamples * DMA_WORD_BYTES > DMA_FRAME_MAX_BYTES) frameSamples = DMA_FRAME_MAX_BYTES / DMA_WORD_BYTES;
+    if (installed_) {
+        if (frameSamples == frameSamples_) return true;
+        adc_digi_deinitialize();
+        installed_ = false;
+    }
+    frameSamples_ = frameSamples;
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = ADC_DMA_BUFFER_FRAMES * frameBytes();
+    init.conv_num_each_intr = frameBytes();  // Bytes per frame / interrupt
+    init.adc1_chan_mask     = BIT(ch);
+    init.adc2_chan_mask     = 0;
+    if (adc_digi_initialize(&init) != ESP_OK) {
+        LOG_ERROR("AdcDmaSource: continuous ADC driver install failed");
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten     = ADC_ATTEN_DB_11;  // 0–3.3 V, as analogSetAttenuation(ADC_11db)
+    pattern.channel   = ch;
+    pattern.unit      = 0;                // ADC1 (unit index)
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en  = true;         // Required on the ESP32 (I2S-driven ADC)
+    config.conv_limit_num = 250;
+    config.pattern_num    = 1;
+    config.adc_pattern    = &pattern;
+    config.sample_freq_hz = ADC_DMA_SAMPLE_HZ;
+    config.conv_mode      = ADC_CONV_SINGLE_UNIT_1;
+    config.format         = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&config) != ESP_OK) {
+        LOG_ERROR("AdcDmaSource: continuous ADC configuration failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    channel_   = static_cast<uint8_t>(ch);
+    installed_ = true;
+    return true;
+}
+
+bool AdcDmaSource::start() {
+    return installed_ && adc_digi_start() == ESP_OK;
+}
+
+void AdcDmaSource::stop() {
+    if (installed_) adc_digi_stop();
+}
+
+size_t AdcDmaSource::readFrame(uint8_t* buf, size_t maxBytes, uint32_t timeoutMs, bool& overrun) {
+    if (!installed_) return 0;
+    uint32_t len = 0;
+    const esp_err_t err = adc_digi_read_bytes(buf, maxBytes, &len, timeoutMs);
+    // ESP_ERR_INVALID_STATE: the ring buffer overflowed; the frame returned is still valid
+    overrun = (err == ESP_ERR_INVALID_STATE);
+    if (err != ESP_OK && !overrun) return 0;
+    return len;
+}
+
+
 // ============================================================================
 // InternalADC Implementation
 // ============================================================================
 
 InternalADC::InternalADC(uint8_t pin, uint16_t oversamplingCount)
-    : pin_(pin), oversamplingCount_(oversamplingCount) {
+    : pin_(pin), oversamplingCount_(oversamplingCount), dma_(pin) {
     if (oversamplingCount_ < 1)   oversamplingCount_ = 1;
-    if (oversamplingCount_ > 256) oversamplingCount_ = 256;
+    if (oversamplingCount_ > OVERSAMPLING_MAX_SAMPLES) oversamplingCount_ = OVERSAMPLING_MAX_SAMPLES;
 }
 
 void InternalADC::begin() {
@@ -63,49 +174,112 @@ void InternalADC::begin() {
     analogReadResolution(ADC_RESOLUTION);
     analogSetAttenuation(ADC_11db);
     pinMode(pin_, INPUT);
+#if INTERNAL_ADC_DMA
+    dmaActive_ = dma_.begin();
+#endif
     initialized_ = true;
-    LOG_INFO("InternalADC initialized on GPIO%d (%d-bit, %d samples, ~%.1f ENOB)",
-             pin_, ADC_RESOLUTION, oversamplingCount_, getEffectiveBits());
+    if (dmaActive_) {
+        LOG_INFO("InternalADC initialized on GPIO%d (%d-bit, %d samples, ~%.1f ENOB, DMA at %lu Hz)",
+                 pin_, ADC_RESOLUTION, oversamplingCount_, getEffectiveBits(), (unsigned long)ADC_DMA_SAMPLE_HZ);
+    } else {
+        LOG_INFO("InternalADC initialized on GPIO%d (%d-bit, %d samples, ~%.1f ENOB)",
+                 pin_, ADC_RESOLUTION, oversamplingCount_, getEffectiveBits());
+    }
+}
+
+void InternalADC::beginCurve(uint32_t settlingMs) {
+    inCurve_ = true;
+    if (!dmaActive_ || streaming_) return;
+
+    // One frame per point: the window is the frame converted as it is read,
+    // two words longer so a stray word of another channel does not cost a frame
+    const uint16_t frameSamples = oversamplingCount_ + 2;
+    const uint32_t frameUs      = frameSamples * 1000000UL / ADC_DMA_SAMPLE_HZ;
+
+    // The frame in flight at a read began up to a frame earlier. Unless the
+    // settling covers that (vTaskDelay() may end a tick early), it would have
+    // to be dropped, and a window longer than a frame waits for two: either
+    // way a point would cost more than the analogRead() loop
+    if (settlingMs == 0 || (settlingMs - 1) * 1000UL < frameUs) return;
+    if (frameSamples * DMA_WORD_BYTES > DMA_FRAME_MAX_BYTES) return;
+
+    if (!dma_.begin(frameSamples)) {
+        dmaActive_ = false;
+        LOG_WARN("InternalADC: DMA frames of %u unavailable on GPIO%d - back to analogRead",
+                 (unsigned)frameSamples, pin_);
+        return;
+    }
+    streaming_ = dma_.start();
+}
+
+void InternalADC::endCurve() {
+    inCurve_ = false;
+    if (!streaming_) return;
+    dma_.stop();
+    streaming_ = false;
 }
 
 uint16_t InternalADC::readRaw() {
     if (!initialized_) { LOG_ERROR("InternalADC GPIO%d not initialized!", pin_); return 0; }
+    // analogRead() cannot share ADC1 with the running driver
+    uint16_t code = 0;
+    if (streaming_ && acquireDmaStream(dma_, dma_.channel(), &code, 1, true, &dmaStats_) == 1) return code;
     return analogRead(pin_);
 }
 
 float InternalADC::readVoltage() {
     if (!initialized_) { LOG_ERROR("InternalADC GPIO%d not initialized!", pin_); return 0.0f; }
 
-    // ── Sample collection ──────────────────────────────────────────────────
-    uint16_t samples[256];
     const uint16_t n = oversamplingCount_;
-    for (uint16_t i = 0; i < n; i++) {
-        samples[i] = static_cast<uint16_t>(analogRead(pin_));
-    }
-
-    // ── Insertion Sort ─────────────────────────────────────────────────────
-    for (uint16_t i = 1; i < n; i++) {
-        uint16_t key = samples[i];
-        int16_t  j   = static_cast<int16_t>(i) - 1;
-        while (j >= 0 && samples[j] > key) { samples[j + 1] = samples[j]; j--; }
-        samples[j + 1] = key;
+    float avgRaw;
+    // Within a curve the driver is used only while it streams
+    const bool dma = dmaActive_ && (streaming_ || !inCurve_);
+    if (!dma && !adaptive_.enabled && method_ == OversamplingMethod::MinMaxReject) {
+        // ── Streaming: no sample buffer ────────────────────────────────────
+        MinMaxRejectMean acc;
+        for (uint16_t i = 0; i < n; i++) acc.add(static_cast<uint16_t>(analogRead(pin_)));
+        avgRaw = acc.mean();
+        lastSampleCount_ = n;
+    } else {
+        // ── Sample collection (adaptive: until precise enough) + estimator ─
+        const float absCodes = adaptive_.absPrecision * (ADC_MAX_VALUE / ADC_VREF);
+        SequentialMean seq;
+        auto enough = [&](uint16_t code) {
+            seq.add(code);
+            return adaptive_.enabled && seq.precise(adaptive_, absCodes);
+        };
+
+        uint16_t samples[OVERSAMPLING_MAX_SAMPLES];
+        uint16_t got  = 0;
+        bool     done = false;
+        if (dma) {
+            // Fixed-rate window; the task sleeps while the DMA fills it
+            const uint32_t timeouts = dmaStats_.timeouts;
+            got = streaming_
+                ? acquireDmaStream(dma_, dma_.channel(), samples, n, true, &dmaStats_, enough)
+                : acquireDmaWindow(dma_, dma_.channel(), samples, n, &dmaStats_, enough);
+            done = got > 0 && dmaStats_.timeouts == timeouts;
+            if (!done) {
+                if (streaming_) dma_.stop();
+                streaming_ = false;
+                dmaActive_ = false;
+                LOG_WARN("InternalADC: DMA stalled on GPIO%d - back to analogRead", pin_);
+            }
+        }
+        while (!done && got < n) {
+            samples[got] = static_cast<uint16_t>(analogRead(pin_));
+            done = enough(samples[got++]);
+        }
+        avgRaw = reduceSamples(method_, samples, got);
+        lastSampleCount_ = got;
     }
-
-    // ── Trimmed Mean (10% / 10%) ───────────────────────────────────────────
-    const uint16_t trim  = n / 10;
-    const uint16_t start = trim;
-    const uint16_t end   = n - trim;
-    uint32_t sum = 0; uint16_t count = 0;
-    for (uint16_t i = start; i < end; i++) { sum += samples[i]; count++; }
-    if (count == 0) count = 1;
-
-    const float avgRaw = static_cast<float>(sum) / count;
+    lastClipped_ = avgRaw >= ADC_MAX_VALUE - 0.5f;
     return (avgRaw / ADC_MAX_VALUE) * ADC_VREF;
 }
 
 void InternalADC::setOversamplingCount(uint16_t count) {
     if (count < 1)   count = 1;
-    if (count > 256) count = 256;
+    if (count > OVERSAMPLING_MAX_SAMPLES) count = OVERSAMPLING_MAX_SAMPLES;
     oversamplingCount_ = count;
     LOG_DEBUG("InternalADC oversampling → %d samples (~%.1f ENOB)", count, getEffectiveBits());
 }
@@ -128,8 +302,9 @@ bool ExternalDAC::begin() {
         LOG_ERROR("ExternalDAC MCP4725 not found at I2C addr 0x%02X", i2cAddr_);
         return false;
     }
-    mcp_.setVoltage(0, false);  // Start at 0 V (no EEPROM write)
-    initialized_ = true;
+    shadowValid_  = mcp_.setVoltage(0, false);  // Start at 0 V (no EEPROM write)
+    currentValue_ = 0;
+    initialized_  = true;
     LOG_INFO("ExternalDAC MCP4725 initialized at 0x%02X (12-bit, %.3f mV/step)",
              i2cAddr_, getResolution() * 1000.0f);
     return true;
@@ -142,15 +317,20 @@ void ExternalDAC::setVoltage(float voltage) {
 
     // Convert voltage → 12-bit DAC code (0–4095)
     // MCP4725 output = (code / 4096) * VDD
-    currentValue_ = static_cast<uint16_t>((voltage / EXT_DAC_VREF) * EXT_DAC_MAX_VALUE);
-    if (currentValue_ > EXT_DAC_MAX_VALUE) currentValue_ = EXT_DAC_MAX_VALUE;
+    uint16_t code = static_cast<uint16_t>((voltage / EXT_DAC_VREF) * EXT_DAC_MAX_VALUE);
+    if (code > EXT_DAC_MAX_VALUE) code = EXT_DAC_MAX_VALUE;
+
+    // Same code as the last successful write: no I2C transaction
+    if (shadowValid_ && code == currentValue_) { dacElided++; return; }
 
-    mcp_.setVoltage(currentValue_, false);  // Write to DAC register, not EEPROM
+    currentValue_ = code;
+    shadowValid_  = mcp_.setVoltage(currentValue_, false);  // Write to DAC register, not EEPROM
+    dacWritten++;
 }
 
 void ExternalDAC::shutdown() {
     if (!initialized_) return;
-    mcp_.setVoltage(0, false);
+    shadowValid_  = mcp_.setVoltage(0, false);  // Always written: safety path
     currentValue_ = 0;
 }
 
@@ -168,8 +348,9 @@ bool ExternalDAC2::begin() {
         LOG_ERROR("ExternalDAC2 MCP4725 not found at I2C addr 0x%02X", EXT_DAC_VDS_ADDR);
         return false;
     }
-    mcp_.setVoltage(0, false);  // Start at 0 V (no EEPROM write)
-    initialized_ = true;
+    shadowValid_  = mcp_.setVoltage(0, false);  // Start at 0 V (no EEPROM write)
+    currentValue_ = 0;
+    initialized_  = true;
     LOG_INFO("ExternalDAC2 MCP4725 initialized at 0x%02X (12-bit, %.3f mV/step)",
              EXT_DAC_VDS_ADDR, getResolution() * 1000.0f);
     return true;
@@ -180,15 +361,19 @@ void ExternalDAC2::setVoltage(float voltage) {
     if (voltage < 0.0f)       voltage = 0.0f;
     if (voltage > maxVoltage_) voltage = maxVoltage_;
 
-    currentValue_ = static_cast<uint16_t>((voltage / EXT_DAC_VREF) * EXT_DAC_MAX_VALUE);
-    if (currentValue_ > EXT_DAC_MAX_VALUE) currentValue_ = EXT_DAC_MAX_VALUE;
+    uint16_t code = static_cast<uint16_t>((voltage / EXT_DAC_VREF) * EXT_DAC_MAX_VALUE);
+    if (code > EXT_DAC_MAX_VALUE) code = EXT_DAC_MAX_VALUE;
+
+    if (shadowValid_ && code == currentValue_) { dacElided++; return; }
 
-    mcp_.setVoltage(currentValue_, false);  // Write to DAC register, not EEPROM
+    currentValue_ = code;
+    shadowValid_  = mcp_.setVoltage(currentValue_, false);  // Write to DAC register, not EEPROM
+    dacWritten++;
 }
 
 void ExternalDAC2::shutdown() {
     if (!initialized_) return;
-    mcp_.setVoltage(0, false);
+    shadowValid_  = mcp_.setVoltage(0, false);  // Always written: safety path
     currentValue_ = 0;
 }
 
@@ -197,10 +382,52 @@ void ExternalDAC2::shutdown() {
 // ExternalADC (ADS1115) Implementation
 // ============================================================================
 
-ExternalADC::ExternalADC(uint8_t i2cAddr, uint16_t oversamplingCount)
-    : i2cAddr_(i2cAddr), oversamplingCount_(oversamplingCount) {
+// ============================================================================
+// AdsReadySource (ADS1115 ALERT/RDY) Implementation
+// ============================================================================
+
+void IRAM_ATTR AdsReadySource::onReady(void* arg) {
+    AdsReadySource* self = static_cast<AdsReadySource*>(arg);
+    TaskHandle_t waiter = self->waiter_;
+    if (!waiter) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(waiter, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+bool AdsReadySource::start() {
+    if (!wired()) return false;
+    waiter_ = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, 0);  // Drop a stale count from an earlier capture
+    attachInterruptArg(digitalPinToInterrupt(alertPin_), onReady, this, FALLING);
+
+    // Continuous mode; the Adafruit driver also sets the threshold registers
+    // that turn ALERT/RDY into a conversion-ready pulse
+    ads_.startADCReading(ADS1X15_REG_CONFIG_MUX_SINGLE_0, /*continuous=*/true);
+    return true;
+}
+
+void AdsReadySource::stop() {
+    if (!wired()) return;
+    detachInterrupt(digitalPinToInterrupt(alertPin_));
+    waiter_ = nullptr;
+    // A single-shot start leaves the converter powered down after one conversion
+    ads_.startADCReading(ADS1X15_REG_CONFIG_MUX_SINGLE_0, /*continuous=*/false);
+}
+
+uint32_t AdsReadySource::waitReady(uint32_t timeoutUs) {
+    return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutUs / 1000) + 1);
+}
+
+int16_t AdsReadySource::readConversion() {
+    return ads_.getLastConversionResults();
+}
+
+
+ExternalADC::ExternalADC(uint8_t i2cAddr, uint16_t oversamplingCount, int8_t alertPin)
+    : i2cAddr_(i2cAddr), oversamplingCount_(oversamplingCount), ready_(ads_, alertPin) {
     if (oversamplingCount_ < 1)   oversamplingCount_ = 1;
-    if (oversamplingCount_ > 256) oversamplingCount_ = 256;
+    if (oversamplingCount_ > OVERSAMPLING_MAX_SAMPLES) oversamplingCount_ = OVERSAMPLING_MAX_SAMPLES;
 }
 
 bool ExternalADC::begin() {
@@ -216,9 +443,12 @@ bool ExternalADC::begin() {
     // 860 SPS: fastest rate → ~1.16 ms/sample (vs 7.8 ms at default 128 SPS)
     // With 64 oversampling samples: ~74 ms/point (vs ~500 ms at 128 SPS)
     ads_.setDataRate(RATE_ADS1115_860SPS);
+    if (ready_.wired()) pinMode(ready_.pin(), INPUT_PULLUP);  // ALERT/RDY is open-drain
+    continuous_  = ready_.wired();
     initialized_ = true;
-    LOG_INFO("ExternalADC ADS1115 initialized at 0x%02X (16-bit, GAIN_SIXTEEN, %d samples, ~%.1f ENOB)",
-             i2cAddr_, oversamplingCount_, getEffectiveBits());
+    LOG_INFO("ExternalADC ADS1115 initialized at 0x%02X (16-bit, GAIN_SIXTEEN, %d samples, ~%.1f ENOB, %s)",
+             i2cAddr_, oversamplingCount_, getEffectiveBits(),
+             continuous_ ? "continuous, ALERT/RDY" : "single-shot");
     return true;
 }
 
@@ -231,39 +461,72 @@ uint16_t ExternalADC::readRaw() {
 float ExternalADC::readVoltage() {
     if (!initialized_) { LOG_ERROR("ExternalADC 0x%02X not initialized!", i2cAddr_); return 0.0f; }
 
-    // ── Sample collection (same algorithm as InternalADC) ──────────────────
+    bool  clipped = false;
+    float volts   = sampleVoltage(clipped);
+
+    // ── Auto-range ──────────────────────────────────────────────────────────
+    // A clipped reading is wrong, not just coarse: repeat it one range wider.
+    // The next point then starts from this reading's headroom.
+    if (autoRange_) {
+        while (clipped && rangeIndex_ > 0) {
+            applyRange(rangeIndex_ - 1);
+            LOG_DEBUG("ExternalADC clipped - reading again at ±%.3f V", fsr_);
+            volts = sampleVoltage(clipped);
+        }
+        lastFsr_ = fsr_;
+        const uint8_t next = pgaNextRange(rangeIndex_, volts, clipped);
+        if (next != rangeIndex_) applyRange(next);
+    } else {
+        lastFsr_ = fsr_;
+    }
+    return volts;
+}
+
+float ExternalADC::sampleVoltage(bool& clipped) {
+    // ── Sample collection ──────────────────────────────────────────────────
     // ADS1115 raw: signed 16-bit; clamp negatives to 0 (0 V floor)
-    uint16_t samples[256];
+    // Adaptive: stop once the standard error reaches the target precision
     const uint16_t n = oversamplingCount_;
-    for (uint16_t i = 0; i < n; i++) {
-        int16_t raw = ads_.readADC_SingleEnded(0);
-        samples[i] = (raw < 0) ? 0 : static_cast<uint16_t>(raw);
+    const float absCodes = adaptive_.absPrecision * (EXT_ADC_MAX_RAW / fsr_);
+    SequentialMean seq;
+    auto enough = [&](uint16_t code) {
+        seq.add(code);
+        return adaptive_.enabled && seq.precise(adaptive_, absCodes);
+    };
+
+    uint16_t samples[OVERSAMPLING_MAX_SAMPLES];
+    uint16_t got  = 0;
+    bool     done = false;
+    if (continuous_) {
+        // One configuration write per point; the task sleeps between conversions
+        const uint32_t timeouts = continuousStats_.timeouts;
+        got  = acquireContinuous(ready_, samples, n, &continuousStats_, enough);
+        done = got > 0 && continuousStats_.timeouts == timeouts;
+        if (!done) {
+            continuous_ = false;
+            LOG_WARN("ExternalADC: no ALERT/RDY signal on GPIO%d - back to single-shot", ready_.pin());
+        }
     }
-
-    // ── Insertion Sort ─────────────────────────────────────────────────────
-    for (uint16_t i = 1; i < n; i++) {
-        uint16_t key = samples[i];
-        int16_t  j   = static_cast<int16_t>(i) - 1;
-        while (j >= 0 && samples[j] > key) { samples[j + 1] = samples[j]; j--; }
-        samples[j + 1] = key;
+    while (!done && got < n) {
+        int16_t raw = ads_.readADC_SingleEnded(0);
+        samples[got] = (raw < 0) ? 0 : static_cast<uint16_t>(raw);
+        done = enough(samples[got++]);
     }
+    lastSampleCount_ = got;
 
-    // ── Trimmed Mean (10% / 10%) ───────────────────────────────────────────
-    const uint16_t trim  = n / 10;
-    const uint16_t start = trim;
-    const uint16_t end   = n - trim;
-    uint32_t sum = 0; uint16_t count = 0;
-    for (uint16_t i = start; i < end; i++) { sum += samples[i]; count++; }
-    if (count == 0) count = 1;
+    uint16_t peak = 0;
+    for (uint16_t i = 0; i < got; i++) if (samples[i] > peak) peak = samples[i];
+    clipped = peak >= EXT_ADC_MAX_RAW;
 
-    const float avgRaw = static_cast<float>(sum) / count;
+    // ── Estimator (same as InternalADC) ────────────────────────────────────
+    const float avgRaw = reduceSamples(method_, samples, got);
     // voltage = raw * (FSR / 32767) — FSR is set by the active PGA gain
     return avgRaw * (fsr_ / static_cast<float>(EXT_ADC_MAX_RAW));
 }
 
 void ExternalADC::setOversamplingCount(uint16_t count) {
     if (count < 1)   count = 1;
-    if (count > 256) count = 256;
+    if (count > OVERSAMPLING_MAX_SAMPLES) count = OVERSAMPLING_MAX_SAMPLES;
     oversamplingCount_ = count;
     LOG_DEBUG("ExternalADC oversampling → %d samples (~%.1f ENOB)", count, getEffectiveBits());
 }
@@ -274,21 +537,57 @@ float ExternalADC::getEffectiveBits() const {
 }
 
 void ExternalADC::setGain(uint8_t gainCode) {
-    adsGain_t g;
-    float fsr;
-    switch (gainCode) {
-        case  0: g = GAIN_TWOTHIRDS; fsr = 6.144f; break;
-        case  1: g = GAIN_ONE;       fsr = 4.096f; break;
-        case  2: g = GAIN_TWO;       fsr = 2.048f; break;
-        case  4: g = GAIN_FOUR;      fsr = 1.024f; break;
-        case  8: g = GAIN_EIGHT;     fsr = 0.512f; break;
-        case 16: g = GAIN_SIXTEEN;   fsr = 0.256f; break;
-        default: g = GAIN_SIXTEEN;   fsr = 0.256f; break;  // safe fallback
+    applyRange(pgaRangeIndex(gainCode));  // Unknown codes: ±0.256 V (safe fallback)
+    lastFsr_ = fsr_;
+    LOG_INFO("ExternalADC gain set: code=%d, FSR=±%.3f V (%.4f mV/LSB)%s",
+             gainCode, fsr_, (fsr_ / EXT_ADC_MAX_RAW) * 1000.0f, autoRange_ ? ", auto-range" : "");
+}
+
+void ExternalADC::applyRange(uint8_t index) {
+    // Takes effect from the next conversion started, single-shot or continuous
+    rangeIndex_ = index;
+    fsr_        = PGA_RANGES[index].fsr;
+    ads_.setGain(adsGain(PGA_RANGES[index]));
+}
+
+
+// ============================================================================
+// HybridADC (GPIO34 coarse + ADS1115 fine) Implementation
+// ============================================================================
+
+HybridADC::HybridADC(std::unique_ptr<ExternalADC> fine, uint8_t coarsePin, float floorV)
+    : fine_(std::move(fine)), coarse_(coarsePin, HYBRID_COARSE_SAMPLES), floorV_(floorV) {
+    fine_->setAutoRange(true);  // Keeps the re-read of a clipped fine reading
+}
+
+void HybridADC::begin() {
+    coarse_.begin();
+    LOG_INFO("HybridADC: GPIO coarse read (%u samples) picks the ADS1115 range; "
+             "widest range at >= %.2f V, fine conversion skipped when GPIO clips%s",
+             (unsigned)HYBRID_COARSE_SAMPLES, HYBRID_WIDE_RANGE_V, floorV_ > 0.0f ? " or below the floor" : "");
+}
+
+float HybridADC::readVoltage() {
+    const float coarse = coarse_.readVoltage();
+
+    // Clipped (compliance) or below the floor: the 16-bit reading adds nothing
+    const bool offScale   = coarse_.getLastClipped();
+    const bool belowFloor = coarse < floorV_;
+    if (offScale || belowFloor) {
+        if (offScale) hybridOffScale++;
+        else          hybridBelowFloor++;
+        lastSampleCount_ = coarse_.getLastSampleCount();
+        lastFsr_         = coarse_.getLastFullScale();
+        return coarse;
     }
-    ads_.setGain(g);
-    fsr_ = fsr;
-    LOG_INFO("ExternalADC gain set: code=%d, FSR=±%.3f V (%.4f mV/LSB)",
-             gainCode, fsr, (fsr / EXT_ADC_MAX_RAW) * 1000.0f);
+
+    // Near the top of the 11 dB curve the coarse volts are too low to trust
+    fine_->applyRange(coarse >= HYBRID_WIDE_RANGE_V ? 0 : pgaRangeFor(coarse + HYBRID_COARSE_MARGIN));
+    const float fine = fine_->readVoltage();
+    hybridFine++;
+    lastSampleCount_ = fine_->getLastSampleCount();
+    lastFsr_         = fine_->getLastFullScale();
+    return fine;
 }
 
 
@@ -362,13 +661,15 @@ void HardwareHAL::initInternal(const HalConfig& config) {
     auto adc = std::make_unique<InternalADC>(config.adc_shunt_pin, config.adc_oversampling);
     adc->begin();
     adcShunt_ = std::move(adc);
+    adcShunt_->setOversamplingMethod(config.adc_method);
+    adcShunt_->setAdaptive(config.adc_adaptive);
 
     LOG_INFO("  [INTERNAL] VDS: InternalDAC GPIO%d (8-bit, %.1f mV/step)",
              DAC_VDS_PIN, dacVDS_->getResolution() * 1000.0f);
     LOG_INFO("  [INTERNAL] VGS: InternalDAC GPIO%d (8-bit, %.1f mV/step)",
              DAC_VGS_PIN, dacVGS_->getResolution() * 1000.0f);
-    LOG_INFO("  [INTERNAL] ADC: InternalADC  GPIO%d (12-bit, %d samples)",
-             config.adc_shunt_pin, config.adc_oversampling);
+    LOG_INFO("  [INTERNAL] ADC: InternalADC  GPIO%d (12-bit, %d samples, %s)",
+             config.adc_shunt_pin, config.adc_oversampling, oversamplingMethodName(config.adc_method));
 }
 
 void HardwareHAL::initExternal(const HalConfig& config) {
@@ -395,22 +696,57 @@ void HardwareHAL::initExternal(const HalConfig& config) {
     }
 
     // Shunt ADC — ExternalADC ADS1115 (I2C 0x48, channel A0)
-    auto adc = std::make_unique<ExternalADC>(EXT_ADC_ADDR, config.adc_oversampling);
+    auto adc = std::make_unique<ExternalADC>(EXT_ADC_ADDR, config.adc_oversampling, config.ads_alert_pin);
     if (!adc->begin()) {
         LOG_ERROR("ExternalADC (ADS1115) init failed — falling back to InternalADC");
         auto adc_fallback = std::make_unique<InternalADC>(config.adc_shunt_pin, config.adc_oversampling);
         adc_fallback->begin();
         adcShunt_ = std::move(adc_fallback);
+    } else if (config.ads_hybrid) {
+        auto hybrid = std::make_unique<HybridADC>(std::move(adc), config.adc_shunt_pin, config.hybrid_floor_v);
+        hybrid->begin();
+        adcShunt_ = std::move(hybrid);
     } else {
+        adc->setAutoRange(config.ads_autorange);
+        adc->setGain(config.ads_gain);
         adcShunt_ = std::move(adc);
     }
+    adcShunt_->setOversamplingMethod(config.adc_method);
+    adcShunt_->setAdaptive(config.adc_adaptive);
 
     LOG_INFO("  [EXTERNAL] VDS: ExternalDAC2 MCP4725 0x%02X (12-bit, %.3f mV/step)",
              EXT_DAC_VDS_ADDR, dacVDS_->getResolution() * 1000.0f);
     LOG_INFO("  [EXTERNAL] VGS: ExternalDAC  MCP4725 0x%02X (12-bit, %.3f mV/step)",
              EXT_DAC_VGS_ADDR, dacVGS_->getResolution() * 1000.0f);
-    LOG_INFO("  [EXTERNAL] ADC: ExternalADC  ADS1115 0x%02X (16-bit, %d samples, ~%.1f ENOB)",
-             EXT_ADC_ADDR, config.adc_oversampling, adcShunt_->getEffectiveBits());
+    LOG_INFO("  [EXTERNAL] ADC: %s ADS1115 0x%02X (16-bit, %d samples, %s, ~%.1f ENOB)",
+             config.ads_hybrid ? "HybridADC  " : "ExternalADC", EXT_ADC_ADDR, config.adc_oversampling, oversamplingMethodName(config.adc_method),
+             adcShunt_->getEffectiveBits());
+}
+
+HardwareHAL::DacWriteStats HardwareHAL::getDacWriteStats() {
+    DacWriteStats stats;
+    stats.written = dacWritten;
+    stats.elided  = dacElided;
+    return stats;
+}
+
+void HardwareHAL::resetDacWriteStats() {
+    dacWritten = 0;
+    dacElided  = 0;
+}
+
+HardwareHAL::HybridStats HardwareHAL::getHybridStats() {
+    HybridStats stats;
+    stats.fine       = hybridFine;
+    stats.offScale   = hybridOffScale;
+    stats.belowFloor = hybridBelowFloor;
+    return stats;
+}
+
+void HardwareHAL::resetHybridStats() {
+    hybridFine       = 0;
+    hybridOffScale   = 0;
+    hybridBelowFloor = 0;
 }
 
 void HardwareHAL::shutdown() {
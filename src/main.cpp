@@ -19,6 +19,9 @@
 #include "hardware_hal.h"
 
 #include "file_manager.h"
+#include "golden_store.h"
+#include "analysis_cache.h"
+#include "savitzky_golay.h"
 #include <FFat.h>
 #include "email_manager.h"
 
@@ -141,6 +144,34 @@ void handleStartMeasurement(AsyncWebServerRequest *request, uint8_t *data, size_
   const char* sweepModeStr = doc["sweep_mode"] | "VGS";
   config.sweep_mode = (strcmp(sweepModeStr, "VDS") == 0) ? SWEEP_VDS : SWEEP_VGS;
   
+  // Drain current that defines the constant-current Vt (A)
+  config.vt_current = doc["vt_current"] | 1e-5f;
+  
+  // Subthreshold-swing estimator: "window" (default), "theil_sen" or "ransac"
+  const char* ssMethodStr = doc["ss_method"] | "window";
+  if (strcmp(ssMethodStr, "theil_sen") == 0) {
+    config.ss_method = math_engine::SSMethod::TheilSen;
+  } else if (strcmp(ssMethodStr, "ransac") == 0) {
+    config.ss_method = math_engine::SSMethod::Ransac;
+  } else {
+    config.ss_method = math_engine::SSMethod::SlidingWindow;
+  }
+  
+  // Bootstrap resamples per curve for Vt/SS/Gm intervals (0 = off, at most 256)
+  int bootstrap = doc["bootstrap"] | 0;
+  config.bootstrap_iterations = (bootstrap < 0) ? 0 : (bootstrap > 256 ? 256 : bootstrap);
+  
+  // Golden reference to bin against (transfer sweeps only; empty = off)
+  const char* partNumber = doc["part_number"] | "";
+  config.part_number = String(partNumber);
+  if (config.part_number.length() > 0 && !GoldenStore::isValidPartNumber(config.part_number)) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"invalid_part_number\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
   // Oversampling configuration (1 = disabled, 16 = default)
   uint16_t oversampling = doc["oversampling"] | 16;
   config.oversampling = oversampling;
@@ -148,9 +179,34 @@ void handleStartMeasurement(AsyncWebServerRequest *request, uint8_t *data, size_
   // ADC instance with halCfg.adc_oversampling, making a prior call redundant.
   LOG_INFO("ADC oversampling set to %d (%s)", oversampling, oversampling > 1 ? "enabled" : "disabled");
 
+  // Estimator reducing the samples: "trimmed" (default), "histogram", "minmax"
+  const char* methodStr = doc["oversampling_method"] | "trimmed";
+  if (strcmp(methodStr, "histogram") == 0) {
+    config.oversampling_method = hal::OversamplingMethod::Histogram;
+  } else if (strcmp(methodStr, "minmax") == 0) {
+    config.oversampling_method = hal::OversamplingMethod::MinMaxReject;
+  } else {
+    config.oversampling_method = hal::OversamplingMethod::TrimmedMean;
+  }
+
+  // Adaptive oversampling: stop each point once its standard error is below
+  // precision_rel * |reading| or precision_abs_uv; "oversampling" is the cap
+  config.adaptive.enabled      = doc["adaptive"] | false;
+  config.adaptive.relPrecision = doc["precision_rel"] | 0.002f;
+  config.adaptive.absPrecision = (doc["precision_abs_uv"] | 0.0f) * 1e-6f;
+  int minSamples = doc["min_samples"] | 4;
+  config.adaptive.minSamples   = (minSamples < 2) ? 2 : (minSamples > 256 ? 256 : minSamples);
+
   // ADC PGA gain (0=±6.144V 1=±4.096V 2=±2.048V 4=±1.024V 8=±0.512V 16=±0.256V)
   uint8_t adcGain = (uint8_t)(doc["adc_gain"] | 2);  // default: GAIN_TWO
   config.adc_gain = adcGain;
+  // Auto-range: adc_gain is only the first point's range; each point then
+  // takes the range that fits the previous reading
+  config.adc_autorange = doc["adc_autorange"] | false;
+  // Hybrid ranging: a GPIO34 read ahead of each ADS1115 reading picks the
+  // range and skips points where GPIO34 clips or below hybrid_floor_mv
+  config.hybrid_adc     = doc["hybrid_adc"] | false;
+  config.hybrid_floor_v = (doc["hybrid_floor_mv"] | 0.0f) * 1e-3f;
 
   // Hardware mode: true = external I2C (MCP4725 VGS + ADS1115), false = internal ESP32
   bool useExternal = doc["use_external_hw"] | true;  // default: external
@@ -159,16 +215,14 @@ void handleStartMeasurement(AsyncWebServerRequest *request, uint8_t *data, size_
   hal::HalConfig halCfg;
   halCfg.hardware_mode   = targetMode;
   halCfg.adc_oversampling = oversampling;
+  halCfg.adc_method       = config.oversampling_method;
+  halCfg.adc_adaptive     = config.adaptive;
+  // PGA gain is applied by initExternal() only when the ADS1115 answered
+  halCfg.ads_gain         = adcGain;
+  halCfg.ads_autorange    = config.adc_autorange;
+  halCfg.ads_hybrid       = config.hybrid_adc;
+  halCfg.hybrid_floor_v   = config.hybrid_floor_v;
   hal::HardwareHAL::instance().switchMode(targetMode, halCfg);
-
-  // Apply PGA gain to ExternalADC (only relevant in external mode)
-  if (useExternal) {
-      // static_cast is safe: we are inside the useExternal==true branch,
-      // so getShuntADC() is guaranteed to return an ExternalADC instance.
-      // dynamic_cast is not available with -fno-rtti on ESP32.
-      auto* extAdc = static_cast<hal::ExternalADC*>(&hal::HardwareHAL::instance().getShuntADC());
-      if (extAdc) extAdc->setGain(adcGain);
-  }
   LOG_INFO("Hardware mode: %s", useExternal ? "EXTERNAL (MCP4725 VDS@0x61 + MCP4725 VGS@0x60 + ADS1115@0x48)" : "INTERNAL (ESP32)");
   
   // Validate
@@ -239,8 +293,29 @@ void handleGetProgress(AsyncWebServerRequest *request)
   json += "\"vds\":" + String(progress.current_vds, 3) + ",";
   json += "\"message\":\"" + progress.message + "\",";
   json += "\"error\":" + String(progress.has_error ? "true" : "false") + ",";
-  json += "\"error_msg\":\"" + progress.error_message + "\"";
-  json += "}";
+  json += "\"error_msg\":\"" + progress.error_message + "\",";
+  
+  const char* bin = "none";
+  switch (progress.bin) {
+    case BIN_PASS:       bin = "pass";       break;
+    case BIN_FAIL:       bin = "fail";       break;
+    case BIN_INCOMPLETE: bin = "incomplete"; break;
+    default: break;
+  }
+  json += "\"bin\":\"" + String(bin) + "\",";
+  json += "\"devices_tested\":" + String(progress.devices_tested) + ",";
+  json += "\"devices_passed\":" + String(progress.devices_passed) + ",";
+  
+  // Family analysis of the current or last transfer sweep; null until known
+  const auto& fam = progress.family;
+  json += "\"family\":{";
+  json += "\"curves\":" + String(fam.curves) + ",";
+  json += "\"dibl_mv_per_v\":" + (fam.diblValid ? String(fam.dibl, 2) : String("null")) + ",";
+  json += "\"dvt_dvds_mv_per_v\":" + (fam.diblValid ? String(fam.vtSlope, 2) : String("null")) + ",";
+  json += "\"dss_dvds_mv_dec_per_v\":" + (fam.ssCurves >= 2 ? String(fam.ssSlope, 3) : String("null")) + ",";
+  json += "\"ss_min\":" + (fam.ssCurves > 0 ? String(fam.ssMin, 2) : String("null")) + ",";
+  json += "\"ss_max\":" + (fam.ssCurves > 0 ? String(fam.ssMax, 2) : String("null"));
+  json += "}}";
   
   AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
   response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
@@ -447,6 +522,7 @@ void handleDeleteFile(AsyncWebServerRequest *request)
   bool success = FileManager::deleteFile(filename);
   
   if (success) {
+    AnalysisCache::forget(filename);
     int count = FileManager::countFiles();
     String json = "{\"success\":true,\"count\":" + String(count) + "}";
     AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
@@ -477,6 +553,7 @@ void handleDeleteAllFiles(AsyncWebServerRequest *request)
   }
   
   LOG_INFO("Deleted %d files, %d failed", deleted, failed);
+  AnalysisCache::clear();
   
   size_t freeBytes = FFat.freeBytes();
   size_t totalBytes = FFat.totalBytes();
@@ -508,6 +585,202 @@ void handleStorageInfo(AsyncWebServerRequest *request)
   request->send(response);
 }
 
+// ============================================================================
+// Stored-run analysis (cached on FFat)
+// ============================================================================
+
+// GET /api/analysis?file=run_1712345678.csv[&window=5&order=2&sg=1&vt_current=1e-5&ss_method=window]
+void handleAnalysis(AsyncWebServerRequest *request)
+{
+  if (!request->hasParam("file")) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"missing_file\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
+  String filename = request->getParam("file")->value();
+  LOG_INFO("HTTP GET /api/analysis?file=%s", filename.c_str());
+  
+  // Parameters left out take the values the live analysis uses. Window and
+  // order are normalised as sg::selectKernel() would (even windows round
+  // up, both clamped to the tabulated range) before they reach the hash, so
+  // requests that analyse alike share one cache entry
+  AnalysisParams params;
+  if (request->hasParam("window")) {
+    long window = request->getParam("window")->value().toInt();
+    if (window % 2 == 0) window++;
+    window = constrain(window, (long)math_engine::sg::MIN_WINDOW, (long)math_engine::sg::MAX_WINDOW);
+    params.gm.smoothingWindow = window;
+  }
+  if (request->hasParam("order")) {
+    long order = request->getParam("order")->value().toInt();
+    params.gm.polyOrder = constrain(order, (long)math_engine::sg::MIN_ORDER, (long)math_engine::sg::MAX_ORDER);
+  }
+  if (request->hasParam("sg"))         params.gm.useSavitzkyGolay = request->getParam("sg")->value().toInt() != 0;
+  if (request->hasParam("vt_current")) params.vtCurrent           = request->getParam("vt_current")->value().toFloat();
+  if (!(params.vtCurrent > 0) || isinf(params.vtCurrent)) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"invalid_vt_current\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  if (request->hasParam("ss_method")) {
+    String method = request->getParam("ss_method")->value();
+    if (method == "theil_sen")   params.ssMethod = math_engine::SSMethod::TheilSen;
+    else if (method == "ransac") params.ssMethod = math_engine::SSMethod::Ransac;
+  }
+  
+  if (!FileManager::isValidFilename(filename)) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"invalid_filename\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
+  // A miss is analysed on the cache worker; the client asks again
+  AnalysisBlock block;
+  bool fromCache = false;
+  AnalysisCache::Lookup lookup = AnalysisCache::request(filename, params, block, fromCache);
+  if (lookup == AnalysisCache::Lookup::Pending || lookup == AnalysisCache::Lookup::Busy) {
+    bool pending = lookup == AnalysisCache::Lookup::Pending;
+    AsyncWebServerResponse *response = request->beginResponse(pending ? 202 : 503, "application/json",
+      pending ? "{\"status\":\"pending\"}" : "{\"error\":\"analysis_busy\"}");
+    response->addHeader("Retry-After", "1");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  if (lookup == AnalysisCache::Lookup::Failed) {
+    AsyncWebServerResponse *response = request->beginResponse(404, "application/json",
+      "{\"error\":\"not_a_transfer_sweep\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
+  char key[24];
+  snprintf(key, sizeof(key), "%08lx_%08lx", (unsigned long)block.fileCrc, (unsigned long)block.paramsHash);
+  String json = "{\"file\":\"" + filename + "\",";
+  json += "\"key\":\"" + String(key) + "\",";
+  json += "\"cached\":" + String(fromCache ? "true" : "false") + ",";
+  json += "\"curves\":[";
+  for (size_t i = 0; i < block.curves.size(); i++) {
+    const CachedCurve& c = block.curves[i];
+    if (i > 0) json += ",";
+    json += "{\"vds\":" + String(c.vds, 3) + ",";
+    json += "\"points\":" + String(c.points) + ",";
+    json += "\"vt\":" + String(c.vt, 4) + ",";
+    json += "\"vt_d2\":" + String(c.vtSecondDerivative, 4) + ",";
+    json += "\"vt_cc\":" + String(c.vtConstantCurrent, 4) + ",";
+    json += "\"vt_y\":" + String(c.vtYFunction, 4) + ",";
+    json += "\"ss\":" + String(c.ss, 2) + ",";
+    char gm[16];
+    snprintf(gm, sizeof(gm), "%.3e", c.maxGm);
+    json += "\"max_gm\":" + String(gm) + ",";
+    json += "\"ss_tangent\":[" + String(c.ssX1, 3) + "," + String(c.ssY1, 3) + ","
+          + String(c.ssX2, 3) + "," + String(c.ssY2, 3) + "]}";
+  }
+  json += "]}";
+  
+  AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
+  addCORSHeaders(response);
+  request->send(response);
+}
+
+// ============================================================================
+// Golden references (pass/fail binning)
+// ============================================================================
+
+void handleListGolden(AsyncWebServerRequest *request)
+{
+  LOG_DEBUG("HTTP GET /api/golden from %s", request->client()->remoteIP().toString().c_str());
+  
+  auto parts = GoldenStore::listParts();
+  String json = "{\"parts\":[";
+  for (size_t i = 0; i < parts.size(); i++) {
+    if (i > 0) json += ",";
+    json += "\"" + parts[i] + "\"";
+  }
+  json += "],\"count\":" + String(parts.size()) + "}";
+  
+  AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
+  response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+  addCORSHeaders(response);
+  request->send(response);
+}
+
+// POST /api/golden/create?part=BS170&file=bs170_ref_1712345678.csv[&rmse=..&r2=..&chi2=..]
+void handleCreateGolden(AsyncWebServerRequest *request)
+{
+  if (!request->hasParam("part") || !request->hasParam("file")) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"missing_part_or_file\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
+  String part = request->getParam("part")->value();
+  String filename = request->getParam("file")->value();
+  LOG_INFO("HTTP POST /api/golden/create?part=%s&file=%s", part.c_str(), filename.c_str());
+  
+  // Limits left out are not checked (0)
+  math_engine::GoldenTolerance tolerance;
+  if (request->hasParam("rmse")) tolerance.maxRmse = request->getParam("rmse")->value().toFloat();
+  if (request->hasParam("r2"))   tolerance.minR2   = request->getParam("r2")->value().toFloat();
+  if (request->hasParam("chi2")) tolerance.maxChi2 = request->getParam("chi2")->value().toFloat();
+  
+  if (!GoldenStore::isValidPartNumber(part) || !FileManager::isValidFilename(filename)) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"invalid_part_or_file\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
+  if (GoldenStore::createFromMeasurement(part, filename, tolerance)) {
+    AsyncWebServerResponse *response = request->beginResponse(200, "application/json",
+      "{\"success\":true,\"part\":\"" + part + "\"}");
+    addCORSHeaders(response);
+    request->send(response);
+  } else {
+    AsyncWebServerResponse *response = request->beginResponse(500, "application/json",
+      "{\"error\":\"create_failed\"}");
+    addCORSHeaders(response);
+    request->send(response);
+  }
+}
+
+void handleDeleteGolden(AsyncWebServerRequest *request)
+{
+  if (!request->hasParam("part")) {
+    AsyncWebServerResponse *response = request->beginResponse(400, "application/json",
+      "{\"error\":\"missing_part\"}");
+    addCORSHeaders(response);
+    request->send(response);
+    return;
+  }
+  
+  String part = request->getParam("part")->value();
+  LOG_INFO("HTTP POST /api/golden/delete?part=%s", part.c_str());
+  
+  if (GoldenStore::remove(part)) {
+    AsyncWebServerResponse *response = request->beginResponse(200, "application/json",
+      "{\"success\":true}");
+    addCORSHeaders(response);
+    request->send(response);
+  } else {
+    AsyncWebServerResponse *response = request->beginResponse(500, "application/json",
+      "{\"error\":\"delete_failed\"}");
+    addCORSHeaders(response);
+    request->send(response);
+  }
+}
+
 void handleEmailSend(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)
 {
   LOG_INFO("HTTP POST /api/email/send from %s", request->client()->remoteIP().toString().c_str());
@@ -633,6 +906,9 @@ void setup()
   
   if (!FileManager::init()) {
     LOG_ERROR("File system initialization failed");
+  } else {
+    GoldenStore::init();
+    AnalysisCache::init();
   }
   
   pinMode(LED_PIN, OUTPUT);
@@ -680,6 +956,8 @@ void setup()
   server.on("/api/files/download", HTTP_GET, handleDownloadFile);
   server.on("/api/files", HTTP_GET, handleListFiles);
   server.on("/api/storage", HTTP_GET, handleStorageInfo);
+  server.on("/api/golden", HTTP_GET, handleListGolden);
+  server.on("/api/analysis", HTTP_GET, handleAnalysis);
   
   // Email endpoints
   server.on("/api/email/status", HTTP_GET, handleEmailStatus);
@@ -701,6 +979,8 @@ void setup()
   server.on("/api/logs/clear", HTTP_POST, handleClearLogs);
   server.on("/api/files/delete", HTTP_POST, handleDeleteFile);
   server.on("/api/files/delete-all", HTTP_POST, handleDeleteAllFiles);
+  server.on("/api/golden/create", HTTP_POST, handleCreateGolden);
+  server.on("/api/golden/delete", HTTP_POST, handleDeleteGolden);
   
   // CORS preflight handlers
   server.on("/api/start", HTTP_OPTIONS, handleCORS);
@@ -709,6 +989,8 @@ void setup()
   server.on("/api/logs/clear", HTTP_OPTIONS, handleCORS);
   server.on("/api/files/delete", HTTP_OPTIONS, handleCORS);
   server.on("/api/files/delete-all", HTTP_OPTIONS, handleCORS);
+  server.on("/api/golden/create", HTTP_OPTIONS, handleCORS);
+  server.on("/api/golden/delete", HTTP_OPTIONS, handleCORS);
   
   server.onNotFound(handleNotFound);
   
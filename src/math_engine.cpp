@@ -1,68 +1,340 @@
 #include "math_engine.h"
+#include "savitzky_golay.h"
+#include "dsp_kernels.h"
+#include "lm_solver.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <new>
 
 namespace math_engine {
 
+// ============================================================================
+// Scratch Arena
+// ============================================================================
+
+ScratchArena::ScratchArena(void* buffer, size_t bytes)
+    : base_(static_cast<uint8_t*>(buffer)), capacity_(buffer ? bytes : 0) {}
+
+ScratchArena::ScratchArena(size_t bytes) {
+    reserve(bytes);
+}
+
+ScratchArena::~ScratchArena() {
+    release();
+}
+
+void ScratchArena::release() {
+    if (owned_) delete[] base_;
+    base_ = nullptr;
+    capacity_ = 0;
+    used_ = 0;
+    owned_ = false;
+}
+
+bool ScratchArena::reserve(size_t bytes) {
+    if (bytes <= capacity_) return true;
+    release();
+    base_ = new (std::nothrow) uint8_t[bytes];
+    if (!base_) return false;
+    capacity_ = bytes;
+    owned_ = true;
+    return true;
+}
+
+void* ScratchArena::allocBytes(size_t bytes, size_t align) {
+    size_t offset = (used_ + align - 1) & ~(align - 1);
+    if (!base_ || offset + bytes > capacity_) return nullptr;
+    used_ = offset + bytes;
+    if (used_ > highWater_) highWater_ = used_;
+    return base_ + offset;
+}
+
+size_t scratchBytes(size_t points) {
+    const size_t n = points + 1;
+    // CurveAnalyzer: Ids, Gm and the segmentCurve() median buffer, plus the
+    // SSScanner VGS/log10(Ids) buffers, usable mask and WindowedRegression
+    // tables (5 double prefixes + 3 uint32 indices). calculateSS() needs a
+    // subset. The robust SS methods add log10(Ids) and a Theil–Sen pair
+    // buffer for at most SS_ROBUST_MAX_POINTS points, and a non-uniform VGS
+    // grid a GridKernel table of up to MAX_WINDOW taps. 128 bytes of slack
+    // covers per-allocation alignment padding.
+    const size_t m = std::min(points, SS_ROBUST_MAX_POINTS);
+    return 5 * n * sizeof(float) + n * sizeof(uint8_t)
+         + 5 * n * sizeof(double) + 3 * n * sizeof(uint32_t)
+         + (m + m * (m - 1) / 2) * sizeof(float)
+         + gridKernelBytes(n, sg::MAX_WINDOW) + 128;
+}
+
 // ============================================================================
 // Smoothing Functions
 // ============================================================================
 
 std::vector<float> movingAverageSmooth(const std::vector<float>& data, size_t windowSize) {
-    if (data.empty()) return {};
+    std::vector<float> result(data.size());
+    movingAverageSmooth(ConstFloatSpan(data), FloatSpan(result), windowSize);
+    return result;
+}
+
+void movingAverageSmooth(ConstFloatSpan data, FloatSpan result, size_t windowSize) {
+    if (data.empty() || result.size() < data.size()) return;
     if (windowSize < 1) windowSize = 1;
     if (windowSize % 2 == 0) windowSize++;  // Ensure odd window
-    
-    size_t n = data.size();
-    std::vector<float> result(n);
-    int halfWindow = windowSize / 2;
-    
-    for (size_t i = 0; i < n; i++) {
-        float sum = 0;
-        int count = 0;
-        
-        for (int k = -halfWindow; k <= halfWindow; k++) {
-            int idx = static_cast<int>(i) + k;
-            if (idx >= 0 && idx < static_cast<int>(n)) {
-                sum += data[idx];
-                count++;
-            }
-        }
-        result[i] = sum / count;
+
+    kernels::runningMean(data.data(), result.data(), data.size(), windowSize);
+}
+
+// ============================================================================
+// Savitzky-Golay Kernels
+// ============================================================================
+
+namespace sg {
+
+namespace {
+
+#define SG_KERNEL(W, O) \
+    { W, O, Design<W, O>::proj.data(), \
+      { Design<W, O>::d0.data(), Design<W, O>::d1.data(), Design<W, O>::d2.data() } }
+
+#define SG_WINDOW(W) SG_KERNEL(W, 2), SG_KERNEL(W, 3), SG_KERNEL(W, 4)
+
+// Every table below is evaluated by the compiler and lands in flash.
+const Kernel KERNELS[] = {
+    SG_WINDOW(5), SG_WINDOW(7), SG_WINDOW(9), SG_WINDOW(11)
+};
+
+#undef SG_WINDOW
+#undef SG_KERNEL
+
+} // namespace
+
+const Kernel* findKernel(size_t window, size_t order) {
+    for (const Kernel& k : KERNELS) {
+        if (k.window == window && k.order == order) return &k;
+    }
+    return nullptr;
+}
+
+const Kernel* selectKernel(size_t window, size_t order, size_t n) {
+    if (n < MIN_WINDOW) return nullptr;
+    if (window % 2 == 0) window++;
+    window = std::max(MIN_WINDOW, std::min(MAX_WINDOW, window));
+    while (window > n) window -= 2;
+    order = std::max(MIN_ORDER, std::min(MAX_ORDER, order));
+    return findKernel(window, order);
+}
+
+float derivativeScale(size_t deriv, float step) {
+    float scale = 1.0f;
+    for (size_t d = 0; d < deriv; d++) scale /= step;
+    return scale;
+}
+
+float convolvePoint(const Kernel& kernel, size_t deriv, const float* x) {
+    // One-output correlate() rather than dot(): bit-identical to the
+    // interior apply() computes, whichever kernel backend is built in.
+    float sum;
+    kernels::correlate(x, kernel.window, kernel.center[deriv], kernel.window, &sum);
+    return sum;
+}
+
+float edgePoint(const Kernel& kernel, size_t deriv, const float* in, size_t n, size_t idx, float scale) {
+    const size_t w    = kernel.window;
+    const size_t half = w / 2;
+
+    // Evaluate the polynomial of the first/last full window at offset t
+    // from its centre. d^D/dt^D of t^j = j!/(j-D)! · t^(j-D).
+    const bool   head = idx < half;
+    const float* x    = in + (head ? 0 : n - w);
+    const float  t    = head ? -static_cast<float>(half - idx)
+                             : static_cast<float>(half - (n - 1 - idx));
+
+    float sum = 0;
+    for (size_t j = deriv; j <= kernel.order; j++) {
+        float coeff = 1.0f;
+        for (size_t f = j - deriv + 1; f <= j; f++) coeff *= f;
+        for (size_t p = 0; p < j - deriv; p++) coeff *= t;
+
+        sum += coeff * kernels::dot(kernel.proj + j * w, x, w);
+    }
+    return sum * scale;
+}
+
+void applyEdges(const Kernel& kernel, size_t deriv, const float* in, float* out, size_t n, float scale) {
+    const size_t half = kernel.window / 2;
+    for (size_t e = 0; e < half; e++) {
+        out[e]         = edgePoint(kernel, deriv, in, n, e, scale);
+        out[n - 1 - e] = edgePoint(kernel, deriv, in, n, n - 1 - e, scale);
     }
-    
-    return result;
 }
 
+void apply(const Kernel& kernel, size_t deriv, const float* in, float* out, size_t n, float step) {
+    const size_t w    = kernel.window;
+    const size_t half = w / 2;
+    if (deriv > MAX_DERIV || n < w) {
+        for (size_t i = 0; i < n; i++) out[i] = 0.0f;
+        return;
+    }
+
+    const float scale = derivativeScale(deriv, step);
+
+    // Interior: one dot product per point, then the derivative scale
+    kernels::correlate(in, n, kernel.center[deriv], w, out + half);
+    kernels::scale(out + half, out + half, n - 2 * half, scale);
+
+    // Edges: fitted polynomial of the nearest full window
+    applyEdges(kernel, deriv, in, out, n, scale);
+}
+
+} // namespace sg
+
 std::vector<float> savitzkyGolaySmooth(const std::vector<float>& data, size_t windowSize, size_t polyOrder) {
-    // Simplified Savitzky-Golay using pre-calculated coefficients for window=5, order=2
-    // For ESP32 embedded use, we use a simpler moving average variant
-    // Full S-G would require matrix inversion which is expensive
-    
-    if (data.size() < 5) return movingAverageSmooth(data, windowSize);
-    
-    // Coefficients for window=5, polynomial order=2 (normalized)
-    // H = [-3, 12, 17, 12, -3] / 35
-    const float c[] = {-3.0f/35.0f, 12.0f/35.0f, 17.0f/35.0f, 12.0f/35.0f, -3.0f/35.0f};
-    
-    size_t n = data.size();
-    std::vector<float> result(n);
-    
-    // Apply convolution with boundary handling
+    std::vector<float> result(data.size());
+    savitzkyGolaySmooth(ConstFloatSpan(data), FloatSpan(result), windowSize, polyOrder);
+    return result;
+}
+
+void savitzkyGolaySmooth(ConstFloatSpan data, FloatSpan out, size_t windowSize, size_t polyOrder) {
+    if (out.size() < data.size()) return;
+    const sg::Kernel* kernel = sg::selectKernel(windowSize, polyOrder, data.size());
+    if (!kernel) {
+        movingAverageSmooth(data, out, windowSize);
+        return;
+    }
+    sg::apply(*kernel, 0, data.data(), out.data(), data.size());
+}
+
+std::vector<float> savitzkyGolayDerivative(
+    const std::vector<float>& data,
+    float step,
+    size_t windowSize,
+    size_t polyOrder,
+    size_t deriv
+) {
+    std::vector<float> result(data.size());
+    savitzkyGolayDerivative(ConstFloatSpan(data), FloatSpan(result), step, windowSize, polyOrder, deriv);
+    return result;
+}
+
+void savitzkyGolayDerivative(
+    ConstFloatSpan data,
+    FloatSpan out,
+    float step,
+    size_t windowSize,
+    size_t polyOrder,
+    size_t deriv
+) {
+    if (out.size() < data.size()) return;
+    const sg::Kernel* kernel = sg::selectKernel(windowSize, polyOrder, data.size());
+    if (!kernel || deriv > sg::MAX_DERIV || fabs(step) < 1e-9f) {
+        std::fill(out.begin(), out.begin() + data.size(), 0.0f);
+        return;
+    }
+    sg::apply(*kernel, deriv, data.data(), out.data(), data.size(), step);
+}
+
+// ============================================================================
+// Non-uniform Grid Derivatives
+// ============================================================================
+
+size_t GridKernel::start(size_t i) const {
+    const size_t half = window / 2;
+    return i < half ? 0 : std::min(i - half, size - window);
+}
+
+float GridKernel::at(ConstFloatSpan y, size_t i) const {
+    return kernels::dot(weights + i * window, y.data() + start(i), window);
+}
+
+void GridKernel::apply(ConstFloatSpan y, FloatSpan out) const {
+    if (!valid() || y.size() != size || out.size() < size) return;
+    for (size_t i = 0; i < size; i++) out[i] = at(y, i);
+}
+
+size_t gridKernelBytes(size_t points, size_t window) {
+    return points * window * sizeof(float) + alignof(float);
+}
+
+bool buildGridKernel(ConstFloatSpan x, ScratchArena& arena, GridKernel& kernel,
+                     size_t windowSize, size_t polyOrder, size_t deriv) {
+    kernel = GridKernel();
+    const size_t n = x.size();
+    const sg::Kernel* shape = sg::selectKernel(windowSize, polyOrder, n);
+    if (!shape || deriv > sg::MAX_DERIV) return false;
+
+    const size_t w = shape->window;
+    const size_t p = shape->order + 1;
+    FloatSpan weights = arena.alloc<float>(n * w);
+    if (weights.size() < n * w) return false;
+
+    GridKernel k;
+    k.window  = w;
+    k.size    = n;
+    k.weights = weights.data();
+
     for (size_t i = 0; i < n; i++) {
-        float sum = 0;
-        for (int k = -2; k <= 2; k++) {
-            int idx = static_cast<int>(i) + k;
-            // Clamp to valid indices
-            if (idx < 0) idx = 0;
-            if (idx >= static_cast<int>(n)) idx = n - 1;
-            sum += data[idx] * c[k + 2];
+        // Fit in t = (x - x[i]) / h, h the mean step of the window, so the
+        // normal equations stay well conditioned whatever the VGS scale
+        const size_t first = k.start(i);
+        const double h = (static_cast<double>(x[first + w - 1]) - x[first]) / (w - 1);
+        if (fabs(h) < 1e-9) return false;
+
+        double t[sg::MAX_WINDOW];
+        for (size_t j = 0; j < w; j++) t[j] = (static_cast<double>(x[first + j]) - x[i]) / h;
+
+        // [JᵀJ | e_deriv] reduced to [I | z]; z is row `deriv` of (JᵀJ)⁻¹
+        // since JᵀJ is symmetric, so weight_j = deriv! · Σ z_c t_j^c / h^deriv
+        double sums[2 * sg::MAX_ORDER + 1] = {};  // Σ t^k
+        for (size_t j = 0; j < w; j++) {
+            double tp = 1.0;
+            for (size_t e = 0; e < 2 * p - 1; e++, tp *= t[j]) sums[e] += tp;
+        }
+        double a[sg::MAX_ORDER + 1][sg::MAX_ORDER + 2] = {};
+        for (size_t r = 0; r < p; r++) {
+            for (size_t c = 0; c < p; c++) a[r][c] = sums[r + c];
+            a[r][p] = (r == deriv) ? 1.0 : 0.0;
+        }
+        for (size_t col = 0; col < p; col++) {
+            size_t pivot = col;
+            for (size_t r = col + 1; r < p; r++) {
+                if (fabs(a[r][col]) > fabs(a[pivot][col])) pivot = r;
+            }
+            if (fabs(a[pivot][col]) < 1e-12) return false;  // coincident points
+            for (size_t c = 0; c <= p; c++) std::swap(a[col][c], a[pivot][c]);
+            const double inv = 1.0 / a[col][col];
+            for (size_t c = 0; c <= p; c++) a[col][c] *= inv;
+            for (size_t r = 0; r < p; r++) {
+                if (r == col) continue;
+                const double f = a[r][col];
+                for (size_t c = 0; c <= p; c++) a[r][c] -= f * a[col][c];
+            }
+        }
+
+        double scale = 1.0;
+        for (size_t d = 2; d <= deriv; d++) scale *= d;
+        for (size_t d = 0; d < deriv; d++) scale /= h;
+
+        float* row = weights.data() + i * w;
+        for (size_t j = 0; j < w; j++) {
+            double poly = 0.0, tp = 1.0;
+            for (size_t c = 0; c < p; c++, tp *= t[j]) poly += a[c][p] * tp;
+            row[j] = static_cast<float>(scale * poly);
         }
-        result[i] = sum;
     }
-    
-    return result;
+
+    kernel = k;
+    return true;
+}
+
+bool isUniformGrid(ConstFloatSpan x, float tolerance) {
+    const size_t n = x.size();
+    if (n < 3) return true;
+    const float step  = (x[n - 1] - x[0]) / (n - 1);
+    const float limit = tolerance * fabsf(step);
+    for (size_t i = 1; i < n; i++) {
+        if (fabsf((x[i] - x[i - 1]) - step) > limit) return false;
+    }
+    return true;
 }
 
 // ============================================================================
@@ -116,6 +388,75 @@ float linearRegression(
     return static_cast<float>(1.0 - ssRes / ssTot);
 }
 
+// ============================================================================
+// Windowed Regression (prefix sums)
+// ============================================================================
+
+template <class Numerics>
+bool BasicWindowedRegression<Numerics>::build(
+    ConstFloatSpan x,
+    ConstFloatSpan y,
+    Span<const uint8_t> usable,
+    ScratchArena& arena
+) {
+    const size_t n = std::min(x.size(), std::min(y.size(), usable.size()));
+    if (!begin(n, arena)) return false;
+    for (size_t i = 0; i < n; i++) push(x[i], y[i], usable[i] != 0);
+    return true;
+}
+
+template <class Numerics>
+bool BasicWindowedRegression<Numerics>::begin(size_t capacity, ScratchArena& arena) {
+    size_     = 0;
+    capacity_ = 0;
+    pending_  = 0;
+    centred_  = false;
+    x0_ = y0_ = 0.0f;
+
+    prefix_ = arena.alloc<Moments>(capacity + 1);
+    cnt_    = arena.alloc<uint32_t>(capacity + 1);
+    next_   = arena.alloc<uint32_t>(capacity + 1);
+    prev_   = arena.alloc<uint32_t>(capacity + 1);
+    if (prev_.empty() || prefix_.empty()) return false;
+
+    prefix_[0] = Moments();
+    cnt_[0] = 0;
+    capacity_ = capacity;
+    return true;
+}
+
+template <class Numerics>
+void BasicWindowedRegression<Numerics>::push(float x, float y, bool usable) {
+    if (size_ >= capacity_) return;
+    const size_t i = size_;
+
+    // Centre on the first usable point; it is known before any sum that
+    // depends on it, so the tables can be grown in a single pass.
+    if (usable && !centred_) {
+        x0_ = x;
+        y0_ = y;
+        centred_ = true;
+    }
+
+    prefix_[i + 1] = prefix_[i];
+    if (usable) prefix_[i + 1].add(x, y, x0_, y0_);
+    cnt_[i + 1] = cnt_[i] + (usable ? 1 : 0);
+
+    if (usable) {
+        prev_[i] = static_cast<uint32_t>(i);
+        // Every index since the previous usable point now has a successor
+        for (size_t j = pending_; j <= i; j++) next_[j] = static_cast<uint32_t>(i);
+        pending_ = i + 1;
+    } else {
+        prev_[i] = (i > 0) ? prev_[i - 1] : static_cast<uint32_t>(capacity_);
+    }
+    size_ = i + 1;
+}
+
+template class BasicWindowedRegression<numerics::Double>;
+template class BasicWindowedRegression<numerics::CompensatedFloat>;
+template class BasicWindowedRegression<numerics::Fixed<16>>;
+
 // ============================================================================
 // Gm Calculation
 // ============================================================================
@@ -125,23 +466,50 @@ std::vector<float> calculateGm(
     const std::vector<float>& vgs,
     const GmConfig& config
 ) {
+    std::vector<float> gm(ids.size(), 0.0f);
+    ScratchArena arena(gridKernelBytes(ids.size(), sg::MAX_WINDOW));
+    calculateGm(ConstFloatSpan(ids), ConstFloatSpan(vgs), FloatSpan(gm), arena, config);
+    return gm;
+}
+
+bool calculateGm(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    FloatSpan gm,
+    ScratchArena& arena,
+    const GmConfig& config
+) {
+    if (gm.size() < ids.size()) return false;
+    std::fill(gm.begin(), gm.begin() + ids.size(), 0.0f);
     if (ids.size() != vgs.size() || ids.size() < 3) {
-        return std::vector<float>(ids.size(), 0.0f);
+        return false;
     }
     
     size_t n = ids.size();
     
-    // Step 1: Smooth IDs data
-    std::vector<float> idsSmooth;
-    if (config.useSavitzkyGolay) {
-        idsSmooth = savitzkyGolaySmooth(ids, config.smoothingWindow, 2);
-    } else {
-        idsSmooth = movingAverageSmooth(ids, config.smoothingWindow);
+    // Savitzky-Golay: the first-derivative kernel smooths and differentiates
+    // in a single convolution pass. The compile-time tables need a uniform
+    // VGS grid; any other grid gets the same fit from a per-curve table.
+    if (config.useSavitzkyGolay && n >= sg::MIN_WINDOW) {
+        if (isUniformGrid(vgs)) {
+            float step = (vgs[n - 1] - vgs[0]) / (n - 1);
+            savitzkyGolayDerivative(ids, gm, step, config.smoothingWindow, config.polyOrder, 1);
+            return true;
+        }
+        ScratchArena::Scope scope(arena);
+        GridKernel kernel;
+        if (!buildGridKernel(vgs, arena, kernel, config.smoothingWindow, config.polyOrder, 1)) return false;
+        kernel.apply(ids, gm);
+        return true;
     }
     
-    // Step 2: Calculate Gm using central difference
-    std::vector<float> gm(n, 0.0f);
+    // Step 1: Smooth IDs data
+    ScratchArena::Scope scope(arena);
+    FloatSpan idsSmooth = arena.alloc<float>(n);
+    if (idsSmooth.empty()) return false;
+    movingAverageSmooth(ids, idsSmooth, config.smoothingWindow);
     
+    // Step 2: Calculate Gm using central difference
     for (size_t i = 1; i < n - 1; i++) {
         float dVgs = vgs[i + 1] - vgs[i - 1];
         if (fabs(dVgs) > 1e-9f) {
@@ -161,26 +529,88 @@ std::vector<float> calculateGm(
         }
     }
     
-    return gm;
+    return true;
 }
 
 // ============================================================================
 // Vt Calculation
 // ============================================================================
 
-float calculateVt(
-    const std::vector<float>& gm, 
-    const std::vector<float>& vgs,
-    const std::vector<float>& ids
-) {
-    if (gm.size() != vgs.size() || gm.size() < 5) {
+namespace {
+
+/**
+ * GridKernel for the second-derivative peak on a non-uniform VGS grid: the
+ * GmConfig() window and order, first derivative. False on a uniform grid
+ * (the compile-time table applies) or when it cannot be built.
+ */
+bool buildD2Kernel(ConstFloatSpan vgs, ScratchArena& arena, GridKernel& kernel) {
+    if (isUniformGrid(vgs)) return false;
+    const GmConfig defaults;
+    return buildGridKernel(vgs, arena, kernel, defaults.smoothingWindow, defaults.polyOrder, 1);
+}
+
+/**
+ * @brief Peak of d²Ids/dVgs as the first SG derivative of Gm
+ *
+ * Walks the GmConfig() Savitzky-Golay derivative of gm one point at a time
+ * — the values calculateGm(gm, vgs, ...) would write to a buffer — and
+ * returns the first maximum within [from, to). `offset` is the sub-sample
+ * position of the peak (-0.5..0.5 steps) from a parabola through its
+ * neighbours. `grid` (from buildD2Kernel()) replaces the uniform table,
+ * whose mean step misweights an irregular grid.
+ *
+ * @return false if gm is too short, the range is empty or the VGS step is
+ *         degenerate
+ */
+bool secondDerivativePeak(ConstFloatSpan gm, ConstFloatSpan vgs, size_t from, size_t to,
+                          const GridKernel* grid, size_t& peakIdx, float& offset) {
+    const size_t   n = gm.size();
+    const GmConfig defaults;
+    const sg::Kernel* kernel = sg::selectKernel(defaults.smoothingWindow, defaults.polyOrder, n);
+    if (!kernel || vgs.size() != n || from >= std::min(to, n)) return false;
+    if (grid && grid->size != n) grid = nullptr;
+    to = std::min(to, n);
+
+    const float step = (vgs[n - 1] - vgs[0]) / (n - 1);
+    if (fabs(step) < 1e-9f) return false;
+
+    const size_t half  = kernel->window / 2;
+    const float  scale = sg::derivativeScale(1, step);
+    auto d2At = [&](size_t i) {
+        if (grid) return grid->at(gm, i);
+        return (i < half || i + half >= n)
+            ? sg::edgePoint(*kernel, 1, gm.data(), n, i, scale)
+            : sg::convolvePoint(*kernel, 1, gm.data() + i - half) * scale;
+    };
+
+    peakIdx = from;
+    float best = d2At(from);
+    for (size_t i = from + 1; i < to; i++) {
+        const float v = d2At(i);
+        if (v > best) {
+            best = v;
+            peakIdx = i;
+        }
+    }
+
+    offset = 0.0f;
+    if (peakIdx > 0 && peakIdx + 1 < n) {
+        const float before = d2At(peakIdx - 1);
+        const float after  = d2At(peakIdx + 1);
+        const float curv   = before - 2.0f * best + after;
+        if (curv < 0) offset = std::max(-0.5f, std::min(0.5f, 0.5f * (before - after) / curv));
+    }
+    return true;
+}
+
+/** Max-Gm Vt with the second-derivative fallback searched over [d2From, d2To). */
+float maxGmVt(ConstFloatSpan gm, ConstFloatSpan vgs, ConstFloatSpan ids, size_t maxIdx,
+              size_t d2From, size_t d2To, const GridKernel* grid) {
+    if (gm.size() != vgs.size() || gm.size() < 5 || maxIdx >= gm.size()) {
         return 0.0f;
     }
     
-    // Find index of maximum Gm
-    auto maxIt = std::max_element(gm.begin(), gm.end());
-    size_t maxIdx = std::distance(gm.begin(), maxIt);
-    float maxGm = *maxIt;
+    float maxGm = gm[maxIdx];
     
     if (maxGm <= 0 || maxIdx < 2 || maxIdx >= gm.size() - 2) {
         return 0.0f;
@@ -204,16 +634,252 @@ float calculateVt(
     }
     
     // Alternative: Use second derivative peak (more robust)
-    std::vector<float> d2 = calculateGm(gm, vgs, GmConfig());
-    auto max_d2 = std::max_element(d2.begin(), d2.end());
-    size_t d2Idx = std::distance(d2.begin(), max_d2);
-    
-    if (d2Idx > 0 && d2Idx < vgs.size()) {
+    size_t d2Idx;
+    float  offset;
+    if (secondDerivativePeak(gm, vgs, d2From, d2To, grid, d2Idx, offset) && d2Idx > 0) {
         return vgs[d2Idx];
     }
     return 0.0f;
 }
 
+/**
+ * extractVt() with the second-derivative peak searched over [d2From, d2To).
+ * Without `grid` on a non-uniform grid that estimate is flagged VT_POOR_FIT.
+ */
+VtResult extractVtOver(ConstFloatSpan vgs, ConstFloatSpan ids, ConstFloatSpan gm, size_t peakIdx,
+                       size_t d2From, size_t d2To, const GridKernel* grid, const VtConfig& config) {
+    VtResult result;
+    const size_t n = gm.size();
+    if (vgs.size() != n || ids.size() != n || n < 5 || peakIdx >= n) return result;
+
+    const float vMin = std::min(vgs[0], vgs[n - 1]);
+    const float vMax = std::max(vgs[0], vgs[n - 1]);
+    auto place = [&](VtEstimate& e, float vt, uint8_t flags) {
+        e.vt    = vt;
+        e.flags = VT_FOUND | flags;
+        if (vt < vMin || vt > vMax) e.flags |= VT_EXTRAPOLATED;
+    };
+
+    // ── Max-Gm linear extrapolation ───────────────────────────────────────
+    const float maxGm = gm[peakIdx];
+    if (maxGm > 1e-12f) {
+        const bool edge = peakIdx < 2 || peakIdx >= n - 2;
+        place(result.maxGm, vgs[peakIdx] - ids[peakIdx] / maxGm, edge ? VT_AT_EDGE : 0);
+    }
+
+    // ── Second-derivative peak ────────────────────────────────────────────
+    size_t d2Idx;
+    float  offset;
+    if (secondDerivativePeak(gm, vgs, d2From, d2To, grid, d2Idx, offset)) {
+        const bool gridded = grid && grid->size == n;
+        float step = (vgs[n - 1] - vgs[0]) / (n - 1);
+        if (gridded && offset != 0.0f) {
+            // Offset is in steps of the side the peak leans towards
+            step = (offset > 0) ? vgs[d2Idx + 1] - vgs[d2Idx] : vgs[d2Idx] - vgs[d2Idx - 1];
+        }
+        uint8_t flags = (d2Idx < 2 || d2Idx >= n - 2) ? VT_AT_EDGE : 0;
+        if (!gridded && !isUniformGrid(vgs)) flags |= VT_POOR_FIT;
+        place(result.secondDerivative, vgs[d2Idx] + offset * step, flags);
+    }
+
+    // ── Constant current and Y-function, one pass ─────────────────────────
+    using Moments = numerics::Active::Moments;
+    Moments  yMoments;
+    uint32_t yCount = 0;
+    float    x0 = 0.0f, y0 = 0.0f;
+    bool     ccDone = false;
+    const float icc = config.constantCurrent;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!ccDone && ids[i] >= icc) {
+            ccDone = true;
+            if (i == 0) {
+                // Already above the criterion: Vt lies below the sweep
+                place(result.constantCurrent, vgs[0], VT_AT_EDGE);
+            } else {
+                const float lo = ids[i - 1];
+                const float t  = (lo > 0 && icc > 0)
+                    ? (log10f(icc) - log10f(lo)) / (log10f(ids[i]) - log10f(lo))
+                    : (icc - lo) / (ids[i] - lo);
+                place(result.constantCurrent, vgs[i - 1] + t * (vgs[i] - vgs[i - 1]), 0);
+            }
+        }
+
+        if (i >= peakIdx && gm[i] > 0 && ids[i] > 0) {
+            const float y = ids[i] / sqrtf(gm[i]);
+            if (yCount == 0) {
+                x0 = vgs[i];
+                y0 = y;
+            }
+            yMoments.add(vgs[i], y, x0, y0);
+            yCount++;
+        }
+    }
+
+    if (yCount >= 3) {
+        float slope, intercept;
+        const float r2 = yMoments.fit(yCount, x0, y0, slope, intercept);
+        if (slope > 0) {
+            place(result.yFunction, -intercept / slope, r2 < config.minYFitR2 ? VT_POOR_FIT : 0);
+        }
+    }
+
+    // ── Agreement between methods ─────────────────────────────────────────
+    VtEstimate* all[] = { &result.maxGm, &result.secondDerivative,
+                          &result.constantCurrent, &result.yFunction };
+    float  found[4];
+    size_t count = 0;
+    for (VtEstimate* e : all) {
+        if (e->found()) found[count++] = e->vt;
+    }
+    if (count >= 3) {
+        for (size_t i = 1; i < count; i++) {  // Insertion sort, at most 4 values
+            for (size_t j = i; j > 0 && found[j] < found[j - 1]; j--) std::swap(found[j], found[j - 1]);
+        }
+        const float median = (count % 2) ? found[count / 2]
+                                         : 0.5f * (found[count / 2 - 1] + found[count / 2]);
+        for (VtEstimate* e : all) {
+            if (e->found() && fabsf(e->vt - median) > config.agreementTolerance) {
+                e->flags |= VT_OUTLIER;
+            }
+        }
+    }
+
+    return result;
+}
+
+/** First Gm maximum: from the segmentation when it saw this gm, else searched. */
+size_t peakOf(const CurveRegions& regions, ConstFloatSpan gm) {
+    if (regions.size == gm.size() && regions.gmPeak < gm.size()) return regions.gmPeak;
+    return std::distance(gm.begin(), std::max_element(gm.begin(), gm.end()));
+}
+
+/** [subthreshold, linear) of a segmentation of this curve, else the whole curve. */
+void d2SearchRange(const CurveRegions& regions, size_t n, size_t& from, size_t& to) {
+    from = regions.valid ? regions.subthreshold : 0;
+    to   = std::min(regions.linear, n);
+    if (regions.size != n || from >= to) {
+        from = 0;
+        to   = n;
+    }
+}
+
+} // namespace
+
+float calculateVt(
+    const std::vector<float>& gm, 
+    const std::vector<float>& vgs,
+    const std::vector<float>& ids
+) {
+    ScratchArena arena;  // No scratch needed
+    return calculateVt(ConstFloatSpan(gm), ConstFloatSpan(vgs), ConstFloatSpan(ids), arena);
+}
+
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ScratchArena& arena
+) {
+    if (gm.size() != vgs.size() || gm.size() < 5) {
+        return 0.0f;
+    }
+    
+    // Find index of maximum Gm
+    auto maxIt = std::max_element(gm.begin(), gm.end());
+    return calculateVt(gm, vgs, ids, std::distance(gm.begin(), maxIt), arena);
+}
+
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    size_t maxIdx,
+    ScratchArena& arena
+) {
+    if (gm.size() != vgs.size()) return 0.0f;
+    ScratchArena::Scope scope(arena);
+    GridKernel grid;
+    const bool gridded = buildD2Kernel(vgs, arena, grid);
+    return maxGmVt(gm, vgs, ids, maxIdx, 0, gm.size(), gridded ? &grid : nullptr);
+}
+
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    const CurveRegions& regions
+) {
+    size_t from, to;
+    d2SearchRange(regions, gm.size(), from, to);
+    return maxGmVt(gm, vgs, ids, peakOf(regions, gm), from, to, nullptr);
+}
+
+float calculateVt(
+    ConstFloatSpan gm,
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    const CurveRegions& regions,
+    ScratchArena& arena
+) {
+    if (gm.size() != vgs.size()) return 0.0f;
+    size_t from, to;
+    d2SearchRange(regions, gm.size(), from, to);
+    ScratchArena::Scope scope(arena);
+    GridKernel grid;
+    const bool gridded = buildD2Kernel(vgs, arena, grid);
+    return maxGmVt(gm, vgs, ids, peakOf(regions, gm), from, to, gridded ? &grid : nullptr);
+}
+
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    const VtConfig& config
+) {
+    auto maxIt = std::max_element(gm.begin(), gm.end());
+    return extractVt(vgs, ids, gm, std::distance(gm.begin(), maxIt), config);
+}
+
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    size_t peakIdx,
+    const VtConfig& config
+) {
+    return extractVtOver(vgs, ids, gm, peakIdx, 0, gm.size(), nullptr, config);
+}
+
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    const CurveRegions& regions,
+    const VtConfig& config
+) {
+    size_t from, to;
+    d2SearchRange(regions, gm.size(), from, to);
+    return extractVtOver(vgs, ids, gm, peakOf(regions, gm), from, to, nullptr, config);
+}
+
+VtResult extractVt(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    const CurveRegions& regions,
+    ScratchArena& arena,
+    const VtConfig& config
+) {
+    if (gm.size() != vgs.size()) return VtResult();
+    size_t from, to;
+    d2SearchRange(regions, gm.size(), from, to);
+    ScratchArena::Scope scope(arena);
+    GridKernel grid;
+    const bool gridded = buildD2Kernel(vgs, arena, grid);
+    return extractVtOver(vgs, ids, gm, peakOf(regions, gm), from, to, gridded ? &grid : nullptr, config);
+}
+
 // ============================================================================
 // SS Calculation — Sliding-Window Linear Regression
 // ============================================================================
@@ -223,6 +889,12 @@ float calculateVt(
 // log10(Ids) vs VGS. Keep the window that yields the highest R².
 // SS = (1 / slope_best) × 1000 mV/dec.
 //
+// Window fits come from WindowedRegression prefix sums, so the full scan
+// over all window sizes costs O(n · (MAX_WIN - MIN_WIN)) instead of
+// O(n · MAX_WIN²) with a two-pass regression per window. SSScanner runs the
+// scan incrementally — each window is scored as soon as its last point is
+// pushed — so the same code serves calculateSS() and CurveAnalyzer.
+//
 // This replaces the brittle "longest run of consistent slopes" heuristic,
 // which failed on saturated curves where the subthreshold region is short.
 
@@ -230,116 +902,1150 @@ SSResult calculateSS(
     const std::vector<float>& ids,
     const std::vector<float>& vgs
 ) {
-    SSResult result;
+    ScratchArena arena(scratchBytes(ids.size()));
+    return calculateSS(ConstFloatSpan(ids), ConstFloatSpan(vgs), arena);
+}
 
+SSResult calculateSS(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    ScratchArena& arena
+) {
     if (ids.size() != vgs.size() || ids.size() < 10) {
-        return result;
+        return SSResult();
     }
 
-    const size_t n = ids.size();
+    ScratchArena::Scope scope(arena);
+    SSScanner scanner;
+    if (!scanner.begin(ids.size(), arena)) return SSResult();
+    for (size_t i = 0; i < ids.size(); i++) scanner.push(vgs[i], ids[i]);
+    return scanner.finish();
+}
 
-    // ── Step 1: build log10(Ids) array; mark invalid points ────────────────
-    const float IDS_FLOOR = 1e-13f;   // below this = noise, skip
+namespace {
 
-    std::vector<float> logIds(n, 0.0f);
-    std::vector<bool>  usable(n, false);
+// Window sizes to try (in number of points)
+const size_t SS_MIN_WIN = 5;
+const size_t SS_MAX_WIN = 20;
 
-    // Light smoothing to reduce ADC spikes before taking log
-    std::vector<float> idsSmooth = movingAverageSmooth(ids, 3);
+const float IDS_FLOOR = 1e-13f;   // below this = noise, skip
 
-    for (size_t i = 0; i < n; i++) {
-        float val = fabsf(idsSmooth[i]);
-        if (val > IDS_FLOOR) {
-            logIds[i] = log10f(val);
-            usable[i] = true;
-        }
-    }
-
-    // ── Step 2: sliding-window regression ──────────────────────────────────
-    // Window sizes to try (in number of points)
-    const size_t MIN_WIN = 5;
-    const size_t MAX_WIN = 20;
-
-    float bestR2     = -1.0f;
-    float bestSlope  =  0.0f;
-    float bestIntercept = 0.0f;
-    size_t bestWinStart = 0;
-    size_t bestWinEnd   = 0;
-
-    // Pre-allocate reusable buffers OUTSIDE the loop to avoid ~100K heap
-    // alloc/free cycles per measurement curve (which caused heap fragmentation
-    // and a crash in the file download handler after measurement).
-    std::vector<float> wx, wy;
-    wx.reserve(MAX_WIN);
-    wy.reserve(MAX_WIN);
-
-    for (size_t win = MIN_WIN; win <= MAX_WIN && win <= n; win++) {
-        for (size_t start = 0; start + win <= n; start++) {
-            size_t end = start + win;  // exclusive
-
-            // Reuse buffers — no heap allocation inside the hot loop
-            wx.clear();
-            wy.clear();
-
-            for (size_t i = start; i < end; i++) {
-                if (usable[i]) {
-                    wx.push_back(vgs[i]);
-                    wy.push_back(logIds[i]);
-                }
-            }
+} // namespace
 
-            if (wx.size() < MIN_WIN) continue;
+template <class Numerics>
+bool BasicSSScanner<Numerics>::begin(size_t capacity, ScratchArena& arena) {
+    count_  = 0;
+    ready_  = false;
+    bestR2_ = -1.0f;
+    bestSlope_ = bestIntercept_ = 0.0f;
+    bestStart_ = bestWin_ = 0;
 
-            // Filter 1: log(Ids) must be net-increasing (subthreshold region)
-            if (wy.back() <= wy.front()) continue;
+    vgs_    = arena.alloc<float>(capacity);
+    logIds_ = arena.alloc<float>(capacity);
+    if (logIds_.size() < capacity) return false;
+    ready_ = reg_.begin(capacity, arena);
+    return ready_;
+}
 
-            // Filter 2: require at least 0.5 decades of variation across the window.
-            // Windows with ΔlogIds < 0.5 dec are flat → ADC noise, not subthreshold.
-            const float MIN_DELTA_DECADES = 0.5f;
-            if ((wy.back() - wy.front()) < MIN_DELTA_DECADES) continue;
+template <class Numerics>
+void BasicSSScanner<Numerics>::push(float vgs, float ids) {
+    if (!ready_ || count_ >= vgs_.size()) return;
+    vgs_[count_] = vgs;
 
-            float slope, intercept;
-            float r2 = linearRegression(wx, wy, slope, intercept);
+    // Light 3-point moving average to reduce ADC spikes before taking the
+    // log; point i is smoothed once point i+1 has arrived.
+    if (count_ >= 1) {
+        const size_t i = count_ - 1;
+        float sum = 0;
+        int   cnt = 0;
+        if (i >= 1) { sum += prevIds_[0]; cnt++; }
+        sum += prevIds_[1];
+        sum += ids;
+        cnt += 2;
+        process(i, sum / cnt);
+    }
 
-            // Filter 3: slope must be ≥ 1 dec/V → SS ≤ 1000 mV/dec.
-            // Shallower slopes are fitting thermal noise in saturation, not subthreshold.
-            const float MIN_SLOPE_DEC_PER_V = 1.0f;
-            if (slope < MIN_SLOPE_DEC_PER_V) continue;
+    prevIds_[0] = prevIds_[1];
+    prevIds_[1] = ids;
+    count_++;
+}
 
-            if (r2 > bestR2) {
-                bestR2        = r2;
-                bestSlope     = slope;
-                bestIntercept = intercept;
-                bestWinStart  = start;
-                bestWinEnd    = end - 1;  // inclusive
-            }
-        }
+// ── Step 1: log10(Ids) of one smoothed point; mark invalid points ─────────
+// ── Step 2: score every window that ends at this point ────────────────────
+template <class Numerics>
+void BasicSSScanner<Numerics>::process(size_t i, float idsSmooth) {
+    float val = fabsf(idsSmooth);
+    bool usable = false;
+    logIds_[i] = 0.0f;
+    if (val > IDS_FLOOR) {
+        logIds_[i] = log10f(val);
+        usable = true;
     }
 
+    // Prefix sums over the usable points: every candidate window is then
+    // scored in O(1) instead of being copied out and regressed from scratch.
+    reg_.push(vgs_[i], logIds_[i], usable);
+
+    const size_t end = i + 1;  // exclusive
+    for (size_t win = SS_MIN_WIN; win <= SS_MAX_WIN && win <= end; win++) {
+        const size_t start = end - win;
+
+        if (reg_.count(start, end) < SS_MIN_WIN) continue;
+
+        // First / last usable samples of the window
+        const float yFirst = logIds_[reg_.firstUsable(start)];
+        const float yLast  = logIds_[reg_.lastUsable(end - 1)];
+
+        // Filter 1: log(Ids) must be net-increasing (subthreshold region)
+        if (yLast <= yFirst) continue;
+
+        // Filter 2: require at least 0.5 decades of variation across the window.
+        // Windows with ΔlogIds < 0.5 dec are flat → ADC noise, not subthreshold.
+        const float MIN_DELTA_DECADES = 0.5f;
+        if ((yLast - yFirst) < MIN_DELTA_DECADES) continue;
+
+        float slope, intercept;
+        float r2 = reg_.fit(start, end, slope, intercept);
+
+        // Filter 3: slope must be ≥ 1 dec/V → SS ≤ 1000 mV/dec.
+        // Shallower slopes are fitting thermal noise in saturation, not subthreshold.
+        const float MIN_SLOPE_DEC_PER_V = 1.0f;
+        if (slope < MIN_SLOPE_DEC_PER_V) continue;
+
+        // Windows arrive ordered by end point; on an exact R² tie prefer the
+        // shorter, then earlier window — the order a size-major scan over
+        // the whole curve would have met them in.
+        if (r2 > bestR2_ ||
+            (r2 == bestR2_ && (win < bestWin_ || (win == bestWin_ && start < bestStart_)))) {
+            bestR2_        = r2;
+            bestSlope_     = slope;
+            bestIntercept_ = intercept;
+            bestStart_     = start;
+            bestWin_       = win;
+        }
+    }
+}
+
+template <class Numerics>
+SSResult BasicSSScanner<Numerics>::finish() {
+    SSResult result;
+    if (!ready_ || count_ == 0) return result;
+
+    // The last point has no right neighbour to wait for
+    const size_t last = count_ - 1;
+    if (reg_.size() == last) {
+        float sum = 0;
+        int   cnt = 0;
+        if (last >= 1) { sum += prevIds_[0]; cnt++; }
+        sum += prevIds_[1];
+        cnt++;
+        process(last, sum / cnt);
+    }
+
+    if (count_ < 10) return result;
+
     // ── Step 3: validate and produce result ────────────────────────────────
     // Accept R² ≥ 0.85 (relaxed from 0.9 to handle noisy/short regions)
     const float MIN_R2 = 0.85f;
 
-    if (bestR2 >= MIN_R2 && bestSlope > 1e-9f) {
-        float ss_val = (1.0f / bestSlope) * 1000.0f;  // mV/dec
+    if (bestR2_ >= MIN_R2 && bestSlope_ > 1e-9f) {
+        float ss_val = (1.0f / bestSlope_) * 1000.0f;  // mV/dec
 
         // Physically plausible range: 60 mV/dec (ideal) … 1000 mV/dec
         // (values above 1000 indicate noise fitting, not real subthreshold)
         if (ss_val >= 60.0f && ss_val <= 1000.0f) {
-            result.ss_mVdec   = ss_val;
-            result.valid      = true;
-            result.regionStart = bestWinStart;
-            result.regionEnd   = bestWinEnd;
+            const size_t bestEnd = bestStart_ + bestWin_ - 1;  // inclusive
+
+            result.ss_mVdec    = ss_val;
+            result.valid       = true;
+            result.regionStart = bestStart_;
+            result.regionEnd   = bestEnd;
 
             // Tangent line endpoints in log10(Ids) space
-            result.x1 = vgs[bestWinStart];
-            result.y1 = bestSlope * result.x1 + bestIntercept;
-            result.x2 = vgs[bestWinEnd];
-            result.y2 = bestSlope * result.x2 + bestIntercept;
+            result.x1 = vgs_[bestStart_];
+            result.y1 = bestSlope_ * result.x1 + bestIntercept_;
+            result.x2 = vgs_[bestEnd];
+            result.y2 = bestSlope_ * result.x2 + bestIntercept_;
+        }
+    }
+
+    return result;
+}
+
+template class BasicSSScanner<numerics::Double>;
+template class BasicSSScanner<numerics::CompensatedFloat>;
+template class BasicSSScanner<numerics::Fixed<16>>;
+
+// ── Operating regions and robust estimators ───────────────────────────────
+// segmentCurve() locates the exponential region in O(n); the robust
+// estimators fit the raw log10(Ids) inside it, so their cost no longer
+// depends on the SS_MIN_WIN..SS_MAX_WIN scan.
+
+namespace {
+
+const float SS_LOG_FLOOR     = -13.0f;  // log10(IDS_FLOOR): unusable points
+const float SS_RUN_DIP       = 0.05f;   // Decades a rising run may dip and continue
+const float SS_FLOOR_MARGIN  = 1.0f;    // Region starts this many decades above the run's foot
+const float SS_GROW_FRACTION = 0.95f;   // Region extends while slope >= this × peak: the straight part only
+const float SS_SPAN_V        = 0.04f;   // Slope spans cover at least this VGS (4 steps of 10 mV)
+const float SS_SPIKE_RATIO   = 1.585f;  // Points 0.2 decades off their local median are spikes
+const size_t SS_MEDIAN_HALF  = 4;       // Median-of-9: finds up to four spikes in nine points
+
+/** log10|ids|, or SS_LOG_FLOOR at and below IDS_FLOOR. */
+inline float logCurrent(float ids) {
+    const float v = fabsf(ids);
+    return v > IDS_FLOOR ? log10f(v) : SS_LOG_FLOOR;
+}
+
+/**
+ * Median of |y[i − half .. i + half]| (half <= SS_MEDIAN_HALF) by insertion sort.
+ * logCurrent() is monotonic, so logCurrent() of this is the median of the
+ * logs at one log10f() per point.
+ */
+inline float medianAround(ConstFloatSpan y, size_t i, size_t half) {
+    float v[2 * SS_MEDIAN_HALF + 1];
+    size_t m = 0;
+    for (size_t k = i - half; k <= i + half; k++) {
+        const float a = fabsf(y[k]);
+        size_t j = m++;
+        for (; j > 0 && v[j - 1] > a; j--) v[j] = v[j - 1];
+        v[j] = a;
+    }
+    return v[m / 2];
+}
+
+/**
+ * Exponential region of the despiked log10(Ids) `med` into
+ * regions.subthreshold / saturation / steepStart / steepEnd; steps 1-3 of
+ * segmentCurve().
+ */
+bool locateSubthreshold(ConstFloatSpan vgs, ConstFloatSpan med, CurveRegions& regions) {
+    const size_t n = med.size();
+    if (n < SS_MIN_WIN) return false;
+
+    // Slopes are taken over pieces of g >= 1 steps covering ~SS_SPAN_V: a
+    // few millivolts of exponential rise are lost in the noise near the
+    // floor. Spans are at least w = max(SS_MIN_WIN - 1, g) steps.
+    const float  meanStep = (vgs[n - 1] - vgs[0]) / (n - 1);
+    const size_t g = std::max(size_t(1),
+                              meanStep > 0 ? static_cast<size_t>(SS_SPAN_V / meanStep + 0.5f) : size_t(0));
+    const size_t w = std::max(SS_MIN_WIN - 1, g);
+
+    // ── 1. Rising run with the largest gain ───────────────────────────────
+    size_t runStart = 0, runEnd = 0, start = 0;
+    float  runGain = 0.0f;
+    for (size_t i = 1; i < n; i++) {
+        if (med[i] < med[i - 1] - SS_RUN_DIP) start = i;
+        if (med[i] - med[start] > runGain) {
+            runGain  = med[i] - med[start];
+            runStart = start;
+            runEnd   = i;
         }
     }
+    if (runGain < SS_FLOOR_MARGIN + 0.5f || runEnd - runStart < w) return false;
+
+    // ── 2. Steepest span clear of the floor ───────────────────────────────
+    const float minLevel = med[runStart] + SS_FLOOR_MARGIN;
+    auto slopeOver = [&](size_t k, size_t steps) {
+        const float dx = vgs[k + steps] - vgs[k];
+        return dx > 0 ? (med[k + steps] - med[k]) / dx : 0.0f;
+    };
+
+    size_t lowest = runStart;
+    while (lowest < runEnd && med[lowest] < minLevel) lowest++;
+    if (runEnd - lowest < w) return false;
+    const size_t a = std::min(std::max(w, 2 * g), runEnd - lowest);
+
+    // A span scores its flattest piece: noise raises some pieces and lowers
+    // others, so only a span that is steep throughout wins. Its end-to-end
+    // slope let a single noisy piece near the floor beat the true region.
+    float  peak = 0.0f;
+    size_t anchor = n;
+    for (size_t k = lowest; k + a <= runEnd; k++) {
+        float slope = slopeOver(k, g);
+        for (size_t j = k + 1; j + g <= k + a; j++) slope = std::min(slope, slopeOver(j, g));
+        if (slope > peak) {
+            peak = slope;
+            anchor = k;
+        }
+    }
+    if (anchor == n || peak < 1.0f) return false;
+
+    // ── 3. Grow each side until the slope falls below the fraction ────────
+    const float minSlope = SS_GROW_FRACTION * peak;
+    size_t first = anchor;
+    size_t last  = anchor + a;
+    while (first > lowest && slopeOver(first - 1, g) >= minSlope) first--;
+    while (last < runEnd && slopeOver(last + 1 - g, g) >= minSlope) last++;
+
+    regions.subthreshold = first;
+    regions.saturation   = last + 1;
+    regions.steepStart   = anchor;
+    regions.steepEnd     = anchor + a;
+    return true;
+}
+
+/** Median of v (reordered in place); mean of the two middle values for even sizes. */
+float medianInPlace(float* v, size_t n) {
+    const size_t mid = n / 2;
+    std::nth_element(v, v + mid, v + n);
+    const float upper = v[mid];
+    if (n % 2) return upper;
+    return 0.5f * (upper + *std::max_element(v, v + mid));
+}
+
+/** xorshift32: repeatable RANSAC samples without <random>'s state size. */
+inline uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+CurveRegions segmentCurve(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ConstFloatSpan gm,
+    ScratchArena& arena
+) {
+    CurveRegions regions;
+    const size_t n = ids.size();
+    if (vgs.size() != n) return regions;
+    regions.size   = n;
+    regions.gmPeak = n;
+    regions.linear = n;
+
+    // Gm peak (first maximum, as std::max_element would pick) ends saturation
+    if (gm.size() == n && n > 0) {
+        size_t peak = 0;
+        for (size_t i = 1; i < n; i++) {
+            if (gm[i] > gm[peak]) peak = i;
+        }
+        regions.gmPeak = peak;
+        regions.linear = peak + 1;
+    }
+
+    ScratchArena::Scope scope(arena);
+    FloatSpan med = arena.alloc<float>(n);
+    if (med.size() < n) return regions;
+    // Despike: a point SS_SPIKE_RATIO off the median of its nine neighbours
+    // (a full window at the ends too) is replaced by interpolating its clean
+    // neighbours. Taking the median itself shifts the curve by a step
+    // wherever a spike sits in the window, and on the steep part that step
+    // reads as a slope the curve does not have.
+    const size_t half = std::min(SS_MEDIAN_HALF, (n - 1) / 2);
+    for (size_t i = 0; i < n; i++) {
+        const float m = medianAround(ids, std::min(std::max(i, half), n - 1 - half), half);
+        const float v = fabsf(ids[i]);
+        med[i] = (v > m * SS_SPIKE_RATIO || v * SS_SPIKE_RATIO < m) ? NAN : logCurrent(v);
+    }
+    size_t clean = n;  // Last clean point before i
+    for (size_t i = 0; i <= n; i++) {
+        if (i < n && std::isnan(med[i])) continue;
+        for (size_t k = (clean == n) ? 0 : clean + 1; k < i; k++) {
+            if (clean == n)  med[k] = (i < n) ? med[i] : SS_LOG_FLOOR;
+            else if (i == n) med[k] = med[clean];
+            else med[k] = med[clean] + (med[i] - med[clean]) * (vgs[k] - vgs[clean]) / (vgs[i] - vgs[clean]);
+        }
+        clean = i;
+    }
+
+    regions.valid = locateSubthreshold(vgs, med, regions);
+    if (regions.valid) {
+        // A noisy Gm peak inside the exponential region does not end it
+        regions.linear = std::max(regions.linear, regions.saturation);
+    }
+    return regions;
+}
+
+namespace {
+
+bool theilSen(ConstFloatSpan x, ConstFloatSpan y, size_t first, size_t last,
+              FloatSpan scratch, float& slope, float& intercept) {
+    size_t count = 0;
+    for (size_t i = first; i <= last; i++) {
+        if (y[i] <= SS_LOG_FLOOR) continue;
+        for (size_t j = i + 1; j <= last && count < scratch.size(); j++) {
+            if (y[j] <= SS_LOG_FLOOR || x[j] == x[i]) continue;
+            scratch[count++] = (y[j] - y[i]) / (x[j] - x[i]);
+        }
+    }
+    if (count < 2) return false;
+    slope = medianInPlace(scratch.data(), count);
+
+    count = 0;
+    for (size_t i = first; i <= last; i++) {
+        if (y[i] > SS_LOG_FLOOR) scratch[count++] = y[i] - slope * x[i];
+    }
+    intercept = medianInPlace(scratch.data(), count);
+    return true;
+}
+
+bool ransac(ConstFloatSpan x, ConstFloatSpan y, size_t first, size_t last,
+            const SSConfig& config, float& slope, float& intercept) {
+    const size_t span = last - first + 1;
+    uint32_t state = config.ransacSeed ? config.ransacSeed : 1;
+    size_t bestInliers = 0;
+    float  bestError = 0.0f, bestSlope = 0.0f, bestIntercept = 0.0f;
+
+    for (uint16_t it = 0; it < config.ransacIterations; it++) {
+        const size_t i = first + nextRandom(state) % span;
+        const size_t j = first + nextRandom(state) % span;
+        if (i == j || y[i] <= SS_LOG_FLOOR || y[j] <= SS_LOG_FLOOR || x[i] == x[j]) continue;
+
+        const float s = (y[j] - y[i]) / (x[j] - x[i]);
+        if (s < 1.0f) continue;  // Same 1 dec/V floor as the window scan
+        const float c = y[i] - s * x[i];
+
+        size_t inliers = 0;
+        float  error = 0.0f;
+        for (size_t k = first; k <= last; k++) {
+            if (y[k] <= SS_LOG_FLOOR) continue;
+            const float r = fabsf(y[k] - (s * x[k] + c));
+            if (r <= config.ransacTolerance) {
+                inliers++;
+                error += r;
+            }
+        }
+        if (inliers > bestInliers || (inliers == bestInliers && error < bestError)) {
+            bestInliers = inliers;
+            bestError = error;
+            bestSlope = s;
+            bestIntercept = c;
+        }
+    }
+    if (bestInliers < SS_MIN_WIN) return false;
+
+    // Least-squares refit over the consensus set
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    size_t m = 0;
+    const double x0 = x[first];
+    for (size_t k = first; k <= last; k++) {
+        if (y[k] <= SS_LOG_FLOOR) continue;
+        if (fabsf(y[k] - (bestSlope * x[k] + bestIntercept)) > config.ransacTolerance) continue;
+        const double dx = x[k] - x0;
+        sx += dx; sy += y[k]; sxx += dx * dx; sxy += dx * y[k];
+        m++;
+    }
+    const double den = m * sxx - sx * sx;
+    if (den <= 0) return false;
+    slope = static_cast<float>((m * sxy - sx * sy) / den);
+    intercept = static_cast<float>((sy - slope * sx) / m - slope * x0);
+    return true;
+}
+
+} // namespace
+
+SSResult calculateSS(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    ScratchArena& arena,
+    const SSConfig& config
+) {
+    if (config.method == SSMethod::SlidingWindow) return calculateSS(ids, vgs, arena);
+    if (vgs.size() != ids.size() || ids.size() < 10) return SSResult();
+
+    return calculateSS(ids, vgs, segmentCurve(vgs, ids, ConstFloatSpan(), arena), arena, config);
+}
+
+SSResult calculateSS(
+    ConstFloatSpan ids,
+    ConstFloatSpan vgs,
+    const CurveRegions& regions,
+    ScratchArena& arena,
+    const SSConfig& config
+) {
+    SSResult result;
+    const size_t n = ids.size();
+    if (vgs.size() != n || n < 10) return result;
+    const bool segmented = regions.valid && regions.size == n;
+
+    if (config.method == SSMethod::SlidingWindow) {
+        // A region shorter than the longest window cannot be trusted to hold
+        // the best one; the whole-curve scan of such a curve is short anyway
+        if (!segmented || regions.saturation - regions.subthreshold < SS_MAX_WIN) {
+            return calculateSS(ids, vgs, arena);
+        }
+
+        const size_t pad  = SS_MIN_WIN - 1;
+        const size_t from = regions.subthreshold > pad ? regions.subthreshold - pad : 0;
+        const size_t to   = std::min(n, regions.saturation + pad);
+        result = calculateSS(ids.subspan(from, to - from), vgs.subspan(from, to - from), arena);
+        if (result.valid) {
+            result.regionStart += from;
+            result.regionEnd   += from;
+        }
+        return result;
+    }
+    if (!segmented) return result;
+
+    // At most SS_ROBUST_MAX_POINTS of the region, grown alternately
+    // outwards from its steepest span
+    size_t first = regions.steepStart;
+    size_t last  = regions.steepEnd;
+    while (last - first + 1 < SS_ROBUST_MAX_POINTS) {
+        bool grew = false;
+        if (first > regions.subthreshold) {
+            first--;
+            grew = true;
+        }
+        if (last - first + 1 < SS_ROBUST_MAX_POINTS && last + 1 < regions.saturation) {
+            last++;
+            grew = true;
+        }
+        if (!grew) break;
+    }
+
+    const size_t m = last - first + 1;
+    ScratchArena::Scope scope(arena);
+    FloatSpan logIds = arena.alloc<float>(m);
+    FloatSpan pairs  = arena.alloc<float>(m * (m - 1) / 2);
+    if (pairs.size() < m * (m - 1) / 2) return result;
+    for (size_t k = 0; k < m; k++) logIds[k] = logCurrent(ids[first + k]);
+
+    ConstFloatSpan x = vgs.subspan(first, m);
+    float slope = 0.0f, intercept = 0.0f;
+    const bool fitted = (config.method == SSMethod::TheilSen)
+        ? theilSen(x, logIds, 0, m - 1, pairs, slope, intercept)
+        : ransac(x, logIds, 0, m - 1, config, slope, intercept);
+    if (!fitted || slope <= 1e-9f) return result;
+
+    const float ss_val = 1000.0f / slope;
+    if (ss_val < 60.0f || ss_val > 1000.0f) return result;
+
+    result.ss_mVdec    = ss_val;
+    result.valid       = true;
+    result.regionStart = first;
+    result.regionEnd   = last;
+    result.x1 = vgs[first];
+    result.y1 = slope * result.x1 + intercept;
+    result.x2 = vgs[last];
+    result.y2 = slope * result.x2 + intercept;
+    return result;
+}
+
+// ============================================================================
+// Streaming Curve Analysis
+// ============================================================================
+
+bool CurveAnalyzer::begin(size_t capacity, ScratchArena& arena, const GmConfig& config,
+                          const VtConfig& vtConfig, const SSConfig& ssConfig) {
+    config_   = config;
+    vtConfig_ = vtConfig;
+    ssConfig_ = ssConfig;
+    arena_  = &arena;
+    count_  = 0;
+    ready_  = false;
+
+    // Gm streams only for a Savitzky-Golay kernel that fits the full
+    // curve; anything else is computed in one go by finish().
+    kernel_ = config.useSavitzkyGolay
+        ? sg::selectKernel(config.smoothingWindow, config.polyOrder, capacity)
+        : nullptr;
+
+    ids_ = arena.alloc<float>(capacity);
+    gm_  = arena.alloc<float>(capacity);
+    if (gm_.size() < capacity) return false;
+
+    // The robust SS methods run once at finish(); only VGS has to be kept
+    if (ssConfig.method != SSMethod::SlidingWindow) {
+        vgs_   = arena.alloc<float>(capacity);
+        ready_ = vgs_.size() == capacity;
+        return ready_;
+    }
+    vgs_   = FloatSpan();
+    ready_ = ss_.begin(capacity, arena);
+    return ready_;
+}
+
+void CurveAnalyzer::push(float vgs, float ids) {
+    if (!ready_ || count_ >= ids_.size()) return;
+
+    ids_[count_] = ids;
+    gm_[count_]  = 0.0f;
+    if (vgs_.empty()) ss_.push(vgs, ids);
+    else              vgs_[count_] = vgs;
+    count_++;
+
+    // The window centred half a kernel back is now complete; its Gm is
+    // stored unscaled until the final VGS step is known.
+    if (kernel_ && count_ >= kernel_->window) {
+        const size_t first = count_ - kernel_->window;
+        gm_[first + kernel_->window / 2] = sg::convolvePoint(*kernel_, 1, &ids_[first]);
+    }
+}
+
+CurveAnalyzer::Result CurveAnalyzer::finish() {
+    Result result;
+    if (!ready_) return result;
+
+    const size_t n = count_;
+    const bool robustSS = !vgs_.empty();
+    if (!robustSS) result.ss = ss_.finish();
+    if (n == 0) return result;
+
+    ConstFloatSpan vgs = robustSS ? ConstFloatSpan(vgs_.data(), n) : ss_.vgs();
+    ConstFloatSpan ids(ids_.data(), n);
+    FloatSpan      gm(gm_.data(), n);
+
+    // The streamed sums used the uniform-grid weights; an irregular grid
+    // is differentiated again with its own weight table
+    const bool streamed = kernel_ &&
+        sg::selectKernel(config_.smoothingWindow, config_.polyOrder, n) == kernel_ &&
+        isUniformGrid(vgs);
+
+    if (streamed) {
+        // Same step and scale calculateGm() would derive from the curve
+        const float step = (vgs[n - 1] - vgs[0]) / (n - 1);
+        if (fabs(step) < 1e-9f) {
+            std::fill(gm.begin(), gm.end(), 0.0f);
+        } else {
+            const size_t half  = kernel_->window / 2;
+            const float  scale = sg::derivativeScale(1, step);
+            sg::applyEdges(*kernel_, 1, ids_.data(), gm.data(), n, scale);
+            kernels::scale(gm.data() + half, gm.data() + half, n - 2 * half, scale);
+        }
+    } else {
+        calculateGm(ids, vgs, gm, *arena_, config_);
+    }
+
+    // One segmentation serves the Gm peak, Vt and the robust SS fit
+    result.regions = segmentCurve(vgs, ids, gm, *arena_);
+    if (robustSS) result.ss = calculateSS(ids, vgs, result.regions, *arena_, ssConfig_);
+    result.maxGm = gm[result.regions.gmPeak];
 
+    // An irregular grid needs its own d²Ids/dVgs weights too; one table
+    // serves both Vt paths
+    size_t from, to;
+    d2SearchRange(result.regions, n, from, to);
+    ScratchArena::Scope scope(*arena_);
+    GridKernel grid;
+    const GridKernel* d2 = buildD2Kernel(vgs, *arena_, grid) ? &grid : nullptr;
+    const size_t peak = peakOf(result.regions, gm);
+    result.vt        = maxGmVt(gm, vgs, ids, peak, from, to, d2);
+    result.vtMethods = extractVtOver(vgs, ids, gm, peak, from, to, d2, vtConfig_);
     return result;
 }
 
+// ============================================================================
+// Bootstrap Confidence Intervals
+// ============================================================================
+
+namespace {
+
+/** 2.5th / 97.5th percentiles of v[0..n) (sorted in place), linear between ranks. */
+ConfidenceInterval percentileInterval(float* v, size_t n, size_t minCount) {
+    ConfidenceInterval ci;
+    ci.n = static_cast<uint16_t>(n);
+    if (n == 0) return ci;
+
+    std::sort(v, v + n);
+    auto at = [&](float q) {
+        const float  pos = q * (n - 1);
+        const size_t k   = static_cast<size_t>(pos);
+        return k + 1 < n ? v[k] + (pos - k) * (v[k + 1] - v[k]) : v[k];
+    };
+    ci.lo    = at(0.025f);
+    ci.hi    = at(0.975f);
+    ci.valid = n >= 2 && n >= minCount;
+    return ci;
+}
+
+/**
+ * Diagonal of the smoother's hat matrix at point idx: the weight a point
+ * gives itself, read from the polynomial of its window (the nearest full
+ * window at the edges, as sg::apply() does). A residual's variance is
+ * (1 − h)·σ², e.g. 18/35·σ² inside the curve for window 5, order 2.
+ */
+float smootherLeverage(const sg::Kernel& kernel, size_t n, size_t idx) {
+    const size_t w     = kernel.window;
+    const size_t half  = w / 2;
+    const size_t first = idx < half ? 0 : (idx + half >= n ? n - w : idx - half);
+    const size_t pos   = idx - first;
+    const float  t     = static_cast<float>(pos) - static_cast<float>(half);
+
+    float h = 0, tj = 1;
+    for (size_t j = 0; j <= kernel.order; j++, tj *= t) h += tj * kernel.proj[j * w + pos];
+    return h;
+}
+
+} // namespace
+
+size_t bootstrapScratchBytes(size_t points, size_t iterations) {
+    // Smoothed curve, residuals and one resample, three estimate arrays,
+    // then a CurveAnalyzer per resample
+    return scratchBytes(points) + 3 * points * sizeof(float)
+         + 3 * iterations * sizeof(float) + 64;
+}
+
+BootstrapResult bootstrapCurve(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    ScratchArena& arena,
+    const BootstrapConfig& config
+) {
+    BootstrapResult result;
+    const size_t n = ids.size();
+    const size_t iterations = config.iterations;
+    if (vgs.size() != n || n < 10 || iterations == 0) return result;
+
+    ScratchArena::Scope scope(arena);
+    FloatSpan smooth = arena.alloc<float>(n);
+    FloatSpan resid  = arena.alloc<float>(n);
+    FloatSpan sample = arena.alloc<float>(n);
+    FloatSpan vts    = arena.alloc<float>(iterations);
+    FloatSpan sss    = arena.alloc<float>(iterations);
+    FloatSpan gms    = arena.alloc<float>(iterations);
+    if (gms.size() < iterations) return result;
+
+    // Raw residuals are shrunk by the smoother (each point is part of its
+    // own fit); rescaled by 1/√(1 − h) they carry the full noise variance
+    const sg::Kernel* kernel = sg::selectKernel(5, 2, n);
+    if (!kernel) return result;
+    sg::apply(*kernel, 0, ids.data(), smooth.data(), n);
+    for (size_t i = 0; i < n; i++) {
+        resid[i] = (ids[i] - smooth[i]) / sqrtf(1.0f - smootherLeverage(*kernel, n, i));
+    }
+
+    uint32_t state = config.seed ? config.seed : 1;
+    const uint32_t start = config.clockUs ? config.clockUs() : 0;
+    size_t nVt = 0, nSs = 0, nGm = 0;
+
+    for (size_t it = 0; it < iterations; it++) {
+        if ((config.stopRequested && config.stopRequested(config.context)) ||
+            (config.budgetUs && config.clockUs && config.clockUs() - start >= config.budgetUs)) {
+            result.interrupted = true;
+            break;
+        }
+
+        // Rademacher signs, 32 points per random draw
+        uint32_t signs = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (i % 32 == 0) signs = nextRandom(state);
+            sample[i] = (signs & 1) ? smooth[i] + resid[i] : smooth[i] - resid[i];
+            signs >>= 1;
+        }
+
+        ScratchArena::Scope pass(arena);
+        CurveAnalyzer analyzer;
+        if (!analyzer.begin(n, arena, config.gm, config.vt, config.ss)) break;
+        for (size_t i = 0; i < n; i++) analyzer.push(vgs[i], sample[i]);
+        const CurveAnalyzer::Result r = analyzer.finish();
+
+        result.iterations++;
+        if (r.vt > 0)      vts[nVt++] = r.vt;
+        if (r.ss.valid)    sss[nSs++] = r.ss.ss_mVdec;
+        if (r.maxGm > 0)   gms[nGm++] = r.maxGm;
+    }
+
+    result.vt    = percentileInterval(vts.data(), nVt, config.minIterations);
+    result.ss    = percentileInterval(sss.data(), nSs, config.minIterations);
+    result.maxGm = percentileInterval(gms.data(), nGm, config.minIterations);
+    return result;
+}
+
+// ============================================================================
+// Compact Model Fit
+// ============================================================================
+
+namespace {
+
+const float UT = 0.02585f;  // Thermal voltage at 300 K (V)
+
+/** ln(1 + eˣ) and its derivative, without overflow. */
+inline void softplus(float x, float& l, float& sigma) {
+    if (x > 15.0f) {
+        const float e = expf(-x);
+        l = x + e;
+        sigma = 1.0f - e;
+    } else {
+        const float e = expf(x);
+        l = log1pf(e);
+        sigma = e / (1.0f + e);
+    }
+}
+
+/**
+ * EKV transfer-curve model for lm::solve, parameters
+ * { Vt, n, ln Is, θ, Rs }. Residual r = ln Ids_model − ln Ids.
+ */
+class EkvModel {
+public:
+    enum { VT, N, LN_IS, THETA, RS, PARAMS };
+
+    EkvModel(ConstFloatSpan vgs, ConstFloatSpan ids, float vds, size_t stride, float minCurrent)
+        : vgs_(vgs), ids_(ids), vds_(vds), stride_(stride), minCurrent_(minCurrent) {}
+
+    size_t size() const { return (ids_.size() + stride_ - 1) / stride_; }
+
+    void constrain(float* p) const {
+        p[N]     = std::max(1.0f, std::min(5.0f, p[N]));
+        p[LN_IS] = std::max(-40.0f, std::min(5.0f, p[LN_IS]));
+        p[THETA] = std::max(0.0f, std::min(10.0f, p[THETA]));
+        p[RS]    = std::max(0.0f, std::min(1e4f, p[RS]));
+    }
+
+    bool residual(size_t i, const float* p, float& r, float* jac) const {
+        const size_t k = i * stride_;
+        const float measured = ids_[k];
+        if (!(measured > minCurrent_)) return false;
+
+        const float vt = p[VT], n = p[N], theta = p[THETA], rs = p[RS];
+        const float s   = 2.0f * n * UT;
+        const float vov = vgs_[k] - vt;
+
+        float lr, sr;
+        const float xr = (vov - n * vds_) / s;
+        softplus(xr, lr, sr);
+
+        // Solve ln I = ln f(I) for the source degeneration by Newton on
+        // y = ln I; h'(y) >= 1 keeps it monotone. No-op when Rs = 0.
+        float lnI = 0.0f, xf = 0.0f, lf = 0.0f, sf = 0.0f, q = 0.0f, d = 1.0f, a = 0.0f;
+        float current = 0.0f;
+        for (int iter = 0; iter < 8; iter++) {
+            xf = (vov - n * current * rs) / s;
+            softplus(xf, lf, sf);
+            q = lf * lf - lr * lr;
+            if (!(q > 0)) return false;
+            d = 1.0f + theta * s * lf;
+            const float lnF = p[LN_IS] + logf(q) - logf(d);
+            a = 2.0f * lf * sf / q - theta * s * sf / d;   // ∂ln f/∂xf
+
+            if (rs == 0.0f) {
+                lnI = lnF;
+                break;
+            }
+            const float y  = (iter == 0) ? lnF : lnI;
+            const float yI = expf(y);
+            const float h  = y - lnF;
+            const float dh = 1.0f + a * yI * rs / (2.0f * UT);
+            lnI = y - h / dh;
+            current = expf(lnI);
+            if (fabsf(h) < 1e-5f && iter > 0) break;
+        }
+        if (!std::isfinite(lnI)) return false;
+
+        r = lnI - logf(measured);
+        if (!jac) return true;
+
+        // Implicit derivatives: d ln I/dp = (∂ln f/∂p) / k
+        const float current2 = expf(lnI);
+        const float k2 = 1.0f + a * current2 * rs / (2.0f * UT);
+        const float br = -2.0f * lr * sr / q;                  // ∂ln f/∂xr
+        const float dXfDn = -(xf + current2 * rs / (2.0f * UT)) / n;
+        const float dXrDn = -(xr + vds_ / (2.0f * UT)) / n;
+
+        jac[VT]    = (-(a + br) / s) / k2;
+        jac[N]     = (a * dXfDn + br * dXrDn - theta * 2.0f * UT * lf / d) / k2;
+        jac[LN_IS] = 1.0f / k2;
+        jac[THETA] = (-s * lf / d) / k2;
+        jac[RS]    = (-a * current2 / (2.0f * UT)) / k2;
+        return true;
+    }
+
+private:
+    ConstFloatSpan vgs_;
+    ConstFloatSpan ids_;
+    float  vds_;
+    size_t stride_;
+    float  minCurrent_;
+};
+
+} // namespace
+
+ModelFit fitCompactModel(
+    ConstFloatSpan vgs,
+    ConstFloatSpan ids,
+    float vds,
+    float vtGuess,
+    float ssGuess,
+    const ModelFitConfig& config
+) {
+    ModelFit fit;
+    const size_t n = ids.size();
+    if (vgs.size() != n || n < EkvModel::PARAMS || config.maxPoints == 0) return fit;
+
+    const size_t stride = (n + config.maxPoints - 1) / config.maxPoints;
+    EkvModel model(vgs, ids, vds, stride, config.minCurrent);
+
+    // ── Starting point ────────────────────────────────────────────────────
+    float p0[EkvModel::PARAMS];
+    p0[EkvModel::VT]    = (vtGuess != 0.0f) ? vtGuess : 0.5f * (vgs[0] + vgs[n - 1]);
+    p0[EkvModel::N]     = ((ssGuess > 0.0f) ? ssGuess : 90.0f) / (1000.0f * UT * logf(10.0f));
+    p0[EkvModel::THETA] = 0.0f;
+    p0[EkvModel::RS]    = 0.0f;
+
+    // Is from the largest current, where the model is nearly square law
+    size_t top = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (ids[i] > ids[top]) top = i;
+    }
+    {
+        const float s = 2.0f * p0[EkvModel::N] * UT;
+        float lf, lr, sg;
+        softplus((vgs[top] - p0[EkvModel::VT]) / s, lf, sg);
+        softplus((vgs[top] - p0[EkvModel::VT] - p0[EkvModel::N] * vds) / s, lr, sg);
+        const float q = lf * lf - lr * lr;
+        p0[EkvModel::LN_IS] = (ids[top] > 0 && q > 0) ? logf(ids[top] / q) : logf(1e-6f);
+    }
+
+    // ── Levenberg–Marquardt ───────────────────────────────────────────────
+    lm::Config lmConfig;
+    lmConfig.maxIterations = config.maxIterations;
+    lmConfig.budgetUs      = config.budgetUs;
+    lmConfig.clockUs       = config.clockUs;
+    const lm::Result<EkvModel::PARAMS> r = lm::solve(model, p0, lmConfig);
+    if (r.status == lm::Status::Failed || r.points == 0 || !std::isfinite(r.cost)) return fit;
+
+    fit.valid      = true;
+    fit.converged  = r.status == lm::Status::Converged;
+    fit.budgetHit  = r.status == lm::Status::BudgetExhausted;
+    fit.vt         = r.params[EkvModel::VT];
+    fit.n          = r.params[EkvModel::N];
+    fit.is         = expf(r.params[EkvModel::LN_IS]);
+    fit.theta      = r.params[EkvModel::THETA];
+    fit.rs         = r.params[EkvModel::RS];
+    fit.rmsDecades = sqrtf(r.cost / r.points) / logf(10.0f);
+    fit.iterations = r.iterations;
+    return fit;
+}
+
+// ============================================================================
+// Output Curve Analysis
+// ============================================================================
+
+bool OutputCurveAnalyzer::begin(size_t capacity, ScratchArena& arena, const OutputConfig& config) {
+    config_ = config;
+    count_  = 0;
+    ready_  = false;
+    kernel_ = sg::selectKernel(config.smoothingWindow, 2, capacity);
+    arena_  = &arena;
+
+    vds_ = arena.alloc<float>(capacity);
+    ids_ = arena.alloc<float>(capacity);
+    gds_ = arena.alloc<float>(capacity);
+    if (gds_.size() < capacity) return false;
+    ready_ = reg_.begin(capacity, arena);
+    return ready_;
+}
+
+void OutputCurveAnalyzer::push(float vds, float ids) {
+    if (!ready_ || count_ >= ids_.size()) return;
+
+    vds_[count_] = vds;
+    ids_[count_] = ids;
+    gds_[count_] = 0.0f;
+    reg_.push(vds, ids, true);
+    count_++;
+
+    // Unscaled SG derivative of the window that just completed
+    if (kernel_ && count_ >= kernel_->window) {
+        const size_t first = count_ - kernel_->window;
+        gds_[first + kernel_->window / 2] = sg::convolvePoint(*kernel_, 1, &ids_[first]);
+    }
+}
+
+OutputCurveAnalyzer::Result OutputCurveAnalyzer::finish() {
+    Result result;
+    const size_t n = count_;
+    if (!ready_ || n < sg::MIN_WINDOW) return result;
+
+    const float step = (vds_[n - 1] - vds_[0]) / (n - 1);
+    if (fabs(step) < 1e-9f) return result;
+
+    // ── gds per point ─────────────────────────────────────────────────────
+    FloatSpan      gds(gds_.data(), n);
+    ConstFloatSpan vds(vds_.data(), n);
+    ConstFloatSpan ids(ids_.data(), n);
+    if (!isUniformGrid(vds)) {
+        // The streamed values used the mean step; an irregular grid gets
+        // its own weight table, as in CurveAnalyzer
+        ScratchArena::Scope scope(*arena_);
+        GridKernel grid;
+        if (!buildGridKernel(vds, *arena_, grid, config_.smoothingWindow, 2, 1)) return result;
+        grid.apply(ids, gds);
+    } else if (kernel_ && sg::selectKernel(config_.smoothingWindow, 2, n) == kernel_) {
+        const size_t half  = kernel_->window / 2;
+        const float  scale = sg::derivativeScale(1, step);
+        sg::applyEdges(*kernel_, 1, ids_.data(), gds.data(), n, scale);
+        kernels::scale(gds.data() + half, gds.data() + half, n - 2 * half, scale);
+    } else {
+        // Curve cut shorter than the streaming kernel
+        savitzkyGolayDerivative(ids, gds, step, config_.smoothingWindow, 2, 1);
+    }
+
+    // ── Ron from the slope at the first point ─────────────────────────────
+    // The SG edge value differentiates the quadratic fitted to the first
+    // window, so the curvature of the linear region does not bias it.
+    const float gLin = gds[0];
+    if (!(gLin > 0)) return result;
+    result.valid = true;
+    result.ron   = 1.0f / gLin;
+
+    // ── Saturation onset: first point where gds has collapsed ─────────────
+    const float threshold = config_.satFraction * gLin;
+    size_t onset = 1;
+    while (onset < n && gds[onset] >= threshold) onset++;
+    if (onset + 3 > n) return result;
+
+    // gds falls through the threshold between onset-1 and onset
+    const float g0 = gds[onset - 1];
+    const float g1 = gds[onset];
+    const float t  = (g0 > g1) ? (g0 - threshold) / (g0 - g1) : 0.0f;
+    result.vdsat    = vds_[onset - 1] + t * (vds_[onset] - vds_[onset - 1]);
+    result.satStart = onset;
+
+    // ── Saturation line: Ids = Id0 + gds·VDS ──────────────────────────────
+    float gSat, id0;
+    reg_.fit(onset, n, gSat, id0);
+    result.saturated = true;
+    result.gds       = gSat;
+    result.lambda    = (id0 > 0) ? gSat / id0 : 0.0f;
+    return result;
+}
+
+// ============================================================================
+// Family Analysis
+// ============================================================================
+
+void FamilyAnalyzer::begin() {
+    vtMoments_ = Moments();
+    ssMoments_ = Moments();
+    result_    = Result();
+}
+
+void FamilyAnalyzer::add(float vds, float vt, bool vtFound, float ss, bool ssFound) {
+    Result& r = result_;
+    r.curves++;
+
+    if (vtFound) {
+        if (r.vtCurves == 0) {
+            vtX0_ = vds;
+            vtY0_ = vt;
+            r.vdsLow = r.vdsHigh = vds;
+            r.vtLow  = r.vtHigh  = vt;
+        } else if (vds < r.vdsLow) {
+            r.vdsLow = vds;
+            r.vtLow  = vt;
+        } else if (vds > r.vdsHigh) {
+            r.vdsHigh = vds;
+            r.vtHigh  = vt;
+        }
+        vtMoments_.add(vds, vt, vtX0_, vtY0_);
+        r.vtCurves++;
+
+        const float dVds = r.vdsHigh - r.vdsLow;
+        r.diblValid = dVds > 1e-6f;
+        r.dibl = r.diblValid ? -1000.0f * (r.vtHigh - r.vtLow) / dVds : 0.0f;
+
+        float slope, intercept;
+        r.vtSlopeR2 = vtMoments_.fit(r.vtCurves, vtX0_, vtY0_, slope, intercept);
+        r.vtSlope   = 1000.0f * slope;
+    }
+
+    if (ssFound) {
+        if (r.ssCurves == 0) {
+            ssX0_ = vds;
+            ssY0_ = ss;
+            r.ssMin = r.ssMax = ss;
+        }
+        r.ssMin = std::min(r.ssMin, ss);
+        r.ssMax = std::max(r.ssMax, ss);
+        ssMoments_.add(vds, ss, ssX0_, ssY0_);
+        r.ssCurves++;
+
+        float intercept;
+        ssMoments_.fit(r.ssCurves, ssX0_, ssY0_, r.ssSlope, intercept);
+    }
+}
+
+// ============================================================================
+// Golden-Curve Comparison
+// ============================================================================
+
+void GoldenComparator::begin(
+    ConstFloatSpan refVgs,
+    ConstFloatSpan refIds,
+    const GoldenTolerance& tolerance,
+    float vgsStart,
+    float vgsEnd
+) {
+    *this = GoldenComparator();
+    const size_t n = std::min(refVgs.size(), refIds.size());
+    refVgs_    = ConstFloatSpan(refVgs.data(), n);
+    refIds_    = ConstFloatSpan(refIds.data(), n);
+    tolerance_ = tolerance;
+
+    const float lo = std::min(vgsStart, vgsEnd);
+    const float hi = std::max(vgsStart, vgsEnd);
+    for (size_t j = 0; j < n; j++) {
+        if (refVgs[j] >= lo && refVgs[j] <= hi) expected_++;
+    }
+}
+
+void GoldenComparator::accumulate(float ref, float meas) {
+    const double r = static_cast<double>(ref) - meas;
+    n_++;
+    sumR_  += r;
+    sumR2_ += r * r;
+    sumChi2_ += r * r / std::max(static_cast<double>(meas) * meas, 1e-15);
+
+    const double d = ref - refMean_;
+    refMean_ += d / n_;
+    refM2_   += d * (ref - refMean_);
+}
+
+bool GoldenComparator::push(float vgs, float ids) {
+    if (failed_) return false;
+
+    // Every reference point up to this VGS is now bracketed (or passed)
+    while (next_ < refVgs_.size() && refVgs_[next_] <= vgs) {
+        const float x = refVgs_[next_];
+        if (x == vgs) {
+            accumulate(refIds_[next_], ids);
+        } else if (hasPrev_ && x >= prevVgs_ && vgs > prevVgs_) {
+            const float t = (x - prevVgs_) / (vgs - prevVgs_);
+            accumulate(refIds_[next_], prevIds_ + t * (ids - prevIds_));
+        }
+        // Reference points before the first sample are outside the overlap
+        next_++;
+    }
+    prevVgs_ = vgs;
+    prevIds_ = ids;
+    hasPrev_ = true;
+
+    // Lower bounds on the final RMSE² and χ² over `expected_` points
+    const double total = static_cast<double>(std::max(expected_, n_));
+    if (total > 0) {
+        const double rmse = tolerance_.maxRmse;
+        if (rmse > 0 && sumR2_ > rmse * rmse * total)              failed_ = true;
+        if (tolerance_.maxChi2 > 0 && sumChi2_ > tolerance_.maxChi2 * total) failed_ = true;
+    }
+    return !failed_;
+}
+
+GoldenComparator::Stats GoldenComparator::stats() const {
+    Stats s;
+    s.n = n_;
+    if (n_ == 0) return s;
+    s.rmse = static_cast<float>(sqrt(sumR2_ / n_));
+    s.chi2 = static_cast<float>(sumChi2_ / n_);
+    s.bias = static_cast<float>(sumR_ / n_);
+    s.r2   = refM2_ > 1e-30 ? static_cast<float>(1.0 - sumR2_ / refM2_) : 0.0f;
+    return s;
+}
+
+GoldenVerdict GoldenComparator::verdict() const {
+    if (failed_) return GoldenVerdict::Fail;
+    if (n_ < 2) return GoldenVerdict::Incomplete;
+
+    const Stats s = stats();
+    if (tolerance_.maxRmse > 0 && s.rmse > tolerance_.maxRmse) return GoldenVerdict::Fail;
+    if (tolerance_.minR2   > 0 && s.r2   < tolerance_.minR2)   return GoldenVerdict::Fail;
+    if (tolerance_.maxChi2 > 0 && s.chi2 > tolerance_.maxChi2) return GoldenVerdict::Fail;
+    return GoldenVerdict::Pass;
+}
+
 } // namespace math_engine
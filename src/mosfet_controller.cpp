@@ -6,12 +6,93 @@
 #include "version.h"
 #include <sys/time.h>
 #include <time.h>
+#include <algorithm>
 #include <cstdio>
 
 
 // Buffer size for batch writing (2KB chunks)
 static const size_t WRITE_BUFFER_SIZE = 2048;
 
+// Wall-clock cap for the compact-model fit of one curve (µs)
+static const uint32_t MODEL_FIT_BUDGET_US = 50000;
+static const uint32_t BOOTSTRAP_BUDGET_US = 500000;
+
+// Stack of the Core 0 analysis task (bytes). CurveAnalyzer, extractVt(), the
+// compact-model fit (lm::solve<5> keeps its matrices on the stack) and the
+// bootstrap all nest on it; the unused margin is logged after each sweep.
+static const uint32_t ANALYSIS_STACK_BYTES = 8192;
+
+// micros() with the clock signature math_engine::ModelFitConfig expects
+static uint32_t clockMicros() { return micros(); }
+
+// Outcome of the compact-model fit for the "# VDS=" line
+static const char* modelFitLabel(const math_engine::ModelFit& fit)
+{
+    if (!fit.valid) return "fail";
+    if (fit.budgetHit) return "budget";
+    return fit.converged ? "ok" : "iter";
+}
+
+// Confidence label for one Vt estimate in the "# VDS=" line:
+// "none", "ok", or warnings joined with '+' (e.g. "edge+outlier")
+static const char* vtFlagLabel(const math_engine::VtEstimate& e, char* buf, size_t size)
+{
+    if (!e.found()) return "none";
+    if (e.confident()) return "ok";
+
+    static const struct { uint8_t bit; const char* name; } NAMES[] = {
+        { math_engine::VT_AT_EDGE,      "edge"    },
+        { math_engine::VT_EXTRAPOLATED, "extrap"  },
+        { math_engine::VT_POOR_FIT,     "fit"     },
+        { math_engine::VT_OUTLIER,      "outlier" },
+    };
+    size_t len = 0;
+    buf[0] = '\0';
+    for (const auto& n : NAMES) {
+        if (!(e.flags & n.bit) || len >= size) continue;
+        len += snprintf(buf + len, size - len, "%s%s", len ? "+" : "", n.name);
+    }
+    return buf;
+}
+
+// VGS where a region starts for the "# VDS=" line, or "none" if [start, end) is empty
+static const char* regionStartLabel(const std::vector<float>& vgs, size_t start, size_t end,
+                                    char* buf, size_t size)
+{
+    if (start >= end || start >= vgs.size()) return "none";
+    snprintf(buf, size, "%.3fV", vgs[start]);
+    return buf;
+}
+
+// "lo..hi" of a bootstrap interval for the "# VDS=" line, or "none" if too few resamples
+static const char* intervalLabel(const math_engine::ConfidenceInterval& ci, const char* format,
+                                 char* buf, size_t size)
+{
+    if (!ci.valid) return "none";
+    snprintf(buf, size, format, ci.lo, ci.hi);
+    return buf;
+}
+
+// Estimator label for the "# SS Method:" header; matches the API's ss_method values
+static const char* ssMethodLabel(math_engine::SSMethod m)
+{
+    switch (m) {
+        case math_engine::SSMethod::TheilSen: return "theil_sen";
+        case math_engine::SSMethod::Ransac:   return "ransac";
+        default:                              return "window";
+    }
+}
+
+// Verdict label for the "# Golden VDS=" and "# Bin:" lines
+static const char* goldenVerdictLabel(math_engine::GoldenVerdict v)
+{
+    switch (v) {
+        case math_engine::GoldenVerdict::Pass: return "PASS";
+        case math_engine::GoldenVerdict::Fail: return "FAIL";
+        default:                               return "INCOMPLETE";
+    }
+}
+
 MOSFETController::MOSFETController()
 {
 }
@@ -34,6 +115,23 @@ void MOSFETController::begin()
     // Initialize hardware abstraction layer (DACs and ADC)
     hal::init();
     
+    // Curve analysis runs on Core 0 so the measurement task (Core 1) can
+    // start the next curve straight away. Without it, curves are analysed
+    // inline after acquisition.
+    BaseType_t res = xTaskCreatePinnedToCore(
+        analysisTaskWrapper,
+        "MOS_Analysis",
+        ANALYSIS_STACK_BYTES,
+        this,
+        1,
+        &analysisTaskHandle_,
+        0  // Pin to Core 0
+    );
+    if (res != pdPASS) {
+        analysisTaskHandle_ = nullptr;
+        LOG_WARN("Failed to create analysis task - curves will be analysed inline");
+    }
+    
     LOG_INFO("MOSFET Controller initialized");
 }
 
@@ -122,6 +220,7 @@ bool MOSFETController::startMeasurementAsync(const SweepConfig& config)
     cancelled_ = false; // Reset cancel flag
     hasError_ = false;  // Reset error state
     errorMessage_ = "";
+    binResult_ = BIN_NONE;
     currentVds_ = config.vds_start;
     progressPercent_ = 0;
     
@@ -222,7 +321,6 @@ void MOSFETController::reset()
     if (measuring_) {
         cancelMeasurement();
     }
-    results_buffer_.clear();
     currentVds_ = 0;
     progressPercent_ = 0;
 }
@@ -235,6 +333,15 @@ MOSFETController::ProgressStatus MOSFETController::getProgress() const
     status.progress_percent = progressPercent_;
     status.has_error = hasError_;
     status.error_message = errorMessage_;
+    status.bin = binResult_;
+    status.devices_tested = devicesTested_;
+    status.devices_passed = devicesPassed_;
+    
+    // The family snapshot is a struct; copy it whole under the mutex
+    if (!mutex_ || xSemaphoreTake(mutex_, pdMS_TO_TICKS(10)) == pdTRUE) {
+        status.family = familySnapshot_;
+        if (mutex_) xSemaphoreGive(mutex_);
+    }
     
     if (!measuring_) {
         if (hasError_) {
@@ -253,10 +360,14 @@ MOSFETController::ProgressStatus MOSFETController::getProgress() const
     return status;
 }
 
-float MOSFETController::readAnalogVoltage()
+float MOSFETController::readAnalogVoltage(uint16_t& samples, float& fullScale)
 {
     // Delegate to HAL for averaged reading
-    return hal::readShuntVoltage();
+    hal::ICurrentSensor& adc = hal::HardwareHAL::instance().getShuntADC();
+    const float vsh = adc.readVoltage();
+    samples   = adc.getLastSampleCount();
+    fullScale = adc.getLastFullScale();
+    return vsh;
 }
 
 void MOSFETController::performSweep()
@@ -285,6 +396,18 @@ void MOSFETController::performSweep()
     int total_points = outer_steps * inner_steps;
     int current_point = 0;
     
+    // Golden reference for pass/fail binning (transfer sweeps only)
+    const bool binning = !sweepVDS && config_.part_number.length() > 0;
+    const uint32_t sweepStartMs = millis();
+    hal::HardwareHAL::resetDacWriteStats();
+    hal::HardwareHAL::resetHybridStats();
+    golden_.clear();
+    if (binning && !GoldenStore::load(config_.part_number, golden_)) {
+        hasError_ = true;
+        errorMessage_ = "No golden reference for part " + config_.part_number;
+        return;
+    }
+    
     // Open file and write header FIRST
     String path = String(FileManager::MEASUREMENTS_DIR) + "/" + currentFilename_;
     LOG_DEBUG("Opening file for streaming: %s", path.c_str());
@@ -329,9 +452,17 @@ void MOSFETController::performSweep()
     len = snprintf(lineBuf, sizeof(lineBuf), "# Settling Time: %d ms\n", config_.settling_ms);
     currentFile_.write((uint8_t*)lineBuf, len);
     
-    len = snprintf(lineBuf, sizeof(lineBuf), "# Oversampling: %s (%dx)\n", 
-        config_.oversampling > 1 ? "enabled" : "disabled", config_.oversampling);
+    len = snprintf(lineBuf, sizeof(lineBuf), "# Oversampling: %s (%dx, %s)\n", 
+        config_.oversampling > 1 ? "enabled" : "disabled", config_.oversampling,
+        hal::oversamplingMethodName(config_.oversampling_method));
     currentFile_.write((uint8_t*)lineBuf, len);
+    
+    if (config_.adaptive.enabled) {
+        len = snprintf(lineBuf, sizeof(lineBuf), "# Adaptive Oversampling: %u-%u samples, SE<=%.3f%% or %.2f uV\n",
+            (unsigned)config_.adaptive.minSamples, (unsigned)config_.oversampling,
+            config_.adaptive.relPrecision * 100.0f, config_.adaptive.absPrecision * 1e6f);
+        currentFile_.write((uint8_t*)lineBuf, len);
+    }
 
     // ADC gain metadata
     const char* gainLabel;
@@ -344,9 +475,22 @@ void MOSFETController::performSweep()
         case 16: gainLabel = "GAIN_SIXTEEN (±0.256 V)";   break;
         default: gainLabel = "GAIN_SIXTEEN (±0.256 V)";   break;
     }
-    len = snprintf(lineBuf, sizeof(lineBuf), "# ADC Gain: %s\n", gainLabel);
+    const bool hybrid = config_.use_external_hw && config_.hybrid_adc;
+    if (hybrid) {
+        len = snprintf(lineBuf, sizeof(lineBuf), "# ADC Gain: HYBRID (GPIO34 coarse read, range per row in fsr)\n");
+    } else {
+        len = snprintf(lineBuf, sizeof(lineBuf), config_.adc_autorange ? "# ADC Gain: AUTO (first point %s, range per row in fsr)\n"
+                                                                       : "# ADC Gain: %s\n", gainLabel);
+    }
     currentFile_.write((uint8_t*)lineBuf, len);
 
+    if (hybrid) {
+        // Rows the ADS1115 skipped carry the coarse reading and fsr 3.300
+        len = snprintf(lineBuf, sizeof(lineBuf), "# Hybrid ADC: fine skipped when GPIO34 clips or below %.1f mV, widest range at >= %.2f V\n",
+            config_.hybrid_floor_v * 1e3f, hal::HYBRID_WIDE_RANGE_V);
+        currentFile_.write((uint8_t*)lineBuf, len);
+    }
+
     // Hardware mode metadata — records which peripherals collected the data
     if (config_.use_external_hw) {
         len = snprintf(lineBuf, sizeof(lineBuf),
@@ -360,21 +504,68 @@ void MOSFETController::performSweep()
     len = snprintf(lineBuf, sizeof(lineBuf), "# Firmware: %s\n", SOFTWARE_VERSION);
     currentFile_.write((uint8_t*)lineBuf, len);
     
+    if (!sweepVDS) {
+        len = snprintf(lineBuf, sizeof(lineBuf), "# Vt Constant Current: %.3e A\n", config_.vt_current);
+        currentFile_.write((uint8_t*)lineBuf, len);
+        
+        len = snprintf(lineBuf, sizeof(lineBuf), "# SS Method: %s\n", ssMethodLabel(config_.ss_method));
+        currentFile_.write((uint8_t*)lineBuf, len);
+    }
+    
+    if (binning) {
+        const math_engine::GoldenTolerance& tol = golden_.tolerance;
+        len = snprintf(lineBuf, sizeof(lineBuf), "# Golden: %s (%u curves, RMSE<=%.3e A, R2>=%.5f, Chi2<=%.3e)\n",
+            golden_.part.c_str(), (unsigned)golden_.curves.size(), tol.maxRmse, tol.minR2, tol.maxChi2);
+        currentFile_.write((uint8_t*)lineBuf, len);
+    }
+    
     // Column Headers
-    len = snprintf(lineBuf, sizeof(lineBuf), "#\ntimestamp,vd,vg,vsh,ids\n");
+    len = snprintf(lineBuf, sizeof(lineBuf), "#\ntimestamp,vd,vg,vsh,ids,samples,fsr\n");
     currentFile_.write((uint8_t*)lineBuf, len);
     currentFile_.flush();
     
-    LOG_INFO("Starting %s sweep - Oversampling: %s (%dx), Settling: %dms", 
+    LOG_INFO("Starting %s sweep - Oversampling: %s (%s%dx, %s), Settling: %dms", 
         sweepVDS ? "VDS" : "VGS",
         config_.oversampling > 1 ? "ON" : "OFF", 
+        config_.adaptive.enabled ? "adaptive, up to " : "",
         config_.oversampling, 
+        hal::oversamplingMethodName(config_.oversampling_method),
         config_.settling_ms);
     
     int rowCount = 0;
+    uint32_t totalSamples = 0;  // ADC samples over all rows (varies per point when adaptive)
+    uint16_t rangeChanges = 0;  // Rows read at another ADC range than the row before
+    float    lastFsr      = 0.0f;
+    float    minFsr       = 0.0f;
+    float    maxFsr       = 0.0f;
+    
+    // Curve buffers rotate between acquisition and analysis. Capacity for a
+    // full curve is reserved once, so clearing between curves keeps the
+    // storage and the inner loop never reallocates. The analysis task is
+    // idle here (the previous sweep drained it), so resizing is safe.
+    if (!sweepVDS) {
+        for (uint8_t i = 0; i < CURVE_SLOTS; i++) {
+            curveSlots_[i].reserve(inner_steps);
+            slotBusy_[i] = false;
+        }
+        curvesInFlight_ = 0;
+    }
+    
+    // Scratch memory for per-curve analysis, sized for the longest curve
+    // and reused for every curve of the sweep — no heap traffic between curves.
+    // SWEEP_VDS analyses on this task; the analysis task never runs then.
+    // Bootstrap resamples reuse the same arena once the curve is analysed.
+    size_t scratch = math_engine::scratchBytes(inner_steps);
+    if (!sweepVDS && config_.bootstrap_iterations > 0) {
+        scratch = std::max(scratch, math_engine::bootstrapScratchBytes(inner_steps, config_.bootstrap_iterations));
+    }
+    if (!analysisArena_.reserve(scratch)) {
+        LOG_WARN("Analysis scratch (%u bytes) unavailable - curve parameters will be zero",
+                 (unsigned)scratch);
+    }
     
-    // Temporary buffer for one curve (cleared after each outer loop iteration)
-    CurveData currentCurve;
+    // Lets the shunt ADC keep its converter running through each curve
+    hal::ICurrentSensor& shuntAdc = hal::HardwareHAL::instance().getShuntADC();
     
     // Mode: Id vs Vds sweep (outer = VGS fixed, inner = VDS swept)
     if (sweepVDS) {
@@ -382,18 +573,32 @@ void MOSFETController::performSweep()
             float vgs = vgs_start + i_vgs * vgs_step;
             currentVds_ = vgs; // Use for progress display (outer loop var)
             
+            // Ron / gds / Vdsat / lambda accumulate point by point
+            math_engine::ScratchArena::Scope scope(analysisArena_);
+            math_engine::OutputCurveAnalyzer analyzer;
+            analyzer.begin(inner_steps, analysisArena_);
+            shuntAdc.beginCurve(settling);
+            
             for (int i_vds = 0; i_vds < inner_steps && measuring_ && !cancelled_; i_vds++) {
                 float vds = vds_start + i_vds * vds_step;
                 hal::setVDS(vds);
                 hal::setVGS(vgs);
                 vTaskDelay(pdMS_TO_TICKS(settling));
                 
-                float vsh = readAnalogVoltage();
+                uint16_t samples;
+                float fsr;
+                float vsh = readAnalogVoltage(samples, fsr);
                 float ids = vsh / rshunt;
+                analyzer.push(vds, ids);
+                totalSamples += samples;
+                if (rowCount > 0 && fsr != lastFsr) rangeChanges++;
+                if (rowCount == 0 || fsr < minFsr) minFsr = fsr;
+                if (rowCount == 0 || fsr > maxFsr) maxFsr = fsr;
+                lastFsr = fsr;
                 
                 // Safe formatted write
-                currentFile_.printf("%lu,%.3f,%.3f,%.6f,%.6e\n", 
-                           (unsigned long)millis(), vds, vgs, vsh, ids);
+                currentFile_.printf("%lu,%.3f,%.3f,%.6f,%.6e,%u,%.3f\n", 
+                           (unsigned long)millis(), vds, vgs, vsh, ids, (unsigned)samples, fsr);
                 
                 rowCount++;
                 current_point++;
@@ -405,18 +610,32 @@ void MOSFETController::performSweep()
                 }
             }
             
-            // In VDS mode, parameters like Vt/SS/Gm are not strictly defined per VDS curve
+            shuntAdc.endCurve();
+            
+            // Output-curve summary; fields that could not be found are 0
+            math_engine::OutputCurveAnalyzer::Result out = analyzer.finish();
+            currentFile_.printf("# VGS=%.3fV: Ron=%.3e Ohm, gds=%.3e S, Vdsat=%.3fV, Lambda=%.4f 1/V\n",
+                       vgs, out.ron, out.gds, out.vdsat, out.lambda);
             currentFile_.flush();
-            LOG_INFO("VGS=%.3fV streamed. Rows: %d", vgs, rowCount);
+            LOG_INFO("VGS=%.3fV streamed. Rows: %d, Ron=%.3e, gds=%.3e, Vdsat=%.3f, Lambda=%.4f",
+                     vgs, rowCount, out.ron, out.gds, out.vdsat, out.lambda);
         }
     } else {
         // Mode: Id vs Vgs sweep (outer = VDS fixed, inner = VGS swept) — default
-        for (int i_vds = 0; i_vds < outer_steps && measuring_ && !cancelled_; i_vds++) {
+        bool  binFailed      = false;  // Device out of tolerance: no point measuring on
+        float failVds        = 0.0f;
+        int   curvesCompared = 0;
+        
+        family_.begin();
+        publishFamily();
+        
+        for (int i_vds = 0; i_vds < outer_steps && measuring_ && !cancelled_ && !binFailed; i_vds++) {
             float vds = vds_start + i_vds * vds_step;
             currentVds_ = vds;
             
             // Reset curve buffer for this VDS value
-            currentCurve = CurveData();
+            CurveData& currentCurve = *acquireCurveSlot();
+            currentCurve.clear();
             currentCurve.vds = vds;
             currentCurve.rshunt = rshunt; // Pass Rshunt for SS context if needed
             
@@ -426,6 +645,11 @@ void MOSFETController::performSweep()
             hal::setVDS(vds);
             vTaskDelay(pdMS_TO_TICKS(settling * 3));
             
+            // Reference curve for this VDS; compared point by point as it is acquired
+            const GoldenCurve* ref = binning ? golden_.find(vds) : nullptr;
+            if (ref) comparator_.begin(ref->vgs, ref->ids, golden_.tolerance, vgs_start, vgs_end);
+            
+            shuntAdc.beginCurve(settling);
             for (int i_vgs = 0; i_vgs < inner_steps && measuring_ && !cancelled_; i_vgs++) {
                 float vgs = vgs_start + i_vgs * vgs_step;
                 uint32_t t_dac  = millis();
@@ -433,9 +657,16 @@ void MOSFETController::performSweep()
                 uint32_t t_set  = millis();
                 if (settling > 0) vTaskDelay(pdMS_TO_TICKS(settling));
                 uint32_t t_adc  = millis();
-                float vsh = readAnalogVoltage();
+                uint16_t samples;
+                float fsr;
+                float vsh = readAnalogVoltage(samples, fsr);
                 uint32_t t_done = millis();
                 float ids = vsh / rshunt;
+                totalSamples += samples;
+                if (rowCount > 0 && fsr != lastFsr) rangeChanges++;
+                if (rowCount == 0 || fsr < minFsr) minFsr = fsr;
+                if (rowCount == 0 || fsr > maxFsr) maxFsr = fsr;
+                lastFsr = fsr;
                 
                 // Buffer data for parameter calculation
                 currentCurve.vgs.push_back(vgs);
@@ -444,8 +675,8 @@ void MOSFETController::performSweep()
                 currentCurve.timestamps.push_back(millis());
                 
                 // Safe write
-                currentFile_.printf("%lu,%.3f,%.3f,%.6f,%.6e\n", 
-                           (unsigned long)millis(), vds, vgs, vsh, ids);
+                currentFile_.printf("%lu,%.3f,%.3f,%.6f,%.6e,%u,%.3f\n", 
+                           (unsigned long)millis(), vds, vgs, vsh, ids, (unsigned)samples, fsr);
                 
                 rowCount++;
                 current_point++;
@@ -465,18 +696,59 @@ void MOSFETController::performSweep()
                     currentFile_.flush();
                     vTaskDelay(1);
                 }
+                
+                // Stop as soon as the device cannot pass, whatever comes next
+                if (ref && !comparator_.push(vgs, ids)) break;
             }
+            shuntAdc.endCurve();
             
-            // Calculate parameters for this curve
-            calculateCurveParams(currentCurve);
+            if (ref) {
+                math_engine::GoldenComparator::Stats st = comparator_.stats();
+                math_engine::GoldenVerdict verdict = comparator_.verdict();
+                currentFile_.printf("# Golden VDS=%.3fV: N=%u RMSE=%.3e A R2=%.5f Chi2=%.3e Bias=%.3e A Result=%s\n",
+                           vds, (unsigned)st.n, st.rmse, st.r2, st.chi2, st.bias, goldenVerdictLabel(verdict));
+                if (verdict != math_engine::GoldenVerdict::Incomplete) curvesCompared++;
+                if (verdict == math_engine::GoldenVerdict::Fail) {
+                    binFailed = true;
+                    failVds = vds;
+                }
+            }
             
-            // Write curve metadata as comment using printf for safety
-            currentFile_.printf("# VDS=%.3fV: Vt=%.3fV, SS=%.2f mV/dec, MaxGm=%.2e S, SS_Tangent_VGS:%.3f,%.3f SS_Tangent_LogId:%.3f,%.3f\n", 
-                       vds, currentCurve.vt, currentCurve.ss, currentCurve.max_gm,
-                       currentCurve.ss_x1, currentCurve.ss_x2, currentCurve.ss_y1, currentCurve.ss_y2);
+            // Hand the curve to the analysis task and move straight on to the
+            // next VDS. Summary lines of curves analysed meanwhile are written
+            // here, between data blocks; the dashboard matches them by VDS.
+            submitCurve(&currentCurve);
+            writeFinishedCurves();
             
             currentFile_.flush();
-            LOG_INFO("VDS=%.3fV: Vt=%.3f, SS=%.1f mV/dec, MaxGm=%.2e", vds, currentCurve.vt, currentCurve.ss, currentCurve.max_gm);
+        }
+        
+        // Wait for the analysis task to finish the last curves
+        while (curvesInFlight_ > 0) {
+            writeFinishedCurves();
+            if (curvesInFlight_ > 0) vTaskDelay(1);
+        }
+        
+        if (!cancelled_ && family_.result().curves > 0) writeFamilyFooter();
+        
+        if (binning && !cancelled_) {
+            BinResult bin = binFailed ? BIN_FAIL : (curvesCompared > 0 ? BIN_PASS : BIN_INCOMPLETE);
+            const char* label = bin == BIN_PASS ? "PASS" : (bin == BIN_FAIL ? "FAIL" : "INCOMPLETE");
+            float seconds = (millis() - sweepStartMs) / 1000.0f;
+            
+            if (binFailed) {
+                currentFile_.printf("# Bin: %s (part %s, failed at VDS=%.3fV, %d curves compared, %.1f s)\n",
+                           label, golden_.part.c_str(), failVds, curvesCompared, seconds);
+            } else {
+                currentFile_.printf("# Bin: %s (part %s, %d curves compared, %.1f s)\n",
+                           label, golden_.part.c_str(), curvesCompared, seconds);
+            }
+            
+            binResult_ = bin;
+            devicesTested_++;
+            if (bin == BIN_PASS) devicesPassed_++;
+            LOG_INFO("Bin %s for part %s after %.1f s (%u/%u passed since boot)", label,
+                     golden_.part.c_str(), seconds, (unsigned)devicesPassed_, (unsigned)devicesTested_);
         }
     }
     
@@ -494,173 +766,278 @@ void MOSFETController::performSweep()
                  currentFile_ ? (unsigned)currentFile_.size() : 0);
     }
     
+    if (rowCount > 0) {
+        LOG_INFO("ADC samples: %lu over %d points (%.1f per point, cap %u)",
+                 (unsigned long)totalSamples, rowCount, (float)totalSamples / rowCount,
+                 (unsigned)config_.oversampling);
+        LOG_INFO("ADC range: FSR %.3f-%.3f V, %u changes between points",
+                 minFsr, maxFsr, (unsigned)rangeChanges);
+        const hal::HardwareHAL::HybridStats hybrid = hal::HardwareHAL::getHybridStats();
+        if (hybrid.fine + hybrid.offScale + hybrid.belowFloor > 0) {
+            LOG_INFO("Hybrid ADC: %u fine readings, %u clipped and %u below floor (ADS1115 skipped)",
+                     (unsigned)hybrid.fine, (unsigned)hybrid.offScale, (unsigned)hybrid.belowFloor);
+        }
+    }
+    
+    const hal::HardwareHAL::DacWriteStats dac = hal::HardwareHAL::getDacWriteStats();
+    LOG_INFO("DAC writes: %u sent, %u skipped (code unchanged)",
+             (unsigned)dac.written, (unsigned)dac.elided);
+    if (analysisTaskHandle_) {
+        LOG_INFO("Analysis task stack: %u of %u bytes never used",
+                 (unsigned)uxTaskGetStackHighWaterMark(analysisTaskHandle_), (unsigned)ANALYSIS_STACK_BYTES);
+    }
+    
     // Shutdown DACs for safety
     hal::shutdown();
 }
 
-void MOSFETController::calculateCurveParams(CurveData& curve) {
+void MOSFETController::CurveData::reserve(size_t points) {
+    vgs.reserve(points);
+    ids.reserve(points);
+    gm.reserve(points);
+    vsh.reserve(points);
+    timestamps.reserve(points);
+}
+
+void MOSFETController::CurveData::clear() {
+    vds = vt = ss = max_gm = rshunt = 0.0f;
+    vgs.clear();
+    ids.clear();
+    gm.clear();
+    vsh.clear();
+    timestamps.clear();
+    ss_x1 = ss_y1 = ss_x2 = ss_y2 = 0.0f;
+    vt_methods = math_engine::VtResult();
+    regions = math_engine::CurveRegions();
+    model = math_engine::ModelFit();
+    bootstrap = math_engine::BootstrapResult();
+}
+
+void MOSFETController::calculateCurveParams(CurveData& curve, math_engine::CurveAnalyzer& analyzer) {
     if(curve.ids.empty() || curve.vgs.empty()) return;
     
-    // 1. Calculate Gm using MathEngine (smooth derivative)
-    math_engine::GmConfig gmConfig;
-    gmConfig.smoothingWindow = 5;
-    gmConfig.useSavitzkyGolay = true;
-    
-    curve.gm = math_engine::calculateGm(curve.ids, curve.vgs, gmConfig);
-    
-    // 2. Calculate Vt using MathEngine (Peak Gm + Extrapolation)
-    curve.vt = math_engine::calculateVt(curve.gm, curve.vgs, curve.ids);
-    
-    // 3. Find Max Gm
-    auto max_gm_it = std::max_element(curve.gm.begin(), curve.gm.end());
-    curve.max_gm = (max_gm_it != curve.gm.end()) ? *max_gm_it : 0.0f;
-    
-    // 4. Calculate SS and Tangent Line using MathEngine
-    math_engine::SSResult ssResult = math_engine::calculateSS(curve.ids, curve.vgs);
-    
-    if (ssResult.valid) {
-        curve.ss = ssResult.ss_mVdec;
-        curve.ss_x1 = ssResult.x1;
-        curve.ss_y1 = ssResult.y1;
-        curve.ss_x2 = ssResult.x2;
-        curve.ss_y2 = ssResult.y2;
+    // Gm and the SS window scores were accumulated point by point; finish()
+    // only resolves what depends on the whole curve (Gm scale, regions, Vt).
+    math_engine::CurveAnalyzer::Result result = analyzer.finish();
+    
+    // gm capacity was reserved with the curve, so assign() does not allocate
+    math_engine::ConstFloatSpan gm = analyzer.gm();
+    curve.gm.assign(gm.begin(), gm.end());
+    
+    curve.vt = result.vt;
+    curve.max_gm = result.maxGm;
+    curve.vt_methods = result.vtMethods;
+    curve.regions = result.regions;
+    
+    if (result.ss.valid) {
+        curve.ss = result.ss.ss_mVdec;
+        curve.ss_x1 = result.ss.x1;
+        curve.ss_y1 = result.ss.y1;
+        curve.ss_x2 = result.ss.x2;
+        curve.ss_y2 = result.ss.y2;
     } else {
         curve.ss = 0.0f;
     }
 }
 
-void MOSFETController::writeEnhancedCSV(const std::vector<CurveData>& results) {
-    if(results.empty()) {
-        LOG_ERROR("writeEnhancedCSV: No data to write!");
-        return;
-    }
-    
-    // Debug FS info
-    size_t totalBytes = FFat.totalBytes();
-    size_t freeBytes = FFat.freeBytes();
-    LOG_INFO("FFat Total: %u bytes, Free: %u bytes", (unsigned)totalBytes, (unsigned)freeBytes);
-    
-    if (totalBytes == 0) {
-        LOG_ERROR("FFat partition not available or not formatted!");
-        hasError_ = true;
-        errorMessage_ = "FFat partition not available";
-        return;
-    }
-    
-    if (freeBytes < 10000) {
-        LOG_ERROR("Not enough free space on FFat partition!");
-        hasError_ = true;
-        errorMessage_ = "Storage full - delete old files";
-        return;
+void MOSFETController::analysisTaskWrapper(void* param)
+{
+    MOSFETController* controller = static_cast<MOSFETController*>(param);
+    if (controller) {
+        controller->analysisLoop();
     }
+    vTaskDelete(nullptr);
+}
 
-    // Open file using the stored filename
-    String path = String(FileManager::MEASUREMENTS_DIR) + "/" + currentFilename_;
-    LOG_INFO("Opening file for write: %s", path.c_str());
-    
-    // Use local file object to avoid any member-variable state issues
-    File file = FFat.open(path.c_str(), FILE_WRITE);
-    if(!file) {
-        LOG_ERROR("Failed to open file destination: %s", path.c_str());
-        LOG_ERROR("FFat.open returned false - check partition table");
-        return;
+void MOSFETController::analysisLoop()
+{
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        uint8_t slot;
+        while (pendingCurves_.pop(slot)) {
+            analyzeCurve(curveSlots_[slot]);
+            if (config_.bootstrap_iterations > 0) {
+                bootstrapCurve(curveSlots_[slot]);
+            }
+            finishedCurves_.push(slot);  // Cannot fail: at most CURVE_SLOTS in flight
+        }
     }
+}
+
+void MOSFETController::analyzeCurve(CurveData& curve)
+{
+    // Gm via Savitzky-Golay derivative (smooth derivative)
+    math_engine::GmConfig gmConfig;
+    gmConfig.smoothingWindow = 5;
+    gmConfig.useSavitzkyGolay = true;
     
-    LOG_INFO("File opened successfully. Starting write...");
-    
-    // Use a buffer for writing - more efficient
-    char lineBuf[256];
-    size_t totalWritten = 0;
-    
-    // Write Header
-    int len = snprintf(lineBuf, sizeof(lineBuf), "# MOSFET Characterization Data\n");
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    time_t now; time(&now);
-    struct tm* timeinfo = localtime(&now);
-    len = snprintf(lineBuf, sizeof(lineBuf), "# Date: %04d-%02d-%02d %02d:%02d:%02d\n",
-        timeinfo->tm_year + 1900, timeinfo->tm_mon + 1, timeinfo->tm_mday,
-        timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    len = snprintf(lineBuf, sizeof(lineBuf), "# Rshunt: %.2f Ohms\n", config_.rshunt);
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    len = snprintf(lineBuf, sizeof(lineBuf), "# VDS Range: %.2f to %.2f V (step %.2f)\n",
-        config_.vds_start, config_.vds_end, config_.vds_step);
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    len = snprintf(lineBuf, sizeof(lineBuf), "# VGS Range: %.2f to %.2f V (step %.3f)\n",
-        config_.vgs_start, config_.vgs_end, config_.vgs_step);
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    len = snprintf(lineBuf, sizeof(lineBuf), "# Settling Time: %d ms\n", config_.settling_ms);
-    totalWritten += file.write((uint8_t*)lineBuf, len);
+    math_engine::VtConfig vtConfig;
+    vtConfig.constantCurrent = config_.vt_current;
     
-    len = snprintf(lineBuf, sizeof(lineBuf), "#\n# Analysis Results (Per VDS Curve):\n");
-    totalWritten += file.write((uint8_t*)lineBuf, len);
+    math_engine::SSConfig ssConfig;
+    ssConfig.method = config_.ss_method;
     
-    // Write summary per curve
-    for(const auto& res : results) {
-        len = snprintf(lineBuf, sizeof(lineBuf), "# VDS=%.2fV Vt=%.3fV SS=%.2f mV/dec MaxGm=%.3e S\n", 
-            res.vds, res.vt, res.ss, res.max_gm);
-        totalWritten += file.write((uint8_t*)lineBuf, len);
+    math_engine::ScratchArena::Scope scope(analysisArena_);
+    math_engine::CurveAnalyzer analyzer;
+    analyzer.begin(curve.ids.size(), analysisArena_, gmConfig, vtConfig, ssConfig);
+    for (size_t i = 0; i < curve.ids.size(); i++) {
+        analyzer.push(curve.vgs[i], curve.ids[i]);
     }
-    
-    len = snprintf(lineBuf, sizeof(lineBuf), "#\n");
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    // Column Headers
-    len = snprintf(lineBuf, sizeof(lineBuf), "timestamp,vds,vgs,vsh,ids,gm\n");
-    totalWritten += file.write((uint8_t*)lineBuf, len);
-    
-    LOG_INFO("Header written: %u bytes", (unsigned)totalWritten);
-    
-    int rowCount = 0;
-    
-    // Write Data - use snprintf for reliable formatting
-    for(const auto& res : results) {
-        for(size_t i=0; i<res.vgs.size(); i++) {
-            len = snprintf(lineBuf, sizeof(lineBuf), "%lu,%.3f,%.3f,%.4f,%.6e,%.6e\n",
-                (unsigned long)res.timestamps[i],
-                res.vds,
-                res.vgs[i],
-                res.vsh[i],
-                res.ids[i],
-                res.gm[i]
-            );
-            
-            size_t written = file.write((uint8_t*)lineBuf, len);
-            if(written != (size_t)len) {
-                LOG_ERROR("Write mismatch at row %d: expected %d, got %u", rowCount, len, (unsigned)written);
-            }
-            totalWritten += written;
-            
-            // Feed watchdog during large writes
-            if(rowCount % 100 == 0) {
-                vTaskDelay(1);
+    calculateCurveParams(curve, analyzer);
+    
+    // EKV fit seeded from the extracted Vt and SS; bounded by iterations and
+    // MODEL_FIT_BUDGET_US so a hard curve cannot hold up the next one
+    math_engine::ModelFitConfig fitConfig;
+    fitConfig.budgetUs = MODEL_FIT_BUDGET_US;
+    fitConfig.clockUs  = clockMicros;
+    curve.model = math_engine::fitCompactModel(curve.vgs, curve.ids, curve.vds,
+                                               curve.vt, curve.ss, fitConfig);
+}
+
+void MOSFETController::bootstrapCurve(CurveData& curve)
+{
+    // Same analysis as analyzeCurve() on every resample. Only idle time is
+    // spent: a queued curve, a cancel or BOOTSTRAP_BUDGET_US ends the run and
+    // the intervals come from the resamples done so far.
+    math_engine::BootstrapConfig bootConfig;
+    bootConfig.iterations    = config_.bootstrap_iterations;
+    bootConfig.budgetUs      = BOOTSTRAP_BUDGET_US;
+    bootConfig.clockUs       = clockMicros;
+    bootConfig.stopRequested = bootstrapShouldStop;
+    bootConfig.context       = this;
+    bootConfig.gm.smoothingWindow  = 5;
+    bootConfig.gm.useSavitzkyGolay = true;
+    bootConfig.vt.constantCurrent  = config_.vt_current;
+    bootConfig.ss.method           = config_.ss_method;
+    
+    curve.bootstrap = math_engine::bootstrapCurve(curve.vgs, curve.ids, analysisArena_, bootConfig);
+}
+
+bool MOSFETController::bootstrapShouldStop(void* controller)
+{
+    MOSFETController* self = static_cast<MOSFETController*>(controller);
+    return !self->pendingCurves_.empty() || self->cancelled_;
+}
+
+MOSFETController::CurveData* MOSFETController::acquireCurveSlot()
+{
+    while (true) {
+        for (uint8_t i = 0; i < CURVE_SLOTS; i++) {
+            if (!slotBusy_[i]) {
+                slotBusy_[i] = true;
+                return &curveSlots_[i];
             }
-            rowCount++;
         }
+        // Every slot is queued or being analysed; only reached when analysis
+        // is slower than acquiring a whole curve.
+        writeFinishedCurves();
+        vTaskDelay(1);
     }
+}
+
+void MOSFETController::submitCurve(CurveData* curve)
+{
+    const uint8_t slot = static_cast<uint8_t>(curve - curveSlots_);
+    curvesInFlight_++;
     
-    LOG_INFO("Data write complete: %d rows, %u bytes", rowCount, (unsigned)totalWritten);
-    
-    // Flush and verify
-    file.flush();
-    
-    size_t finalSize = file.size();
-    LOG_INFO("File size after flush: %u bytes", (unsigned)finalSize);
-    
-    file.close();
+    if (!analysisTaskHandle_) {
+        analyzeCurve(*curve);
+        finishedCurves_.push(slot);
+        return;
+    }
     
-    // Verify by reopening
-    File verify = FFat.open(path.c_str(), FILE_READ);
-    if (verify) {
-        size_t verifySize = verify.size();
-        verify.close();
-        LOG_INFO("Verified file exists: %s (%u bytes)", currentFilename_.c_str(), (unsigned)verifySize);
+    pendingCurves_.push(slot);  // Cannot fail: at most CURVE_SLOTS in flight
+    xTaskNotifyGive(analysisTaskHandle_);
+}
+
+void MOSFETController::writeFinishedCurves()
+{
+    uint8_t slot;
+    while (finishedCurves_.pop(slot)) {
+        const CurveData& curve = curveSlots_[slot];
+        
+        // Write curve metadata as comment using printf for safety
+        currentFile_.printf("# VDS=%.3fV: Vt=%.3fV, SS=%.2f mV/dec, MaxGm=%.2e S, SS_Tangent_VGS:%.3f,%.3f SS_Tangent_LogId:%.3f,%.3f", 
+                   curve.vds, curve.vt, curve.ss, curve.max_gm,
+                   curve.ss_x1, curve.ss_x2, curve.ss_y1, curve.ss_y2);
+        
+        // Every Vt method with its confidence label, same line so the
+        // dashboard's per-VDS lookup stays one line per curve
+        const math_engine::VtResult& vm = curve.vt_methods;
+        char f[4][32];
+        currentFile_.printf(" Vt_MaxGm=%.3fV(%s) Vt_D2=%.3fV(%s) Vt_CC=%.3fV(%s) Vt_Y=%.3fV(%s)",
+                   vm.maxGm.vt,            vtFlagLabel(vm.maxGm, f[0], sizeof(f[0])),
+                   vm.secondDerivative.vt, vtFlagLabel(vm.secondDerivative, f[1], sizeof(f[1])),
+                   vm.constantCurrent.vt,  vtFlagLabel(vm.constantCurrent, f[2], sizeof(f[2])),
+                   vm.yFunction.vt,        vtFlagLabel(vm.yFunction, f[3], sizeof(f[3])));
+        
+        // Where the subthreshold, saturation and linear regions begin
+        const math_engine::CurveRegions& r = curve.regions;
+        const size_t subEnd = r.valid ? r.saturation : 0;
+        const size_t satEnd = r.valid ? r.linear : 0;
+        currentFile_.printf(" Region_Sub=%s Region_Sat=%s Region_Lin=%s",
+                   regionStartLabel(curve.vgs, r.subthreshold, subEnd, f[0], sizeof(f[0])),
+                   regionStartLabel(curve.vgs, r.saturation, satEnd, f[1], sizeof(f[1])),
+                   regionStartLabel(curve.vgs, r.linear, r.size, f[2], sizeof(f[2])));
+        
+        // Bootstrap intervals; the _CI suffix keeps them clear of "Vt=" as well
+        if (config_.bootstrap_iterations > 0) {
+            const math_engine::BootstrapResult& b = curve.bootstrap;
+            currentFile_.printf(" Vt_CI=%s SS_CI=%s MaxGm_CI=%s Boot=%u%s",
+                       intervalLabel(b.vt, "%.3f..%.3fV", f[0], sizeof(f[0])),
+                       intervalLabel(b.ss, "%.2f..%.2f", f[1], sizeof(f[1])),
+                       intervalLabel(b.maxGm, "%.2e..%.2eS", f[2], sizeof(f[2])),
+                       (unsigned)b.iterations, b.interrupted ? "(cut)" : "");
+        }
+        
+        // Compact-model parameters. "Fit_Vt=" still contains "Vt=": it is
+        // read correctly only because the dashboard's /Vt=([\d\.]+)V/ takes
+        // the first match and the measured Vt= comes earlier on the line
+        const math_engine::ModelFit& m = curve.model;
+        currentFile_.printf(" Fit_Vt=%.3fV Fit_n=%.3f Fit_Is=%.3e A Fit_Theta=%.3f 1/V Fit_Rs=%.2f Ohm Fit_RMS=%.3f dec Fit=%s\n",
+                   m.vt, m.n, m.is, m.theta, m.rs, m.rmsDecades, modelFitLabel(m));
+        LOG_INFO("VDS=%.3fV: Vt=%.3f, SS=%.1f mV/dec, MaxGm=%.2e", curve.vds, curve.vt, curve.ss, curve.max_gm);
+        
+        // Family statistics take the constant-current Vt: max-Gm extrapolation
+        // is biased at high VDS, and a Vt pinned to the sweep start says nothing
+        const math_engine::VtEstimate& cc = vm.constantCurrent;
+        family_.add(curve.vds, cc.vt, cc.found() && !(cc.flags & math_engine::VT_AT_EDGE),
+                    curve.ss, curve.ss > 0.0f);
+        publishFamily();
+        
+        slotBusy_[slot] = false;
+        curvesInFlight_--;
+    }
+}
+
+void MOSFETController::publishFamily()
+{
+    if (mutex_ && xSemaphoreTake(mutex_, pdMS_TO_TICKS(10)) != pdTRUE) return;
+    familySnapshot_ = family_.result();
+    if (mutex_) xSemaphoreGive(mutex_);
+}
+
+void MOSFETController::writeFamilyFooter()
+{
+    const math_engine::FamilyAnalyzer::Result& f = family_.result();
+    
+    currentFile_.printf("# Family: %u curves,", (unsigned)f.curves);
+    if (f.diblValid) {
+        currentFile_.printf(" DIBL=%.1f mV/V (Vt_CC %.3fV at VDS=%.3fV -> %.3fV at VDS=%.3fV),",
+                   f.dibl, f.vtLow, f.vdsLow, f.vtHigh, f.vdsHigh);
+        currentFile_.printf(" dVt/dVDS=%.1f mV/V (R2=%.3f, %u curves),",
+                   f.vtSlope, f.vtSlopeR2, (unsigned)f.vtCurves);
     } else {
-        LOG_ERROR("Verification failed - could not reopen file!");
+        currentFile_.printf(" DIBL=none (%u curves with Vt_CC),", (unsigned)f.vtCurves);
     }
+    if (f.ssCurves >= 2) {
+        currentFile_.printf(" dSS/dVDS=%.2f mV/dec/V, SS %.2f-%.2f mV/dec (%u curves)\n",
+                   f.ssSlope, f.ssMin, f.ssMax, (unsigned)f.ssCurves);
+    } else {
+        currentFile_.printf(" dSS/dVDS=none (%u curves with SS)\n", (unsigned)f.ssCurves);
+    }
+    
+    LOG_INFO("Family: DIBL=%.1f mV/V, dVt/dVDS=%.1f mV/V, dSS/dVDS=%.2f mV/dec/V over %u curves",
+             f.dibl, f.vtSlope, f.ssSlope, (unsigned)f.curves);
 }
@@ -135,7 +135,9 @@ document.addEventListener('DOMContentLoaded', () => {
 
         // Get ADC gain setting
         const adcGainEl = document.getElementById('adc-gain');
-        const adcGain = adcGainEl ? parseInt(adcGainEl.value) : 2;  // default: GAIN_TWO
+        const adcAutoRange = adcGainEl ? adcGainEl.value === 'auto' : false;
+        // Auto-range starts at ±0.256 V; a clipped first reading is repeated wider
+        const adcGain = adcAutoRange ? 16 : (adcGainEl ? parseInt(adcGainEl.value) : 2);  // default: GAIN_TWO
 
         const config = {
             vgs_start: vgsStart,
@@ -148,6 +150,7 @@ document.addEventListener('DOMContentLoaded', () => {
             settling_ms: (settlingTime === 0 || settlingTime > 0) ? settlingTime : 0,
             oversampling: oversamplingFactor,
             adc_gain: adcGain,
+            adc_autorange: adcAutoRange,
             use_external_hw: useExternalHW,
             filename: filename || 'mosfet_data.csv',
             sweep_mode: sweepMode,
@@ -459,6 +462,10 @@ document.getElementById('oversampling-toggle')?.addEventListener('change', (e) =
         const sel = document.getElementById('adc-gain');
         const hint = document.getElementById('gain-hint');
         if (!sel || !hint) return;
+        if (sel.value === 'auto') {
+            hint.textContent = 'FSR: ±0.256 V a ±6.144 V por ponto — coluna fsr do CSV';
+            return;
+        }
         const info = GAIN_INFO[parseInt(sel.value)] || GAIN_INFO[2];
         hint.textContent = `FSR: ±${info.fsr} V — Res: ${info.res} µV/LSB`;
     }
@@ -156,6 +156,9 @@ async function handleFileSelection(e) {
 
         updatePlotsMultiCurve();
 
+        // Vt/SS/Gm from the ESP32's cached analysis; the "# VDS=" lines stay until it answers
+        if (currentSweepMode === 'VGS') loadCachedAnalysis(selectedFile);
+
     } catch (error) {
         console.error("Error loading CSV:", error);
         showToast("Erro ao carregar arquivo de dados.", "error");
@@ -171,6 +174,52 @@ async function handleFileSelection(e) {
     }
 }
 
+// /api/analysis answers 202 (analysing) or 503 (busy with another file) until the
+// result is stored; ask again while the same file is selected.
+const ANALYSIS_MAX_POLLS = 60;
+
+async function loadCachedAnalysis(filename, attempt = 0) {
+    if (filename !== currentSelectedFile) return;
+
+    let response;
+    try {
+        response = await fetch(`/api/analysis?file=${encodeURIComponent(filename)}`);
+    } catch (error) {
+        dbg('API', `Analysis request failed: ${error}`);
+        return;
+    }
+
+    if (response.status === 202 || response.status === 503) {
+        if (attempt + 1 >= ANALYSIS_MAX_POLLS) {
+            dbg('API', `Analysis of ${filename} still pending, keeping CSV metadata`);
+            return;
+        }
+        const retryS = parseInt(response.headers.get('Retry-After') || '1', 10) || 1;
+        setTimeout(() => loadCachedAnalysis(filename, attempt + 1), retryS * 1000);
+        return;
+    }
+    if (!response.ok) {
+        dbg('API', `No cached analysis for ${filename} (${response.status}), keeping CSV metadata`);
+        return;
+    }
+
+    const result = await response.json();
+    if (filename !== currentSelectedFile) return;
+
+    const analysisMap = {};
+    result.curves.forEach(c => {
+        const meta = { vt: c.vt, ss: c.ss, max_gm: c.max_gm };
+        if (c.ss > 0) {
+            const [x1, y1, x2, y2] = c.ss_tangent;
+            meta.ssTangent = { x1, x2, y1, y2 };
+        }
+        analysisMap[Math.round(c.vds * 1000) / 1000] = meta;
+    });
+    fileAnalysisMap = analysisMap;
+    dbg('API', `Analysis of ${filename}: ${result.curves.length} curves (cached: ${result.cached})`);
+    updatePlotsMultiCurve();
+}
+
 async function handleDownload() {
     const selectedValue = document.getElementById('file-select').value;
     if (!selectedValue) {
@@ -242,14 +291,16 @@ function parseCSV(csvText) {
     uniqueVDSValues = [];
     const lines = csvText.trim().split('\n');
     let dataStartIndex = -1;
+    let columns = null; // Header names, when the file has a header row
     const analysisMap = {};
 
     // 1. Header & Metadata Scan
     for (let i = 0; i < lines.length; i++) {
         const line = lines[i].trim();
 
-        if (line.includes('timestamp,vds') || line.includes('time,vds')) {
+        if (line.startsWith('timestamp,') || line.startsWith('time,')) {
             dataStartIndex = i + 1;
+            columns = line.split(',').map(c => c.trim());
         }
 
         if (line.startsWith('# Sweep Mode:')) {
@@ -307,6 +358,14 @@ function parseCSV(csvText) {
     const vdsSet = new Set();
     const vgsSet = new Set();
 
+    // Optional columns by header name; headerless files use the legacy order
+    // (timestamp,vds,vgs,vsh,ids,gm,vt,ss). Firmware rows are
+    // timestamp,vd,vg,vsh,ids,samples,fsr and carry none of the three.
+    const columnIndex = (name, legacy) => columns ? columns.indexOf(name) : legacy;
+    const gmCol = columnIndex('gm', 5);
+    const vtCol = columnIndex('vt', 6);
+    const ssCol = columnIndex('ss', 7);
+
     // 2. Data Parsing
     for (let i = dataStartIndex; i < lines.length; i++) {
         const parts = lines[i].split(',');
@@ -316,11 +375,11 @@ function parseCSV(csvText) {
         const vgs = parseFloat(parts[2]);
         const vsh = parseFloat(parts[3]);
         const ids = parseFloat(parts[4]);
-        const gm = parseFloat(parts[5]);
+        const gm = (gmCol >= 0) ? parseFloat(parts[gmCol]) : NaN;
 
         // Legacy format fallback
-        let vt = (parts.length > 6) ? parseFloat(parts[6]) : 0;
-        let ss = (parts.length > 7) ? parseFloat(parts[7]) : 0;
+        let vt = (vtCol >= 0 && parts.length > vtCol) ? parseFloat(parts[vtCol]) : 0;
+        let ss = (ssCol >= 0 && parts.length > ssCol) ? parseFloat(parts[ssCol]) : 0;
 
         if (!isNaN(vds) && !isNaN(vgs)) {
             const vdsRounded = Math.round(vds * 1000) / 1000;